@@ -90,10 +90,34 @@ public:
     return path.c_str();
   }
 
+  /// \brief Path of a file in the directory holding data derived from
+  ///        the assets (e.g. the binary mesh cache).
+  std::string cache_path(const char* name) const {
+    platformstl::path_a path{paths_.cache_path};
+    path.push(name);
+
+    return path.c_str();
+  }
+
+  /// \brief Path of a file in the directory holding linked program
+  ///        binaries (directories.program_cache, by default the programs
+  ///        directory of the cache).
+  std::string program_cache_path(const char* name) const {
+    platformstl::path_a path{paths_.program_cache_path};
+    path.push(name);
+    return path.c_str();
+  }
+
   const char* engine_config_path() const {
     return paths_.engine_ini_file.c_str();
   }
 
+  /// \brief Name of the default mesh import profile (import.mesh_profile),
+  ///        empty when not configured.
+  const char* mesh_import_profile() const noexcept {
+    return mesh_import_profile_.c_str();
+  }
+
   static app_config* instance() noexcept { return _unique_instance; }
 
 private:
@@ -108,8 +132,12 @@ private:
     platformstl::path_a camera_cfg_path;
     platformstl::path_a objects_cfg_path;
     platformstl::path_a engine_ini_file;
+    platformstl::path_a cache_path;
+    platformstl::path_a program_cache_path;
   } paths_;
 
+  std::string mesh_import_profile_;
+
 private:
   app_config() = default;
 
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "xray/xray.hpp"
+#include <cstddef>
+#include <string>
+
+namespace xray {
+namespace base {
+
+/// \addtogroup __GroupXrayBase
+/// @{
+
+/// \brief  Reads the whole contents of a file.
+/// \returns False if the file can not be opened or read.
+bool read_file(const char* path, std::string* contents);
+
+/// \brief  A block of data written by atomic_write_file().
+struct file_write_chunk {
+  const void* data;
+  size_t      bytes;
+};
+
+/// \brief  Writes the chunks, in order, to a temporary file next to path,
+///         then renames it to path. Readers never see a partially written
+///         file; on failure path is left untouched (or removed, if the
+///         rename fails).
+bool atomic_write_file(const char* path, const file_write_chunk* chunks,
+                       const size_t chunks_count);
+
+inline bool atomic_write_file(const char* path, const void* data,
+                              const size_t bytes) {
+  const file_write_chunk chunk{data, bytes};
+  return atomic_write_file(path, &chunk, 1);
+}
+
+/// @}
+
+} // namespace base
+} // namespace xray
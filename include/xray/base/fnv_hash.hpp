@@ -60,6 +60,28 @@ namespace FNV
   }
 
 
+  // 64 bit variant, for identities that must not collide in practice
+  const uint64_t Prime64 = 0x00000100000001B3ULL;
+  const uint64_t Seed64  = 0xCBF29CE484222325ULL;
+
+  /// hash a block of memory, 64 bit result
+  inline uint64_t fnv1a64(const void* data, size_t numBytes, uint64_t hash = Seed64)
+  {
+    assert(data || !numBytes);
+    const unsigned char* ptr = (const unsigned char*)data;
+    while (numBytes--)
+      hash = (*ptr++ ^ hash) * Prime64;
+    return hash;
+  }
+
+
+  /// hash an std::string, 64 bit result
+  inline uint64_t fnv1a64(const std::string& text, uint64_t hash = Seed64)
+  {
+    return fnv1a64(text.data(), text.length(), hash);
+  }
+
+
   /// hash a C-style string
   inline uint32_t fnv1a(const char* text, uint32_t hash = Seed)
   {
@@ -72,6 +94,16 @@ namespace FNV
   }
 
 
+  /// hash a C-style string, same result as fnv1a(const char*) but usable in
+  /// constant expressions (string literals are hashed at compile time)
+  constexpr uint32_t fnv1a_constexpr(const char* text, uint32_t hash = Seed)
+  {
+    while (*text)
+      hash = (static_cast<unsigned char>(*text++) ^ hash) * Prime;
+    return hash;
+  }
+
+
   /// hash an std::string
   inline uint32_t fnv1a(const std::string& text, uint32_t hash = Seed)
   {
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+///
+/// \file    aabb3.hpp
+
+#include "xray/xray.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include <limits>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath_Geometry
+/// @{
+
+/// \brief  Axis aligned bounding box in R3.
+template <typename T>
+struct aabb3 {
+  scalar3<T> min;
+  scalar3<T> max;
+
+  aabb3() noexcept = default;
+
+  constexpr aabb3(const scalar3<T>& pmin, const scalar3<T>& pmax) noexcept
+      : min{pmin}, max{pmax} {}
+
+  scalar3<T> center() const noexcept { return (min + max) * T(0.5); }
+
+  /// \brief  Half of the size on each axis.
+  scalar3<T> extents() const noexcept { return (max - min) * T(0.5); }
+
+  scalar3<T> size() const noexcept { return max - min; }
+
+  /// \brief  True if no point was ever added to the box.
+  bool is_empty() const noexcept {
+    return (min.x > max.x) || (min.y > max.y) || (min.z > max.z);
+  }
+
+  /// \name Standard constants.
+  /// @{
+
+public:
+  struct stdc;
+
+  /// @}
+};
+
+template <typename T>
+struct aabb3<T>::stdc {
+  /// \brief  Empty box, merging any point or box into it yields that
+  ///         point/box.
+  static constexpr aabb3<T> empty{
+      scalar3<T>{std::numeric_limits<T>::max(), std::numeric_limits<T>::max(),
+                 std::numeric_limits<T>::max()},
+      scalar3<T>{std::numeric_limits<T>::lowest(),
+                 std::numeric_limits<T>::lowest(),
+                 std::numeric_limits<T>::lowest()}};
+};
+
+template <typename T>
+constexpr aabb3<T> aabb3<T>::stdc::empty;
+
+/// \brief  Returns the smallest box containing both input boxes.
+template <typename T>
+inline aabb3<T> merge(const aabb3<T>& a, const aabb3<T>& b) noexcept {
+  return {math::min(a.min, b.min), math::max(a.max, b.max)};
+}
+
+/// \brief  Returns the smallest box containing the input box and a point.
+template <typename T>
+inline aabb3<T> merge(const aabb3<T>& a, const scalar3<T>& pt) noexcept {
+  return {math::min(a.min, pt), math::max(a.max, pt)};
+}
+
+template <typename T>
+inline bool contains(const aabb3<T>& box, const scalar3<T>& pt) noexcept {
+  return (pt.x >= box.min.x) && (pt.x <= box.max.x) && (pt.y >= box.min.y) &&
+         (pt.y <= box.max.y) && (pt.z >= box.min.z) && (pt.z <= box.max.z);
+}
+
+using aabb3f = aabb3<float>;
+using aabb3d = aabb3<double>;
+
+/// @}
+
+} // namespace math
+} // namespace xray
@@ -0,0 +1,212 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file bounds_batch.hpp
+/// \brief Computes bounding volumes for arrays of points. Points are read
+/// native_float_lanes at a time with an arbitrary stride, so the position
+/// member of an interleaved vertex stream can be scanned directly. Arrays
+/// with at least batch_bounds_parallel_threshold points are reduced in
+/// parallel.
+
+#include "xray/xray.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_lanes.hpp"
+#include "xray/math/scalar3_lanes_math.hpp"
+#include "xray/math/sphere.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <span.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief Arrays with at least this many points are scanned in parallel.
+constexpr size_t batch_bounds_parallel_threshold = 16384;
+
+/// @}
+
+namespace detail {
+
+inline aabb3f bounds_aabb_serial(const uint8_t* pts, const size_t stride,
+                                 const size_t count) noexcept {
+  using lanes_type     = scalar3_lanes<float, native_float_lanes>;
+  constexpr auto width = native_float_lanes;
+
+  const size_t batched = count - count % width;
+  size_t       i       = 0;
+  aabb3f       box{aabb3f::stdc::empty};
+
+  if (batched != 0) {
+    auto pmin = lanes_type::load(reinterpret_cast<const float3*>(pts), stride);
+    auto pmax = pmin;
+
+    for (i = width; i < batched; i += width) {
+      const auto p = lanes_type::load(
+          reinterpret_cast<const float3*>(pts + i * stride), stride);
+      pmin = min(pmin, p);
+      pmax = max(pmax, p);
+    }
+
+    for (size_t l = 0; l < width; ++l) {
+      box.min = min(box.min, pmin.lane(l));
+      box.max = max(box.max, pmax.lane(l));
+    }
+  }
+
+  for (; i < count; ++i) {
+    box = merge(box, *reinterpret_cast<const float3*>(pts + i * stride));
+  }
+
+  return box;
+}
+
+inline float bounds_max_dist_sq_serial(const uint8_t* pts, const size_t stride,
+                                       const size_t  count,
+                                       const float3& center) noexcept {
+  using lanes_type     = scalar3_lanes<float, native_float_lanes>;
+  constexpr auto width = native_float_lanes;
+
+  const size_t batched = count - count % width;
+  size_t       i       = 0;
+  float        result  = 0.0f;
+
+  if (batched != 0) {
+    const lanes_type c{center};
+    auto             dmax = scalar_lanes<float, width>{0.0f};
+
+    for (; i < batched; i += width) {
+      const auto p = lanes_type::load(
+          reinterpret_cast<const float3*>(pts + i * stride), stride);
+      dmax = max(dmax, squared_distance(p, c));
+    }
+
+    for (size_t l = 0; l < width; ++l) {
+      result = std::max(result, dmax[l]);
+    }
+  }
+
+  for (; i < count; ++i) {
+    result = std::max(
+        result,
+        squared_distance(*reinterpret_cast<const float3*>(pts + i * stride),
+                         center));
+  }
+
+  return result;
+}
+
+} // namespace detail
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief  Returns the axis aligned box enclosing \a count points.
+/// \param  points  Address of the first point.
+/// \param  stride  Distance in bytes between two consecutive points.
+/// \remarks For an empty array aabb3f::stdc::empty is returned.
+inline aabb3f compute_aabb(const float3* points, const size_t stride,
+                           const size_t count) noexcept {
+  assert(stride >= sizeof(float3));
+  const auto pts = reinterpret_cast<const uint8_t*>(points);
+
+  if (count < batch_bounds_parallel_threshold)
+    return detail::bounds_aabb_serial(pts, stride, count);
+
+  return tbb::parallel_reduce(
+      tbb::blocked_range<size_t>{0, count,
+                                 batch_bounds_parallel_threshold / 4},
+      aabb3f{aabb3f::stdc::empty},
+      [pts, stride](const tbb::blocked_range<size_t>& rng,
+                    const aabb3f&                     init) {
+        return merge(init, detail::bounds_aabb_serial(
+                               pts + rng.begin() * stride, stride,
+                               rng.size()));
+      },
+      [](const aabb3f& a, const aabb3f& b) { return merge(a, b); });
+}
+
+inline aabb3f compute_aabb(gsl::span<const float3> points) noexcept {
+  return compute_aabb(points.data(), sizeof(float3),
+                      static_cast<size_t>(points.size()));
+}
+
+/// \brief  Returns a sphere enclosing \a count points. The sphere is centered
+///         on the center of \a box (the bounding box of the points, as
+///         returned by compute_aabb) and its radius is the distance to the
+///         farthest point. Not minimal, but never larger than the sphere
+///         circumscribing the box.
+inline sphere3f compute_bounding_sphere(const float3* points,
+                                        const size_t  stride,
+                                        const size_t  count,
+                                        const aabb3f& box) noexcept {
+  assert(stride >= sizeof(float3));
+
+  if (count == 0)
+    return {float3::stdc::zero, 0.0f};
+
+  const auto pts    = reinterpret_cast<const uint8_t*>(points);
+  const auto center = box.center();
+
+  const float max_dist_sq =
+      count < batch_bounds_parallel_threshold
+          ? detail::bounds_max_dist_sq_serial(pts, stride, count, center)
+          : tbb::parallel_reduce(
+                tbb::blocked_range<size_t>{
+                    0, count, batch_bounds_parallel_threshold / 4},
+                0.0f,
+                [pts, stride, &center](const tbb::blocked_range<size_t>& rng,
+                                       const float init) {
+                  return std::max(init, detail::bounds_max_dist_sq_serial(
+                                            pts + rng.begin() * stride,
+                                            stride, rng.size(), center));
+                },
+                [](const float a, const float b) { return std::max(a, b); });
+
+  return {center, std::sqrt(max_dist_sq)};
+}
+
+inline sphere3f compute_bounding_sphere(gsl::span<const float3> points,
+                                        const aabb3f&           box) noexcept {
+  return compute_bounding_sphere(points.data(), sizeof(float3),
+                                 static_cast<size_t>(points.size()), box);
+}
+
+/// @}
+
+} // namespace math
+} // namespace xray
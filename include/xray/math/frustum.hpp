@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+///
+/// \file    frustum.hpp
+
+#include "xray/xray.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/plane.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/sphere.hpp"
+#include <cmath>
+#include <cstdint>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath_Geometry
+/// @{
+
+/// \brief  Depth range of the clip space produced by a projection matrix.
+enum class clip_depth_range {
+  minus_one_to_one, ///< OpenGL convention, -w <= z <= w.
+  zero_to_one       ///< Direct3D convention, 0 <= z <= w.
+};
+
+#if defined(XRAY_RENDERER_DIRECTX)
+constexpr clip_depth_range default_clip_depth_range =
+    clip_depth_range::zero_to_one;
+#else
+constexpr clip_depth_range default_clip_depth_range =
+    clip_depth_range::minus_one_to_one;
+#endif
+
+/// \brief  View frustum, as six planes with normals pointing inside.
+template <typename T>
+struct frustum {
+  enum plane_id : uint32_t {
+    left_plane,
+    right_plane,
+    bottom_plane,
+    top_plane,
+    near_plane,
+    far_plane,
+    plane_count
+  };
+
+  plane<T> planes[plane_count];
+};
+
+/// \brief  Extracts the (normalized) frustum planes from a projection * view
+///         matrix. The planes are expressed in the space of the vertices the
+///         matrix is applied to (world space for projection * view,
+///         object space for projection * view * world).
+template <typename T>
+frustum<T> extract_frustum(
+    const scalar4x4<T>&    projection_view,
+    const clip_depth_range depth_range = default_clip_depth_range) noexcept {
+  const auto& m = projection_view;
+
+  //
+  // A point P is inside the frustum when -w <= x, y, z <= w (0 <= z <= w for
+  // D3D), with (x, y, z, w) = M * P. Each inequality is a plane made of a
+  // combination of the rows of M (Gribb & Hartmann).
+  const plane<T> row0{m.a00, m.a01, m.a02, m.a03};
+  const plane<T> row1{m.a10, m.a11, m.a12, m.a13};
+  const plane<T> row2{m.a20, m.a21, m.a22, m.a23};
+  const plane<T> row3{m.a30, m.a31, m.a32, m.a33};
+
+  const auto add = [](const plane<T>& a, const plane<T>& b) {
+    return plane<T>{a.normal + b.normal, a.d + b.d};
+  };
+
+  const auto sub = [](const plane<T>& a, const plane<T>& b) {
+    return plane<T>{a.normal - b.normal, a.d - b.d};
+  };
+
+  frustum<T> f;
+  f.planes[frustum<T>::left_plane]   = normalize(add(row3, row0));
+  f.planes[frustum<T>::right_plane]  = normalize(sub(row3, row0));
+  f.planes[frustum<T>::bottom_plane] = normalize(add(row3, row1));
+  f.planes[frustum<T>::top_plane]    = normalize(sub(row3, row1));
+  f.planes[frustum<T>::near_plane] =
+      normalize(depth_range == clip_depth_range::minus_one_to_one
+                    ? add(row3, row2)
+                    : row2);
+  f.planes[frustum<T>::far_plane] = normalize(sub(row3, row2));
+
+  return f;
+}
+
+/// \brief  Tests a box against the frustum. Conservative : boxes that are
+///         outside the frustum, close to a corner, may be reported visible.
+template <typename T>
+bool is_visible(const frustum<T>& f, const aabb3<T>& box) noexcept {
+  const auto c = box.center();
+  const auto e = box.extents();
+
+  for (const auto& p : f.planes) {
+    const auto dist = dot(p.normal, c) + p.d;
+    const auto r    = std::abs(p.normal.x) * e.x + std::abs(p.normal.y) * e.y +
+                   std::abs(p.normal.z) * e.z;
+
+    if (dist < -r)
+      return false;
+  }
+
+  return true;
+}
+
+/// \brief  Tests a sphere against the frustum.
+template <typename T>
+bool is_visible(const frustum<T>& f, const sphere<T>& s) noexcept {
+  for (const auto& p : f.planes) {
+    if (dot(p.normal, s.center) + p.d < -s.radius)
+      return false;
+  }
+
+  return true;
+}
+
+using frustum3f = frustum<float>;
+
+/// @}
+
+} // namespace math
+} // namespace xray
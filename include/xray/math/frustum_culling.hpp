@@ -0,0 +1,224 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file frustum_culling.hpp
+/// \brief Tests arrays of bounding boxes/spheres against a view frustum.
+/// Results are written as a bitmask : bit (i % 32) of word (i / 32) is set
+/// when object i is potentially visible. Objects are tested
+/// native_float_lanes at a time; arrays with at least
+/// batch_cull_parallel_threshold objects are split across TBB worker
+/// threads (on 32 object boundaries, so no two threads write the same word).
+/// The outcome for each object is identical to calling is_visible().
+
+#include "xray/xray.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/frustum.hpp"
+#include "xray/math/scalar3_lanes.hpp"
+#include "xray/math/scalar3_lanes_math.hpp"
+#include "xray/math/scalar_lanes.hpp"
+#include "xray/math/sphere.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <span.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief Arrays with at least this many objects are culled in parallel.
+constexpr size_t batch_cull_parallel_threshold = 8192;
+
+/// \brief Number of 32 bit words needed for the visibility mask of
+/// \a object_count objects.
+inline constexpr size_t visibility_mask_words(const size_t object_count) noexcept {
+  return (object_count + 31) / 32;
+}
+
+/// \brief Tests the visibility bit of an object.
+inline bool is_visible(gsl::span<const uint32_t> visibility_mask,
+                       const size_t              object) noexcept {
+  return (visibility_mask[static_cast<ptrdiff_t>(object / 32)] &
+          (1u << (object % 32))) != 0;
+}
+
+/// @}
+
+namespace detail {
+
+template <size_t N>
+struct frustum_lanes {
+  using lane_type = scalar_lanes<float, N>;
+
+  struct plane_lanes {
+    scalar3_lanes<float, N> normal;
+    scalar3_lanes<float, N> abs_normal;
+    lane_type               d;
+  };
+
+  plane_lanes planes[frustum3f::plane_count];
+
+  explicit frustum_lanes(const frustum3f& f) noexcept {
+    for (size_t i = 0; i < frustum3f::plane_count; ++i) {
+      const auto& n = f.planes[i].normal;
+
+      planes[i].normal = scalar3_lanes<float, N>{n};
+      planes[i].abs_normal =
+          scalar3_lanes<float, N>{float3{std::abs(n.x), std::abs(n.y),
+                                         std::abs(n.z)}};
+      planes[i].d = lane_type{f.planes[i].d};
+    }
+  }
+};
+
+template <size_t N>
+uint32_t cull_aabbs_lanes(const frustum_lanes<N>& f, const aabb3f* boxes,
+                          const size_t count) noexcept {
+  using vec_lanes = scalar3_lanes<float, N>;
+
+  const auto box_min =
+      vec_lanes::load_partial(&boxes->min, sizeof(aabb3f), count);
+  const auto box_max =
+      vec_lanes::load_partial(&boxes->max, sizeof(aabb3f), count);
+
+  const auto center  = (box_min + box_max) * 0.5f;
+  const auto extents = (box_max - box_min) * 0.5f;
+
+  uint32_t outside = 0;
+  for (const auto& p : f.planes) {
+    const auto dist = dot(p.normal, center) + p.d;
+    const auto r    = p.abs_normal.x * extents.x + p.abs_normal.y * extents.y +
+                   p.abs_normal.z * extents.z;
+    outside |= mask_bits(dist < -r);
+  }
+
+  return ~outside & ((1u << count) - 1);
+}
+
+template <size_t N>
+uint32_t cull_spheres_lanes(const frustum_lanes<N>& f, const sphere3f* spheres,
+                            const size_t count) noexcept {
+  using vec_lanes = scalar3_lanes<float, N>;
+  using lane_type = scalar_lanes<float, N>;
+
+  const auto center =
+      vec_lanes::load_partial(&spheres->center, sizeof(sphere3f), count);
+
+  alignas(32) float radii[N];
+  for (size_t i = 0; i < N; ++i)
+    radii[i] = i < count ? -spheres[i].radius : 0.0f;
+  const auto neg_radius = lane_type::load(radii);
+
+  uint32_t outside = 0;
+  for (const auto& p : f.planes) {
+    outside |= mask_bits((dot(p.normal, center) + p.d) < neg_radius);
+  }
+
+  return ~outside & ((1u << count) - 1);
+}
+
+template <typename bounding_volume, typename lanes_fn>
+void cull_serial(const frustum_lanes<native_float_lanes>& f,
+                 const bounding_volume* objects, const size_t first_word,
+                 const size_t last_word, const size_t count, uint32_t* mask,
+                 lanes_fn test_lanes) noexcept {
+  constexpr auto width = native_float_lanes;
+
+  for (size_t word = first_word; word < last_word; ++word) {
+    const size_t first = word * 32;
+    const size_t last  = std::min(first + 32, count);
+    uint32_t     bits  = 0;
+
+    for (size_t i = first; i < last; i += width) {
+      const auto lanes = std::min(width, last - i);
+      bits |= test_lanes(f, objects + i, lanes) << (i - first);
+    }
+
+    mask[word] = bits;
+  }
+}
+
+template <typename bounding_volume, typename lanes_fn>
+void cull(const frustum3f& f, gsl::span<const bounding_volume> objects,
+          gsl::span<uint32_t> visibility_mask, lanes_fn test_lanes) noexcept {
+  static_assert(32 % native_float_lanes == 0, "Unsupported lane count!");
+
+  const auto count = static_cast<size_t>(objects.size());
+  const auto words = visibility_mask_words(count);
+  assert(static_cast<size_t>(visibility_mask.size()) >= words);
+
+  const frustum_lanes<native_float_lanes> fl{f};
+  const auto obj  = objects.data();
+  const auto mask = visibility_mask.data();
+
+  if (count < batch_cull_parallel_threshold) {
+    cull_serial(fl, obj, 0, words, count, mask, test_lanes);
+    return;
+  }
+
+  tbb::parallel_for(tbb::blocked_range<size_t>{0, words, 64},
+                    [&fl, obj, count, mask,
+                     test_lanes](const tbb::blocked_range<size_t>& rng) {
+                      cull_serial(fl, obj, rng.begin(), rng.end(), count, mask,
+                                  test_lanes);
+                    });
+}
+
+} // namespace detail
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief  Tests an array of boxes against a frustum.
+/// \param  visibility_mask Receives the visibility bits, must have at least
+///         visibility_mask_words(boxes.size()) elements.
+inline void cull_aabbs(const frustum3f& f, gsl::span<const aabb3f> boxes,
+                       gsl::span<uint32_t> visibility_mask) noexcept {
+  detail::cull(f, boxes, visibility_mask,
+               &detail::cull_aabbs_lanes<native_float_lanes>);
+}
+
+/// \brief  Tests an array of spheres against a frustum.
+/// \param  visibility_mask Receives the visibility bits, must have at least
+///         visibility_mask_words(spheres.size()) elements.
+inline void cull_spheres(const frustum3f& f, gsl::span<const sphere3f> spheres,
+                         gsl::span<uint32_t> visibility_mask) noexcept {
+  detail::cull(f, spheres, visibility_mask,
+               &detail::cull_spheres_lanes<native_float_lanes>);
+}
+
+/// @}
+
+} // namespace math
+} // namespace xray
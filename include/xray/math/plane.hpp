@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+///
+/// \file    plane.hpp
+
+#include "xray/xray.hpp"
+#include "xray/math/math_base.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include <cassert>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath_Geometry
+/// @{
+
+/// \brief  Plane in R3, stored as dot(normal, P) + d = 0. Points with a
+///         positive signed distance are in front of the plane.
+template <typename T>
+struct plane {
+  scalar3<T> normal;
+  T          d;
+
+  plane() noexcept = default;
+
+  constexpr plane(const scalar3<T>& n, const T dval) noexcept
+      : normal{n}, d{dval} {}
+
+  constexpr plane(const T a, const T b, const T c, const T dval) noexcept
+      : normal{a, b, c}, d{dval} {}
+};
+
+/// \brief  Signed distance from the plane to the point. The result is an
+///         actual distance only if the plane is normalized.
+template <typename T>
+inline T signed_distance(const plane<T>& p, const scalar3<T>& pt) noexcept {
+  return dot(p.normal, pt) + p.d;
+}
+
+/// \brief  Returns a plane with a unit length normal.
+template <typename T>
+inline plane<T> normalize(const plane<T>& p) noexcept {
+  const auto len = length(p.normal);
+  assert(!is_zero(len));
+  return {p.normal / len, p.d / len};
+}
+
+using plane3f = plane<float>;
+using plane3d = plane<double>;
+
+/// @}
+
+} // namespace math
+} // namespace xray
@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   quaternion.hpp
+
+#include "xray/xray.hpp"
+#include "xray/math/scalar3.hpp"
+#include <cstdint>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath_Geometry
+/// @{
+
+/// \brief  A quaternion q = w + x * i + y * j + z * k. Unit quaternions are
+///         used to represent rotations in R3.
+/// \remarks Composition follows the same convention as the matrices : the
+///          product q1 * q0 represents the rotation q0 followed by the rotation
+///          q1.
+template <typename T>
+class quaternion {
+public:
+  using class_type = quaternion<T>;
+
+  union {
+    struct {
+      T w;
+      T x;
+      T y;
+      T z;
+    };
+
+    T components[4];
+  };
+
+  /// Default constructor. Leaves elements uninitialized.
+  quaternion() noexcept = default;
+
+  constexpr quaternion(const T wval, const T xval, const T yval,
+                       const T zval) noexcept
+      : w{wval}, x{xval}, y{yval}, z{zval} {}
+
+  /// \brief Constructs from a real part and a vector part.
+  constexpr quaternion(const T real, const scalar3<T>& v) noexcept
+      : w{real}, x{v.x}, y{v.y}, z{v.z} {}
+
+  /// \brief Returns the vector (imaginary) part.
+  scalar3<T> vec() const noexcept { return {x, y, z}; }
+
+  class_type& operator+=(const class_type& rhs) noexcept {
+    w += rhs.w;
+    x += rhs.x;
+    y += rhs.y;
+    z += rhs.z;
+    return *this;
+  }
+
+  class_type& operator-=(const class_type& rhs) noexcept {
+    w -= rhs.w;
+    x -= rhs.x;
+    y -= rhs.y;
+    z -= rhs.z;
+    return *this;
+  }
+
+  class_type& operator*=(const T k) noexcept {
+    w *= k;
+    x *= k;
+    y *= k;
+    z *= k;
+    return *this;
+  }
+
+  class_type& operator/=(const T k) noexcept {
+    w /= k;
+    x /= k;
+    y /= k;
+    z /= k;
+    return *this;
+  }
+
+  /// \name Standard constants.
+  /// @{
+
+public:
+  struct stdc;
+
+  /// @}
+};
+
+template <typename T>
+struct quaternion<T>::stdc {
+  static constexpr quaternion<T> null{T(0), T(0), T(0), T(0)};
+  static constexpr quaternion<T> identity{T(1), T(0), T(0), T(0)};
+};
+
+template <typename T>
+constexpr quaternion<T> quaternion<T>::stdc::null;
+
+template <typename T>
+constexpr quaternion<T> quaternion<T>::stdc::identity;
+
+using quaternionf = quaternion<float>;
+using quaterniond = quaternion<double>;
+
+/// @}
+
+} // namespace math
+} // namespace xray
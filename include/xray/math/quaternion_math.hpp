@@ -0,0 +1,280 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   quaternion_math.hpp
+
+#include "xray/xray.hpp"
+#include "xray/math/math_base.hpp"
+#include "xray/math/quaternion.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/math/scalar3x3.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include <cassert>
+#include <cmath>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief  Cosine of the angle between two quaternions above which slerp
+///         falls back to a normalized linear interpolation.
+template <typename T>
+constexpr T slerp_nlerp_threshold = T(0.9995);
+
+template <typename T>
+inline bool operator==(const quaternion<T>& a, const quaternion<T>& b) noexcept {
+  return is_equal(a.w, b.w) && is_equal(a.x, b.x) && is_equal(a.y, b.y) &&
+         is_equal(a.z, b.z);
+}
+
+template <typename T>
+inline bool operator!=(const quaternion<T>& a, const quaternion<T>& b) noexcept {
+  return !(a == b);
+}
+
+template <typename T>
+inline quaternion<T> operator+(const quaternion<T>& a,
+                               const quaternion<T>& b) noexcept {
+  return {a.w + b.w, a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+template <typename T>
+inline quaternion<T> operator-(const quaternion<T>& a,
+                               const quaternion<T>& b) noexcept {
+  return {a.w - b.w, a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+template <typename T>
+inline quaternion<T> operator-(const quaternion<T>& q) noexcept {
+  return {-q.w, -q.x, -q.y, -q.z};
+}
+
+template <typename T>
+inline quaternion<T> operator*(const quaternion<T>& q, const T k) noexcept {
+  return {q.w * k, q.x * k, q.y * k, q.z * k};
+}
+
+template <typename T>
+inline quaternion<T> operator*(const T k, const quaternion<T>& q) noexcept {
+  return q * k;
+}
+
+template <typename T>
+inline quaternion<T> operator/(const quaternion<T>& q, const T k) noexcept {
+  return {q.w / k, q.x / k, q.y / k, q.z / k};
+}
+
+/// \brief  Quaternion product (composition). The result represents the
+///         rotation \a b followed by the rotation \a a.
+template <typename T>
+inline quaternion<T> operator*(const quaternion<T>& a,
+                               const quaternion<T>& b) noexcept {
+  return {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+          a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+          a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+          a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+}
+
+template <typename T>
+inline T dot(const quaternion<T>& a, const quaternion<T>& b) noexcept {
+  return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <typename T>
+inline T length_squared(const quaternion<T>& q) noexcept {
+  return dot(q, q);
+}
+
+template <typename T>
+inline T length(const quaternion<T>& q) noexcept {
+  return std::sqrt(length_squared(q));
+}
+
+/// \brief  Returns a unit length quaternion. A (near) zero length input
+///         yields the null quaternion.
+template <typename T>
+quaternion<T> normalize(const quaternion<T>& q) noexcept {
+  const auto len_squared = length_squared(q);
+  if (is_zero(len_squared))
+    return quaternion<T>::stdc::null;
+
+  return q / std::sqrt(len_squared);
+}
+
+template <typename T>
+inline quaternion<T> conjugate(const quaternion<T>& q) noexcept {
+  return {q.w, -q.x, -q.y, -q.z};
+}
+
+/// \brief  Returns the multiplicative inverse. For unit quaternions this is
+///         the same as the conjugate.
+template <typename T>
+inline quaternion<T> invert(const quaternion<T>& q) noexcept {
+  const auto len_squared = length_squared(q);
+  assert(!is_zero(len_squared));
+  return conjugate(q) / len_squared;
+}
+
+/// \brief  Returns the unit quaternion for a rotation of \a theta radians
+///         around \a axis (must be unit length). Same convention as
+///         R3::rotate_axis_angle.
+template <typename T>
+quaternion<T> quaternion_from_axis_angle(const scalar3<T>& axis,
+                                         const T           theta) noexcept {
+  const auto half_theta = theta * T(0.5);
+  const auto s          = std::sin(half_theta);
+  return {std::cos(half_theta), axis.x * s, axis.y * s, axis.z * s};
+}
+
+/// \brief  Rotates a vector by a unit quaternion.
+template <typename T>
+scalar3<T> rotate_vector(const quaternion<T>& q, const scalar3<T>& v) noexcept {
+  //
+  // v' = q * v * conj(q), expanded :
+  // t = 2 * cross(q.xyz, v); v' = v + q.w * t + cross(q.xyz, t)
+  const auto qv = q.vec();
+  const auto t  = cross(qv, v) * T(2);
+  return v + t * q.w + cross(qv, t);
+}
+
+/// \brief  Returns the rotation matrix for a unit quaternion.
+template <typename T>
+scalar3x3<T> to_scalar3x3(const quaternion<T>& q) noexcept {
+  const auto xx = q.x * q.x;
+  const auto yy = q.y * q.y;
+  const auto zz = q.z * q.z;
+  const auto xy = q.x * q.y;
+  const auto xz = q.x * q.z;
+  const auto yz = q.y * q.z;
+  const auto wx = q.w * q.x;
+  const auto wy = q.w * q.y;
+  const auto wz = q.w * q.z;
+
+  // clang-format off
+  return {T(1) - T(2) * (yy + zz), T(2) * (xy - wz), T(2) * (xz + wy),
+          T(2) * (xy + wz), T(1) - T(2) * (xx + zz), T(2) * (yz - wx),
+          T(2) * (xz - wy), T(2) * (yz + wx), T(1) - T(2) * (xx + yy)};
+  // clang-format on
+}
+
+/// \brief  Returns the 4x4 rotation matrix for a unit quaternion.
+template <typename T>
+scalar4x4<T> to_scalar4x4(const quaternion<T>& q) noexcept {
+  return scalar4x4<T>{to_scalar3x3(q)};
+}
+
+namespace detail {
+
+template <typename T>
+quaternion<T> quaternion_from_rotation(const T m00, const T m01, const T m02,
+                                       const T m10, const T m11, const T m12,
+                                       const T m20, const T m21,
+                                       const T m22) noexcept {
+  //
+  // Pick the largest of w, x, y, z to avoid dividing by a small number.
+  const auto trace = m00 + m11 + m22;
+
+  if (trace > T(0)) {
+    const auto s = std::sqrt(trace + T(1)) * T(2);
+    return {T(0.25) * s, (m21 - m12) / s, (m02 - m20) / s, (m10 - m01) / s};
+  }
+
+  if ((m00 > m11) && (m00 > m22)) {
+    const auto s = std::sqrt(T(1) + m00 - m11 - m22) * T(2);
+    return {(m21 - m12) / s, T(0.25) * s, (m01 + m10) / s, (m02 + m20) / s};
+  }
+
+  if (m11 > m22) {
+    const auto s = std::sqrt(T(1) + m11 - m00 - m22) * T(2);
+    return {(m02 - m20) / s, (m01 + m10) / s, T(0.25) * s, (m12 + m21) / s};
+  }
+
+  const auto s = std::sqrt(T(1) + m22 - m00 - m11) * T(2);
+  return {(m10 - m01) / s, (m02 + m20) / s, (m12 + m21) / s, T(0.25) * s};
+}
+
+} // namespace detail
+
+/// \brief  Returns the unit quaternion for a rotation matrix (the matrix must
+///         be orthogonal, with a determinant of 1).
+template <typename T>
+quaternion<T> quaternion_from_matrix(const scalar3x3<T>& m) noexcept {
+  return detail::quaternion_from_rotation(m.a00, m.a01, m.a02, m.a10, m.a11,
+                                          m.a12, m.a20, m.a21, m.a22);
+}
+
+/// \brief  Returns the unit quaternion for the rotation part of a 4x4
+///         matrix (the upper 3x3 block must be a rotation).
+template <typename T>
+quaternion<T> quaternion_from_matrix(const scalar4x4<T>& m) noexcept {
+  return detail::quaternion_from_rotation(m.a00, m.a01, m.a02, m.a10, m.a11,
+                                          m.a12, m.a20, m.a21, m.a22);
+}
+
+/// \brief  Normalized linear interpolation of two unit quaternions, along
+///         the shortest arc. Cheaper than slerp, but the angular velocity is
+///         not constant.
+template <typename T>
+quaternion<T> nlerp(const quaternion<T>& a, const quaternion<T>& b,
+                    const T t) noexcept {
+  const auto bb = dot(a, b) < T(0) ? -b : b;
+  return normalize(a * (T(1) - t) + bb * t);
+}
+
+/// \brief  Spherical linear interpolation of two unit quaternions, along the
+///         shortest arc.
+template <typename T>
+quaternion<T> slerp(const quaternion<T>& a, const quaternion<T>& b,
+                    const T t) noexcept {
+  auto       cos_theta = dot(a, b);
+  const auto bb        = cos_theta < T(0) ? -b : b;
+  cos_theta            = std::abs(cos_theta);
+
+  if (cos_theta > slerp_nlerp_threshold<T>) {
+    //
+    // Quaternions are very close, sin(theta) -> 0.
+    return normalize(a * (T(1) - t) + bb * t);
+  }
+
+  const auto theta     = std::acos(cos_theta);
+  const auto sin_theta = std::sin(theta);
+  const auto ka        = std::sin((T(1) - t) * theta) / sin_theta;
+  const auto kb        = std::sin(t * theta) / sin_theta;
+
+  return a * ka + bb * kb;
+}
+
+/// @}
+
+} // namespace math
+} // namespace xray
@@ -0,0 +1,279 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file quaternion_math_batch.hpp
+/// \brief Interpolates arrays of unit quaternions (animation blending).
+/// Quaternions are processed native_float_lanes at a time in structure of
+/// arrays form; inputs with at least batch_blend_parallel_threshold elements
+/// are split across TBB worker threads. Results are identical to calling
+/// nlerp/slerp for every element.
+
+#include "xray/xray.hpp"
+#include "xray/math/quaternion.hpp"
+#include "xray/math/quaternion_math.hpp"
+#include "xray/math/scalar_lanes.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <span.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief Inputs with at least this many elements are blended in parallel.
+constexpr size_t batch_blend_parallel_threshold = 8192;
+
+/// @}
+
+namespace detail {
+
+template <size_t N>
+struct quaternion_lanes {
+  using lane_type = scalar_lanes<float, N>;
+
+  lane_type w, x, y, z;
+
+  static quaternion_lanes load(const quaternionf* src) noexcept {
+    alignas(32) float c[4][N];
+    for (size_t i = 0; i < N; ++i) {
+      c[0][i] = src[i].w;
+      c[1][i] = src[i].x;
+      c[2][i] = src[i].y;
+      c[3][i] = src[i].z;
+    }
+
+    return {lane_type::load(c[0]), lane_type::load(c[1]),
+            lane_type::load(c[2]), lane_type::load(c[3])};
+  }
+
+  void store(quaternionf* dst) const noexcept {
+    alignas(32) float c[4][N];
+    w.store(c[0]);
+    x.store(c[1]);
+    y.store(c[2]);
+    z.store(c[3]);
+
+    for (size_t i = 0; i < N; ++i) {
+      dst[i] = {c[0][i], c[1][i], c[2][i], c[3][i]};
+    }
+  }
+};
+
+template <size_t N>
+inline scalar_lanes<float, N> dot(const quaternion_lanes<N>& a,
+                                  const quaternion_lanes<N>& b) noexcept {
+  return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/// \brief a * ka + b * kb
+template <size_t N>
+inline quaternion_lanes<N>
+combine(const quaternion_lanes<N>& a, const scalar_lanes<float, N>& ka,
+        const quaternion_lanes<N>& b, const scalar_lanes<float, N>& kb) noexcept {
+  return {a.w * ka + b.w * kb, a.x * ka + b.x * kb, a.y * ka + b.y * kb,
+          a.z * ka + b.z * kb};
+}
+
+template <size_t N>
+inline quaternion_lanes<N> normalize(const quaternion_lanes<N>& q) noexcept {
+  using lane_type = scalar_lanes<float, N>;
+
+  const auto len_squared = dot(q, q);
+  const auto is_zero_len = abs(len_squared) < lane_type{epsilon<float>};
+  const auto len         = sqrt(len_squared);
+  const auto zero        = lane_type{0.0f};
+
+  return {select(is_zero_len, zero, q.w / len),
+          select(is_zero_len, zero, q.x / len),
+          select(is_zero_len, zero, q.y / len),
+          select(is_zero_len, zero, q.z / len)};
+}
+
+/// \brief Flips the second quaternion where needed to take the shortest arc.
+template <size_t N>
+inline quaternion_lanes<N>
+shortest_arc(const quaternion_lanes<N>& b,
+             const scalar_lanes<float, N>& cos_theta) noexcept {
+  using lane_type = scalar_lanes<float, N>;
+
+  const auto is_negative = cos_theta < lane_type{0.0f};
+  return {select(is_negative, -b.w, b.w), select(is_negative, -b.x, b.x),
+          select(is_negative, -b.y, b.y), select(is_negative, -b.z, b.z)};
+}
+
+template <size_t N>
+inline quaternion_lanes<N> nlerp_lanes(const quaternion_lanes<N>&    a,
+                                       const quaternion_lanes<N>&    b,
+                                       const scalar_lanes<float, N>& t) noexcept {
+  using lane_type = scalar_lanes<float, N>;
+
+  const auto bb = shortest_arc(b, dot(a, b));
+  return normalize(combine(a, lane_type{1.0f} - t, bb, t));
+}
+
+template <size_t N>
+inline quaternion_lanes<N> slerp_lanes(const quaternion_lanes<N>&    a,
+                                       const quaternion_lanes<N>&    b,
+                                       const scalar_lanes<float, N>& t) noexcept {
+  using lane_type = scalar_lanes<float, N>;
+
+  const auto cos_theta  = dot(a, b);
+  const auto bb         = shortest_arc(b, cos_theta);
+  const auto abs_cos    = abs(cos_theta);
+  const auto one_minus  = lane_type{1.0f} - t;
+  const auto is_close   = abs_cos > lane_type{slerp_nlerp_threshold<float>};
+
+  //
+  // No SIMD acos/sin, the interpolation weights are computed per lane.
+  alignas(32) float cosines[N];
+  alignas(32) float tvals[N];
+  alignas(32) float ka[N];
+  alignas(32) float kb[N];
+  abs_cos.store(cosines);
+  t.store(tvals);
+
+  for (size_t i = 0; i < N; ++i) {
+    if (cosines[i] > slerp_nlerp_threshold<float>) {
+      ka[i] = kb[i] = 0.0f;
+      continue;
+    }
+
+    const auto theta     = std::acos(cosines[i]);
+    const auto sin_theta = std::sin(theta);
+    ka[i]                = std::sin((1.0f - tvals[i]) * theta) / sin_theta;
+    kb[i]                = std::sin(tvals[i] * theta) / sin_theta;
+  }
+
+  const auto slerped =
+      combine(a, lane_type::load(ka), bb, lane_type::load(kb));
+  const auto nlerped = normalize(combine(a, one_minus, bb, t));
+
+  return {select(is_close, nlerped.w, slerped.w),
+          select(is_close, nlerped.x, slerped.x),
+          select(is_close, nlerped.y, slerped.y),
+          select(is_close, nlerped.z, slerped.z)};
+}
+
+template <bool spherical>
+void blend_serial(const quaternionf* a, const quaternionf* b, const float* t,
+                  const float t_all, quaternionf* out,
+                  const size_t count) noexcept {
+  constexpr auto width = native_float_lanes;
+  using lanes_type     = quaternion_lanes<width>;
+  using lane_type      = scalar_lanes<float, width>;
+
+  const size_t batched = count - count % width;
+  size_t       i       = 0;
+
+  for (; i < batched; i += width) {
+    const auto qa = lanes_type::load(a + i);
+    const auto qb = lanes_type::load(b + i);
+    const auto qt = t ? lane_type::load(t + i) : lane_type{t_all};
+
+    const auto r = spherical ? slerp_lanes(qa, qb, qt) : nlerp_lanes(qa, qb, qt);
+    r.store(out + i);
+  }
+
+  for (; i < count; ++i) {
+    const auto ti = t ? t[i] : t_all;
+    out[i] = spherical ? slerp(a[i], b[i], ti) : nlerp(a[i], b[i], ti);
+  }
+}
+
+template <bool spherical>
+void blend(gsl::span<const quaternionf> a, gsl::span<const quaternionf> b,
+           const float* t, const float t_all,
+           gsl::span<quaternionf> out) noexcept {
+  assert(a.size() == b.size());
+  assert(out.size() >= a.size());
+
+  const auto count = static_cast<size_t>(a.size());
+  const auto qa    = a.data();
+  const auto qb    = b.data();
+  const auto qout  = out.data();
+
+  if (count < batch_blend_parallel_threshold) {
+    blend_serial<spherical>(qa, qb, t, t_all, qout, count);
+    return;
+  }
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, count, batch_blend_parallel_threshold / 4},
+      [qa, qb, t, t_all, qout](const tbb::blocked_range<size_t>& rng) {
+        const auto first = rng.begin();
+        blend_serial<spherical>(qa + first, qb + first, t ? t + first : t,
+                                t_all, qout + first, rng.size());
+      });
+}
+
+} // namespace detail
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief  out[i] = nlerp(a[i], b[i], t[i]).
+inline void nlerp_n(gsl::span<const quaternionf> a,
+                    gsl::span<const quaternionf> b, gsl::span<const float> t,
+                    gsl::span<quaternionf> out) noexcept {
+  assert(t.size() >= a.size());
+  detail::blend<false>(a, b, t.data(), 0.0f, out);
+}
+
+/// \brief  out[i] = nlerp(a[i], b[i], t).
+inline void nlerp_n(gsl::span<const quaternionf> a,
+                    gsl::span<const quaternionf> b, const float t,
+                    gsl::span<quaternionf> out) noexcept {
+  detail::blend<false>(a, b, nullptr, t, out);
+}
+
+/// \brief  out[i] = slerp(a[i], b[i], t[i]).
+inline void slerp_n(gsl::span<const quaternionf> a,
+                    gsl::span<const quaternionf> b, gsl::span<const float> t,
+                    gsl::span<quaternionf> out) noexcept {
+  assert(t.size() >= a.size());
+  detail::blend<true>(a, b, t.data(), 0.0f, out);
+}
+
+/// \brief  out[i] = slerp(a[i], b[i], t).
+inline void slerp_n(gsl::span<const quaternionf> a,
+                    gsl::span<const quaternionf> b, const float t,
+                    gsl::span<quaternionf> out) noexcept {
+  detail::blend<true>(a, b, nullptr, t, out);
+}
+
+/// @}
+
+} // namespace math
+} // namespace xray
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file scalar3_lanes.hpp
+/// \brief N three component vectors, stored in structure of arrays form.
+
+#include "xray/xray.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar_lanes.hpp"
+#include <cassert>
+#include <cstdint>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief  N three component vectors, stored as one packet of lanes per
+///         component. Lane i of x, y and z holds the i-th vector.
+/// \remarks Vectors are loaded from/stored to AoS streams (arrays of scalar3
+///          or the position/normal member of an interleaved vertex), with an
+///          arbitrary stride in bytes between consecutive elements.
+template <typename T, size_t N>
+struct scalar3_lanes {
+  using lane_type   = scalar_lanes<T, N>;
+  using mask_type   = typename lane_type::mask_type;
+  using vector_type = scalar3<T>;
+  static constexpr size_t lanes = N;
+
+  lane_type x;
+  lane_type y;
+  lane_type z;
+
+  scalar3_lanes() noexcept = default;
+
+  scalar3_lanes(const lane_type& xval, const lane_type& yval,
+                const lane_type& zval) noexcept
+      : x{xval}, y{yval}, z{zval} {}
+
+  /// \brief Sets all lanes to the same vector.
+  explicit scalar3_lanes(const vector_type& v) noexcept
+      : x{v.x}, y{v.y}, z{v.z} {}
+
+  /// \brief  Loads N vectors.
+  /// \param  src     Address of the first vector.
+  /// \param  stride  Distance in bytes between two consecutive vectors.
+  static scalar3_lanes load(const vector_type* src,
+                            const size_t stride = sizeof(vector_type)) noexcept {
+    return load_partial(src, stride, N);
+  }
+
+  /// \brief  Loads \a count vectors (count <= N), the remaining lanes are set
+  ///         to zero.
+  static scalar3_lanes load_partial(const vector_type* src, const size_t stride,
+                                    const size_t count) noexcept {
+    assert(count <= N);
+
+    alignas(32) T xs[N];
+    alignas(32) T ys[N];
+    alignas(32) T zs[N];
+
+    auto ptr = reinterpret_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < count; ++i, ptr += stride) {
+      const auto v = reinterpret_cast<const vector_type*>(ptr);
+      xs[i]        = v->x;
+      ys[i]        = v->y;
+      zs[i]        = v->z;
+    }
+
+    for (size_t i = count; i < N; ++i) {
+      xs[i] = ys[i] = zs[i] = T(0);
+    }
+
+    return {lane_type::load(xs), lane_type::load(ys), lane_type::load(zs)};
+  }
+
+  /// \brief  Stores the N vectors.
+  /// \param  dst     Address of the first vector.
+  /// \param  stride  Distance in bytes between two consecutive vectors.
+  void store(vector_type* dst, const size_t stride = sizeof(vector_type)) const
+      noexcept {
+    store_partial(dst, stride, N);
+  }
+
+  /// \brief  Stores the first \a count vectors (count <= N).
+  void store_partial(vector_type* dst, const size_t stride,
+                     const size_t count) const noexcept {
+    assert(count <= N);
+
+    alignas(32) T xs[N];
+    alignas(32) T ys[N];
+    alignas(32) T zs[N];
+
+    x.store(xs);
+    y.store(ys);
+    z.store(zs);
+
+    auto ptr = reinterpret_cast<uint8_t*>(dst);
+    for (size_t i = 0; i < count; ++i, ptr += stride) {
+      const auto v = reinterpret_cast<vector_type*>(ptr);
+      v->x         = xs[i];
+      v->y         = ys[i];
+      v->z         = zs[i];
+    }
+  }
+
+  /// \brief Returns the vector in the specified lane.
+  vector_type lane(const size_t idx) const noexcept {
+    return {x[idx], y[idx], z[idx]};
+  }
+};
+
+using float3x4 = scalar3_lanes<float, 4>;
+using float3x8 = scalar3_lanes<float, 8>;
+
+/// @}
+
+} // namespace math
+} // namespace xray
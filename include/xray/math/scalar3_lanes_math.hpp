@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file scalar3_lanes_math.hpp
+/// \brief Lane wise versions of the scalar3 functions in scalar3_math.hpp.
+/// Every lane evaluates the same expression as the scalar function, so
+/// results are identical to processing the vectors one at a time.
+
+#include "xray/xray.hpp"
+#include "xray/math/constants.hpp"
+#include "xray/math/scalar3_lanes.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/scalar_lanes.hpp"
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator+(const scalar3_lanes<T, N>& a,
+                                     const scalar3_lanes<T, N>& b) noexcept {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator-(const scalar3_lanes<T, N>& a,
+                                     const scalar3_lanes<T, N>& b) noexcept {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator-(const scalar3_lanes<T, N>& a) noexcept {
+  return {-a.x, -a.y, -a.z};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator*(const scalar3_lanes<T, N>& v,
+                                     const scalar_lanes<T, N>&  k) noexcept {
+  return {v.x * k, v.y * k, v.z * k};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator*(const scalar_lanes<T, N>&  k,
+                                     const scalar3_lanes<T, N>& v) noexcept {
+  return {k * v.x, k * v.y, k * v.z};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator*(const scalar3_lanes<T, N>& v,
+                                     const T                    k) noexcept {
+  return v * scalar_lanes<T, N>{k};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator*(const T                    k,
+                                     const scalar3_lanes<T, N>& v) noexcept {
+  return scalar_lanes<T, N>{k} * v;
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator/(const scalar3_lanes<T, N>& v,
+                                     const scalar_lanes<T, N>&  k) noexcept {
+  return {v.x / k, v.y / k, v.z / k};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> operator/(const scalar3_lanes<T, N>& v,
+                                     const T                    k) noexcept {
+  return v / scalar_lanes<T, N>{k};
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> dot(const scalar3_lanes<T, N>& a,
+                              const scalar3_lanes<T, N>& b) noexcept {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> cross(const scalar3_lanes<T, N>& a,
+                                 const scalar3_lanes<T, N>& b) noexcept {
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> length_squared(const scalar3_lanes<T, N>& v) noexcept {
+  return dot(v, v);
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> length(const scalar3_lanes<T, N>& v) noexcept {
+  return sqrt(length_squared(v));
+}
+
+/// \brief Returns unit length vectors. Like the scalar version, lanes with a
+/// (near) zero length vector are set to the zero vector.
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> normalize(const scalar3_lanes<T, N>& v) noexcept {
+  using lane_type = scalar_lanes<T, N>;
+
+  const auto len_squared = length_squared(v);
+  const auto is_zero_len = abs(len_squared) < lane_type{epsilon<T>};
+  const auto len         = sqrt(len_squared);
+  const auto zero        = lane_type{T(0)};
+
+  return {select(is_zero_len, zero, v.x / len),
+          select(is_zero_len, zero, v.y / len),
+          select(is_zero_len, zero, v.z / len)};
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> squared_distance(const scalar3_lanes<T, N>& a,
+                                           const scalar3_lanes<T, N>& b) noexcept {
+  return length_squared(b - a);
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> distance(const scalar3_lanes<T, N>& a,
+                                   const scalar3_lanes<T, N>& b) noexcept {
+  return length(b - a);
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> min(const scalar3_lanes<T, N>& a,
+                               const scalar3_lanes<T, N>& b) noexcept {
+  return {min(a.x, b.x), min(a.y, b.y), min(a.z, b.z)};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> max(const scalar3_lanes<T, N>& a,
+                               const scalar3_lanes<T, N>& b) noexcept {
+  return {max(a.x, b.x), max(a.y, b.y), max(a.z, b.z)};
+}
+
+/// \brief Restricts every component to the [min_val, max_val] range.
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> clamp(const scalar3_lanes<T, N>& v,
+                                 const scalar_lanes<T, N>&  min_val,
+                                 const scalar_lanes<T, N>&  max_val) noexcept {
+  return {clamp(v.x, min_val, max_val), clamp(v.y, min_val, max_val),
+          clamp(v.z, min_val, max_val)};
+}
+
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> clamp(const scalar3_lanes<T, N>& v, const T min_val,
+                                 const T max_val) noexcept {
+  return clamp(v, scalar_lanes<T, N>{min_val}, scalar_lanes<T, N>{max_val});
+}
+
+/// \brief Component wise clamp, to the box defined by \a min_val, \a max_val.
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> clamp(const scalar3_lanes<T, N>& v,
+                                 const scalar3_lanes<T, N>& min_val,
+                                 const scalar3_lanes<T, N>& max_val) noexcept {
+  return min(max(v, min_val), max_val);
+}
+
+/// \brief Linear interpolation, with a different factor per lane.
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> mix(const scalar3_lanes<T, N>& a,
+                               const scalar3_lanes<T, N>& b,
+                               const scalar_lanes<T, N>&  u) noexcept {
+  const auto one_minus_u = scalar_lanes<T, N>{T(1)} - u;
+  return a * one_minus_u + b * u;
+}
+
+/// \brief Linear interpolation, with the same factor for all lanes.
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> mix(const scalar3_lanes<T, N>& a,
+                               const scalar3_lanes<T, N>& b,
+                               const T                    u) noexcept {
+  assert((u >= T(0)) && (u <= T(1)) &&
+         "Interpolation factor must be in the [0, 1] range!");
+  return mix(a, b, scalar_lanes<T, N>{u});
+}
+
+/// \brief Transforms N points (translation is applied).
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> mul_point(const scalar4x4<T>&        m,
+                                     const scalar3_lanes<T, N>& p) noexcept {
+  using lane_type = scalar_lanes<T, N>;
+
+  return {lane_type{m.a00} * p.x + lane_type{m.a01} * p.y +
+              lane_type{m.a02} * p.z + lane_type{m.a03},
+          lane_type{m.a10} * p.x + lane_type{m.a11} * p.y +
+              lane_type{m.a12} * p.z + lane_type{m.a13},
+          lane_type{m.a20} * p.x + lane_type{m.a21} * p.y +
+              lane_type{m.a22} * p.z + lane_type{m.a23}};
+}
+
+/// \brief Transforms N vectors (translation is ignored).
+template <typename T, size_t N>
+inline scalar3_lanes<T, N> mul_vec(const scalar4x4<T>&        m,
+                                   const scalar3_lanes<T, N>& v) noexcept {
+  using lane_type = scalar_lanes<T, N>;
+
+  return {lane_type{m.a00} * v.x + lane_type{m.a01} * v.y +
+              lane_type{m.a02} * v.z,
+          lane_type{m.a10} * v.x + lane_type{m.a11} * v.y +
+              lane_type{m.a12} * v.z,
+          lane_type{m.a20} * v.x + lane_type{m.a21} * v.y +
+              lane_type{m.a22} * v.z};
+}
+
+/// @}
+
+} // namespace math
+} // namespace xray
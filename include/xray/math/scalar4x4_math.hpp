@@ -32,6 +32,7 @@
 #include "xray/base/array_dimension.hpp"
 #include "xray/math/math_std.hpp"
 #include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
 #include "xray/math/scalar3x3.hpp"
 #include "xray/math/scalar4.hpp"
 #include "xray/math/scalar4x4.hpp"
@@ -86,16 +87,18 @@ scalar4x4<T> operator-(const scalar4x4<T>& mtx) noexcept {
   // clang-format on
 }
 
+/// \brief Matrix product. Each element is accumulated left to right
+/// (k = 0, 1, 2, 3), which is the same order the SIMD implementations use, so
+/// the scalar and vectorized versions produce identical results.
 template <typename T>
 scalar4x4<T> operator*(const scalar4x4<T>& lhs,
                        const scalar4x4<T>& rhs) noexcept {
-  auto result = scalar4x4<T>::stdc::null;
+  scalar4x4<T> result;
 
   for (size_t row = 0; row < 4; ++row) {
     for (size_t col = 0; col < 4; ++col) {
-      for (size_t k = 0; k < 4; ++k) {
-        result(row, col) += lhs(row, k) * rhs(k, col);
-      }
+      result(row, col) = lhs(row, 0) * rhs(0, col) + lhs(row, 1) * rhs(1, col) +
+                         lhs(row, 2) * rhs(2, col) + lhs(row, 3) * rhs(3, col);
     }
   }
 
@@ -121,6 +124,40 @@ scalar4x4<T> operator/(const scalar4x4<T>& mtx, const T k) noexcept {
   return result;
 }
 
+namespace detail {
+
+/// \brief 2x2 minors of a 4x4 matrix, used by the Laplace expansion.
+/// s[] are the minors formed with rows 0 and 1, c[] are the minors formed
+/// with rows 2 and 3 (each one having the same column pair as s[]).
+template <typename T>
+struct scalar4x4_minors {
+  T s[6];
+  T c[6];
+
+  explicit scalar4x4_minors(const scalar4x4<T>& m) noexcept {
+    s[0] = m.a00 * m.a11 - m.a10 * m.a01;
+    s[1] = m.a00 * m.a12 - m.a10 * m.a02;
+    s[2] = m.a00 * m.a13 - m.a10 * m.a03;
+    s[3] = m.a01 * m.a12 - m.a11 * m.a02;
+    s[4] = m.a01 * m.a13 - m.a11 * m.a03;
+    s[5] = m.a02 * m.a13 - m.a12 * m.a03;
+
+    c[0] = m.a20 * m.a31 - m.a30 * m.a21;
+    c[1] = m.a20 * m.a32 - m.a30 * m.a22;
+    c[2] = m.a20 * m.a33 - m.a30 * m.a23;
+    c[3] = m.a21 * m.a32 - m.a31 * m.a22;
+    c[4] = m.a21 * m.a33 - m.a31 * m.a23;
+    c[5] = m.a22 * m.a33 - m.a32 * m.a23;
+  }
+
+  T determinant() const noexcept {
+    return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] -
+           s[4] * c[1] + s[5] * c[0];
+  }
+};
+
+} // namespace detail
+
 template <typename T>
 T determinant(const scalar4x4<T>& m) noexcept {
   //
@@ -128,79 +165,100 @@ T determinant(const scalar4x4<T>& m) noexcept {
   // which states that the value of a determinant is equal to the product of
   // the minor determinants formed with the elements of p rows/columns and
   // their algebraic complements.
-  const auto k1 = m.a00 * m.a11 - m.a01 * m.a10;
-  const auto l1 = m.a22 * m.a33 - m.a23 * m.a32;
-
-  const auto k2 = m.a00 * m.a12 - m.a02 * m.a10;
-  const auto l2 = m.a21 * m.a33 - m.m.a12 * m.a31;
-
-  const auto k3 = m.a00 * m.a13 - m.a03 * m.a10;
-  const auto l3 = m.a21 * m.a32 - m.a22 * m.a31;
+  return detail::scalar4x4_minors<T>{m}.determinant();
+}
 
-  const auto k4 = m.a01 * m.a12 - m.a02 * m.a11;
-  const auto l4 = m.a20 * m.a33 - m.a32 * m.a30;
+template <typename T>
+inline bool is_invertible(const scalar4x4<T>& m) noexcept {
+  return !is_zero(determinant(m));
+}
 
-  const auto k5 = m.a01 * m.a13 - m.a03 * m.a11;
-  const auto l5 = m.a20 * m.a32 - m.a22 * m.a30;
+namespace detail {
 
-  const auto k6 = m.a02 * m.a13 - m.a03 * m.a12;
-  const auto l6 = m.a20 * m.a31 - m.a21 * m.a30;
+template <typename T>
+scalar4x4<T> adjoint_scaled(const scalar4x4<T>& m,
+                            const scalar4x4_minors<T>& mn,
+                            const T k) noexcept {
+  const T* s = mn.s;
+  const T* c = mn.c;
 
-  return k1 * l1 - k2 * l2 + k3 * l3 + k4 * l4 - k5 * l5 + k6 * l6;
+  // clang-format off
+  return {
+     (m.a11 * c[5] - m.a12 * c[4] + m.a13 * c[3]) * k,
+    -(m.a01 * c[5] - m.a02 * c[4] + m.a03 * c[3]) * k,
+     (m.a31 * s[5] - m.a32 * s[4] + m.a33 * s[3]) * k,
+    -(m.a21 * s[5] - m.a22 * s[4] + m.a23 * s[3]) * k,
+
+    -(m.a10 * c[5] - m.a12 * c[2] + m.a13 * c[1]) * k,
+     (m.a00 * c[5] - m.a02 * c[2] + m.a03 * c[1]) * k,
+    -(m.a30 * s[5] - m.a32 * s[2] + m.a33 * s[1]) * k,
+     (m.a20 * s[5] - m.a22 * s[2] + m.a23 * s[1]) * k,
+
+     (m.a10 * c[4] - m.a11 * c[2] + m.a13 * c[0]) * k,
+    -(m.a00 * c[4] - m.a01 * c[2] + m.a03 * c[0]) * k,
+     (m.a30 * s[4] - m.a31 * s[2] + m.a33 * s[0]) * k,
+    -(m.a20 * s[4] - m.a21 * s[2] + m.a23 * s[0]) * k,
+
+    -(m.a10 * c[3] - m.a11 * c[1] + m.a12 * c[0]) * k,
+     (m.a00 * c[3] - m.a01 * c[1] + m.a02 * c[0]) * k,
+    -(m.a30 * s[3] - m.a31 * s[1] + m.a32 * s[0]) * k,
+     (m.a20 * s[3] - m.a21 * s[1] + m.a22 * s[0]) * k
+  };
+  // clang-format on
 }
 
+} // namespace detail
+
 template <typename T>
-inline bool is_invertible(const scalar4x4<T>& m) noexcept {
-  return !is_zero(determinant(m));
+scalar4x4<T> adjoint(const scalar4x4<T>& m) noexcept {
+  return detail::adjoint_scaled(m, detail::scalar4x4_minors<T>{m}, T(1));
 }
 
+/// \brief Returns the inverse of a matrix. The matrix must be invertible.
 template <typename T>
 scalar4x4<T> invert(const scalar4x4<T>& m) noexcept {
-  const auto det = determinant(m);
+  const detail::scalar4x4_minors<T> mn{m};
+  const auto                         det = mn.determinant();
   assert(!is_zero(det));
 
-  return adjoint(m) / det;
+  return detail::adjoint_scaled(m, mn, T(1) / det);
 }
 
+/// \brief Returns the inverse of an affine transform (the last row must be
+/// [0 0 0 1]). The upper 3x3 part can be any invertible linear transform,
+/// including non uniform scaling. Cheaper than the general inverse.
 template <typename T>
-scalar4x4<T> adjoint(const scalar4x4<T>& m) noexcept {
+scalar4x4<T> affine_invert(const scalar4x4<T>& m) noexcept {
+  const scalar3<T> r0{m.a00, m.a01, m.a02};
+  const scalar3<T> r1{m.a10, m.a11, m.a12};
+  const scalar3<T> r2{m.a20, m.a21, m.a22};
 
-  const auto m1  = m.a22 * m.a33 - m.a23 * m.a32;
-  const auto m2  = m.a21 * m.a33 - m.a23 * m.a31;
-  const auto m3  = m.a21 * m.a32 - m.a22 * m.a31;
-  const auto m4  = m.a02 * m.a13 - m.a03 * m.a12;
-  const auto m5  = m.a01 * m.a13 - m.a03 * m.a11;
-  const auto m6  = m.a01 * m.a12 - m.a02 * m.a11;
-  const auto m7  = m.a20 * m.a33 - m.a23 * m.a30;
-  const auto m8  = m.a20 * m.a32 - m.a22 * m.a30;
-  const auto m9  = m.a12 * m.a33 - m.a13 * m.a32;
-  const auto m10 = m.a10 * m.a33 - m.a13 * m.a30;
-  const auto m11 = m.a10 * m.a32 - m.a12 * m.a30;
-  const auto m12 = m.a00 * m.a13 - m.a03 * m.a10;
-  const auto m13 = m.a00 * m.a12 - m.a02 * m.a10;
-  const auto m14 = m.a20 * m.a31 - m.a21 * m.a30;
-  const auto m15 = m.a00 * m.a11 - m.a01 * m.a10;
-  const auto m16 = m.a20 * m.a31 - m.a21 * m.a30;
-
-  return {m.a11 * m1 - m.a12 * m2 + m.a13 * m3,
-          -m.a01 * m1 + m.a02 * m2 - m.a03 * m3,
-          m.a31 * m4 - m.a32 * m5 + m.a33 * m6,
-          -m.a21 * m4 + m.a22 * m5 - m.a23 * m6,
-
-          -m.a10 * m1 + m.a12 * m7 - m.a13 * m8,
-          m.a00 * m1 - m.a02 * m7 + m.a03 * m8,
-          -m.a00 * m9 + m.a02 * m10 - m.a03 * m11,
-          m.a20 * m4 - m.a11 * m12 + m.a23 * m13,
-
-          m.a10 * m2 - m.a11 * m7 + m.a13 * m16,
-          -m.a00 * m2 + m.a01 * m7 - m.a03 * m16,
-          m.a30 * m5 - m.a31 * m12 + m.a33 * m15,
-          -m.a20 * m5 + m.a21 * m12 - m.a23 * m15,
-
-          -m.a10 * m3 + m.a11 * m8 - m.a12 * m14,
-          m.a00 * m3 - m.a01 * m8 + m.a02 * m14,
-          -m.a30 * m6 + m.a31 * m13 - m.a32 * m15,
-          m.a20 * m6 - m.a21 * m13 + m.a22 * m15};
+  //
+  // The columns of the inverse of the 3x3 part are the cross products of
+  // its rows, divided by the determinant.
+  const auto c0 = cross(r1, r2);
+  const auto c1 = cross(r2, r0);
+  const auto c2 = cross(r0, r1);
+
+  const auto det = dot(r0, c0);
+  assert(!is_zero(det));
+  const auto k = T(1) / det;
+
+  const scalar3<T> col0{c0.x * k, c0.y * k, c0.z * k};
+  const scalar3<T> col1{c1.x * k, c1.y * k, c1.z * k};
+  const scalar3<T> col2{c2.x * k, c2.y * k, c2.z * k};
+
+  // clang-format off
+  return {
+    col0.x, col1.x, col2.x,
+    -(col0.x * m.a03 + col1.x * m.a13 + col2.x * m.a23),
+    col0.y, col1.y, col2.y,
+    -(col0.y * m.a03 + col1.y * m.a13 + col2.y * m.a23),
+    col0.z, col1.z, col2.z,
+    -(col0.z * m.a03 + col1.z * m.a13 + col2.z * m.a23),
+    T(0), T(0), T(0), T(1)
+  };
+  // clang-format on
 }
 
 template <typename T>
@@ -256,3 +314,5 @@ scalar4<T> mul_hpoint(const scalar4x4<T>& m, const scalar4<T>& p) noexcept {
 
 } // namespace math
 } // namespace xray
+
+#include "xray/math/scalar4x4_math_simd.hpp"
@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file scalar4x4_math_batch.hpp
+/// \brief Transforms arrays of points/vectors by a single float4x4.
+/// Elements are processed native_float_lanes at a time (4 for SSE, 8 for
+/// AVX), using the structure of arrays types from scalar3_lanes.hpp. Inputs
+/// larger than batch_transform_parallel_threshold elements are split across
+/// TBB worker threads. Every lane computes the same
+/// expression as mul_point/mul_vec, so results match the per element
+/// functions exactly.
+
+#include "xray/xray.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_lanes.hpp"
+#include "xray/math/scalar3_lanes_math.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/scalar4x4_math.hpp"
+#include <cassert>
+#include <cstdint>
+#include <span.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief Inputs with at least this many elements are transformed in
+/// parallel.
+constexpr size_t batch_transform_parallel_threshold = 16384;
+
+/// @}
+
+namespace detail {
+
+template <bool is_point>
+void batch_transform_serial(const float4x4& m, const uint8_t* in,
+                            const size_t in_stride, uint8_t* out,
+                            const size_t out_stride,
+                            const size_t count) noexcept {
+  using lanes_type     = scalar3_lanes<float, native_float_lanes>;
+  constexpr auto width = native_float_lanes;
+
+  const size_t batched = count - count % width;
+  size_t       i       = 0;
+
+  for (; i < batched; i += width) {
+    const auto src = lanes_type::load(
+        reinterpret_cast<const float3*>(in + i * in_stride), in_stride);
+    const auto dst = is_point ? mul_point(m, src) : mul_vec(m, src);
+    dst.store(reinterpret_cast<float3*>(out + i * out_stride), out_stride);
+  }
+
+  for (; i < count; ++i) {
+    const auto src = reinterpret_cast<const float3*>(in + i * in_stride);
+    const auto dst = reinterpret_cast<float3*>(out + i * out_stride);
+    *dst           = is_point ? mul_point(m, *src) : mul_vec(m, *src);
+  }
+}
+
+template <bool is_point>
+void batch_transform(const float4x4& m, const void* in, const size_t in_stride,
+                     void* out, const size_t out_stride,
+                     const size_t count) noexcept {
+  assert(in_stride >= sizeof(float3));
+  assert(out_stride >= sizeof(float3));
+
+  const auto src = static_cast<const uint8_t*>(in);
+  const auto dst = static_cast<uint8_t*>(out);
+
+  if (count < batch_transform_parallel_threshold) {
+    batch_transform_serial<is_point>(m, src, in_stride, dst, out_stride,
+                                     count);
+    return;
+  }
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, count, batch_transform_parallel_threshold / 4},
+      [&m, src, in_stride, dst, out_stride](
+          const tbb::blocked_range<size_t>& rng) {
+        batch_transform_serial<is_point>(
+            m, src + rng.begin() * in_stride, in_stride,
+            dst + rng.begin() * out_stride, out_stride, rng.size());
+      });
+}
+
+} // namespace detail
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief  Transforms \a count points by \a m (the translation is applied).
+/// \param  in          Address of the first input point.
+/// \param  in_stride   Distance in bytes between two consecutive input points.
+/// \param  out         Address of the first output point. Can be the same as
+///                     \a in (in place transform), otherwise the ranges must
+///                     not overlap.
+/// \param  out_stride  Distance in bytes between two consecutive output points.
+/// \remarks Strided access allows transforming the position component of an
+///          interleaved vertex stream directly.
+inline void mul_point_n(const float4x4& m, const float3* in,
+                        const size_t in_stride, float3* out,
+                        const size_t out_stride, const size_t count) noexcept {
+  detail::batch_transform<true>(m, in, in_stride, out, out_stride, count);
+}
+
+/// \brief  Transforms \a count vectors by \a m (the translation is ignored).
+/// \see    mul_point_n
+inline void mul_vec_n(const float4x4& m, const float3* in,
+                      const size_t in_stride, float3* out,
+                      const size_t out_stride, const size_t count) noexcept {
+  detail::batch_transform<false>(m, in, in_stride, out, out_stride, count);
+}
+
+/// \brief  Transforms an array of points. Output must have at least as many
+///         elements as the input.
+inline void mul_point_n(const float4x4& m, gsl::span<const float3> in,
+                        gsl::span<float3> out) noexcept {
+  assert(out.size() >= in.size());
+  mul_point_n(m, in.data(), sizeof(float3), out.data(), sizeof(float3),
+              static_cast<size_t>(in.size()));
+}
+
+/// \brief  Transforms an array of points in place.
+inline void mul_point_n(const float4x4& m, gsl::span<float3> points) noexcept {
+  mul_point_n(m, points.data(), sizeof(float3), points.data(), sizeof(float3),
+              static_cast<size_t>(points.size()));
+}
+
+/// \brief  Transforms an array of vectors. Output must have at least as many
+///         elements as the input.
+inline void mul_vec_n(const float4x4& m, gsl::span<const float3> in,
+                      gsl::span<float3> out) noexcept {
+  assert(out.size() >= in.size());
+  mul_vec_n(m, in.data(), sizeof(float3), out.data(), sizeof(float3),
+            static_cast<size_t>(in.size()));
+}
+
+/// \brief  Transforms an array of vectors in place.
+inline void mul_vec_n(const float4x4& m, gsl::span<float3> vectors) noexcept {
+  mul_vec_n(m, vectors.data(), sizeof(float3), vectors.data(), sizeof(float3),
+            static_cast<size_t>(vectors.size()));
+}
+
+/// @}
+
+} // namespace math
+} // namespace xray
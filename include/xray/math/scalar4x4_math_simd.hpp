@@ -0,0 +1,287 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file scalar4x4_math_simd.hpp
+/// \brief SSE/AVX implementations of the float4x4 product, inverse, affine
+/// inverse and transpose. The overloads are selected at compile time (see
+/// simd_config.hpp) and are exact replacements for the generic versions in
+/// scalar4x4_math.hpp : every element is computed with the same operations,
+/// in the same order, so results are bit identical to the scalar code (as long
+/// as the compiler is not allowed to contract the scalar code into FMAs).
+
+#include "xray/xray.hpp"
+#include "xray/math/math_base.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/simd_config.hpp"
+#include <cassert>
+
+#if defined(XRAY_MATH_SIMD_SSE)
+
+namespace xray {
+namespace math {
+namespace detail {
+
+struct float4x4_rows {
+  __m128 r[4];
+
+  explicit float4x4_rows(const float4x4& m) noexcept {
+    r[0] = _mm_loadu_ps(m.components + 0);
+    r[1] = _mm_loadu_ps(m.components + 4);
+    r[2] = _mm_loadu_ps(m.components + 8);
+    r[3] = _mm_loadu_ps(m.components + 12);
+  }
+
+  float4x4_rows(const __m128 r0, const __m128 r1, const __m128 r2,
+                const __m128 r3) noexcept {
+    r[0] = r0;
+    r[1] = r1;
+    r[2] = r2;
+    r[3] = r3;
+  }
+
+  float4x4 store() const noexcept {
+    float4x4 result;
+    _mm_storeu_ps(result.components + 0, r[0]);
+    _mm_storeu_ps(result.components + 4, r[1]);
+    _mm_storeu_ps(result.components + 8, r[2]);
+    _mm_storeu_ps(result.components + 12, r[3]);
+    return result;
+  }
+};
+
+#define XRAY_MATH_SPLAT_PS(v, i)                                               \
+  _mm_shuffle_ps((v), (v), _MM_SHUFFLE((i), (i), (i), (i)))
+
+inline __m128 sign_flip_ps(const __m128 v, const __m128 sign_mask) noexcept {
+  return _mm_xor_ps(v, sign_mask);
+}
+
+/// \brief Returns the 2x2 minors formed by two rows (a, b) :
+/// lo = [m01, m02, m03, m12], hi = [m13, m23, ?, ?], with
+/// mij = a[i] * b[j] - b[i] * a[j].
+inline void row_minors(const __m128 a, const __m128 b, __m128* lo,
+                       __m128* hi) noexcept {
+  *lo = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 0, 0)),
+                 _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 2, 1))),
+      _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 0, 0)),
+                 _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 2, 1))));
+
+  *hi = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 2, 1)),
+                 _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3))),
+      _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 1, 2, 1)),
+                 _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+
+/// \brief x * p - y * q + z * r, evaluated left to right.
+inline __m128 cofactor_row(const __m128 x, const __m128 p, const __m128 y,
+                           const __m128 q, const __m128 z,
+                           const __m128 r) noexcept {
+  return _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, p), _mm_mul_ps(y, q)),
+                    _mm_mul_ps(z, r));
+}
+
+/// \brief a.yzx * b.zxy - a.zxy * b.yzx
+inline __m128 cross_ps(const __m128 a, const __m128 b) noexcept {
+  return _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)),
+                 _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2))),
+      _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)),
+                 _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))));
+}
+
+} // namespace detail
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+inline float4x4 operator*(const float4x4& lhs, const float4x4& rhs) noexcept {
+  const detail::float4x4_rows b{rhs};
+
+#if defined(XRAY_MATH_SIMD_AVX)
+
+  //
+  // Two rows of the result per register. Lane k of each 128 bit half of the
+  // left operand is broadcast and multiplied with row k of the right operand.
+  const __m256 b0 = _mm256_insertf128_ps(_mm256_castps128_ps256(b.r[0]), b.r[0], 1);
+  const __m256 b1 = _mm256_insertf128_ps(_mm256_castps128_ps256(b.r[1]), b.r[1], 1);
+  const __m256 b2 = _mm256_insertf128_ps(_mm256_castps128_ps256(b.r[2]), b.r[2], 1);
+  const __m256 b3 = _mm256_insertf128_ps(_mm256_castps128_ps256(b.r[3]), b.r[3], 1);
+
+  float4x4 result;
+
+  for (size_t i = 0; i < 2; ++i) {
+    const __m256 a = _mm256_loadu_ps(lhs.components + i * 8);
+
+    __m256 r = _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+    r        = _mm256_add_ps(
+        r, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+    r = _mm256_add_ps(
+        r, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+    r = _mm256_add_ps(
+        r, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+
+    _mm256_storeu_ps(result.components + i * 8, r);
+  }
+
+  return result;
+
+#else
+
+  const detail::float4x4_rows a{lhs};
+  detail::float4x4_rows       r{a};
+
+  for (size_t i = 0; i < 4; ++i) {
+    __m128 row = _mm_mul_ps(XRAY_MATH_SPLAT_PS(a.r[i], 0), b.r[0]);
+    row = _mm_add_ps(row, _mm_mul_ps(XRAY_MATH_SPLAT_PS(a.r[i], 1), b.r[1]));
+    row = _mm_add_ps(row, _mm_mul_ps(XRAY_MATH_SPLAT_PS(a.r[i], 2), b.r[2]));
+    row = _mm_add_ps(row, _mm_mul_ps(XRAY_MATH_SPLAT_PS(a.r[i], 3), b.r[3]));
+    r.r[i] = row;
+  }
+
+  return r.store();
+
+#endif
+}
+
+inline float4x4 transpose(const float4x4& m) noexcept {
+  detail::float4x4_rows t{m};
+  _MM_TRANSPOSE4_PS(t.r[0], t.r[1], t.r[2], t.r[3]);
+  return t.store();
+}
+
+inline float4x4 invert(const float4x4& m) noexcept {
+  const detail::float4x4_rows a{m};
+
+  //
+  // 2x2 minors of rows (0, 1) -> s, and rows (2, 3) -> c.
+  __m128 s_lo, s_hi, c_lo, c_hi;
+  detail::row_minors(a.r[0], a.r[1], &s_lo, &s_hi);
+  detail::row_minors(a.r[2], a.r[3], &c_lo, &c_hi);
+
+  alignas(16) float s[8];
+  alignas(16) float c[8];
+  _mm_store_ps(s, s_lo);
+  _mm_store_ps(s + 4, s_hi);
+  _mm_store_ps(c, c_lo);
+  _mm_store_ps(c + 4, c_hi);
+
+  const float det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] -
+                    s[4] * c[1] + s[5] * c[0];
+  assert(!is_zero(det));
+
+  //
+  // [c_k, c_k, s_k, s_k]
+  const __m128 cs5 = _mm_shuffle_ps(c_hi, s_hi, _MM_SHUFFLE(1, 1, 1, 1));
+  const __m128 cs4 = _mm_shuffle_ps(c_hi, s_hi, _MM_SHUFFLE(0, 0, 0, 0));
+  const __m128 cs3 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(3, 3, 3, 3));
+  const __m128 cs2 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(2, 2, 2, 2));
+  const __m128 cs1 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(1, 1, 1, 1));
+  const __m128 cs0 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(0, 0, 0, 0));
+
+  //
+  // Columns of the input, with the rows in the [1, 0, 3, 2] order.
+  detail::float4x4_rows t{a};
+  _MM_TRANSPOSE4_PS(t.r[0], t.r[1], t.r[2], t.r[3]);
+  const __m128 x0 = _mm_shuffle_ps(t.r[0], t.r[0], _MM_SHUFFLE(2, 3, 0, 1));
+  const __m128 x1 = _mm_shuffle_ps(t.r[1], t.r[1], _MM_SHUFFLE(2, 3, 0, 1));
+  const __m128 x2 = _mm_shuffle_ps(t.r[2], t.r[2], _MM_SHUFFLE(2, 3, 0, 1));
+  const __m128 x3 = _mm_shuffle_ps(t.r[3], t.r[3], _MM_SHUFFLE(2, 3, 0, 1));
+
+  const __m128 sign_pmpm = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+  const __m128 sign_mpmp = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+  const __m128 k         = _mm_set1_ps(1.0f / det);
+
+  using detail::cofactor_row;
+  using detail::sign_flip_ps;
+
+  return detail::float4x4_rows{
+      _mm_mul_ps(sign_flip_ps(cofactor_row(x1, cs5, x2, cs4, x3, cs3),
+                              sign_pmpm),
+                 k),
+      _mm_mul_ps(sign_flip_ps(cofactor_row(x0, cs5, x2, cs2, x3, cs1),
+                              sign_mpmp),
+                 k),
+      _mm_mul_ps(sign_flip_ps(cofactor_row(x0, cs4, x1, cs2, x3, cs0),
+                              sign_pmpm),
+                 k),
+      _mm_mul_ps(sign_flip_ps(cofactor_row(x0, cs3, x1, cs1, x2, cs0),
+                              sign_mpmp),
+                 k)}
+      .store();
+}
+
+inline float4x4 affine_invert(const float4x4& m) noexcept {
+  const detail::float4x4_rows a{m};
+
+  const __m128 c0 = detail::cross_ps(a.r[1], a.r[2]);
+  const __m128 c1 = detail::cross_ps(a.r[2], a.r[0]);
+  const __m128 c2 = detail::cross_ps(a.r[0], a.r[1]);
+
+  alignas(16) float r0[4];
+  alignas(16) float v0[4];
+  _mm_store_ps(r0, a.r[0]);
+  _mm_store_ps(v0, c0);
+
+  const float det = r0[0] * v0[0] + r0[1] * v0[1] + r0[2] * v0[2];
+  assert(!is_zero(det));
+  const __m128 k = _mm_set1_ps(1.0f / det);
+
+  __m128 col0 = _mm_mul_ps(c0, k);
+  __m128 col1 = _mm_mul_ps(c1, k);
+  __m128 col2 = _mm_mul_ps(c2, k);
+
+  //
+  // -(inv * t)
+  const __m128 t0 = XRAY_MATH_SPLAT_PS(_mm_set_ss(m.a03), 0);
+  const __m128 t1 = XRAY_MATH_SPLAT_PS(_mm_set_ss(m.a13), 0);
+  const __m128 t2 = XRAY_MATH_SPLAT_PS(_mm_set_ss(m.a23), 0);
+
+  __m128 tr = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(col0, t0), _mm_mul_ps(col1, t1)),
+      _mm_mul_ps(col2, t2));
+  tr = detail::sign_flip_ps(tr, _mm_set1_ps(-0.0f));
+
+  _MM_TRANSPOSE4_PS(col0, col1, col2, tr);
+
+  return detail::float4x4_rows{col0, col1, col2,
+                               _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f)}
+      .store();
+}
+
+/// @}
+
+#undef XRAY_MATH_SPLAT_PS
+
+} // namespace math
+} // namespace xray
+
+#endif /* XRAY_MATH_SIMD_SSE */
@@ -0,0 +1,539 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file scalar_lanes.hpp
+/// \brief A packet of N scalars, processed in lock step (one SIMD register
+/// when the instruction set supports it). This is the building block for the
+/// structure of arrays types (see scalar3_lanes.hpp).
+
+#include "xray/xray.hpp"
+#include "xray/math/simd_config.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+namespace xray {
+namespace math {
+
+/// \addtogroup __GroupXrayMath
+/// @{
+
+/// \brief Result of a lane wise comparison. Bit i is set if the comparison
+/// was true for lane i.
+template <typename T, size_t N>
+struct scalar_lanes_mask {
+  uint32_t bits;
+};
+
+/// \brief N values of type T, operated on lane wise.
+template <typename T, size_t N>
+struct scalar_lanes {
+  static_assert(N > 0 && N <= 32, "Unsupported lane count!");
+
+  using value_type = T;
+  using mask_type  = scalar_lanes_mask<T, N>;
+  static constexpr size_t lanes = N;
+
+  T v[N];
+
+  scalar_lanes() noexcept = default;
+
+  /// \brief Sets all lanes to the same value.
+  explicit scalar_lanes(const T val) noexcept {
+    for (size_t i = 0; i < N; ++i)
+      v[i] = val;
+  }
+
+  /// \brief Loads N consecutive values (no alignment requirement).
+  static scalar_lanes load(const T* src) noexcept {
+    scalar_lanes result;
+    for (size_t i = 0; i < N; ++i)
+      result.v[i] = src[i];
+    return result;
+  }
+
+  /// \brief Stores the lanes to N consecutive values.
+  void store(T* dst) const noexcept {
+    for (size_t i = 0; i < N; ++i)
+      dst[i] = v[i];
+  }
+
+  T operator[](const size_t lane) const noexcept {
+    assert(lane < N);
+    return v[lane];
+  }
+};
+
+template <typename T, size_t N>
+constexpr size_t scalar_lanes<T, N>::lanes;
+
+#define XRAY_MATH_LANES_BINARY_OP(op)                                          \
+  template <typename T, size_t N>                                              \
+  inline scalar_lanes<T, N> operator op(const scalar_lanes<T, N>& a,           \
+                                        const scalar_lanes<T, N>& b) noexcept {\
+    scalar_lanes<T, N> result;                                                 \
+    for (size_t i = 0; i < N; ++i)                                             \
+      result.v[i] = a.v[i] op b.v[i];                                          \
+    return result;                                                             \
+  }
+
+XRAY_MATH_LANES_BINARY_OP(+)
+XRAY_MATH_LANES_BINARY_OP(-)
+XRAY_MATH_LANES_BINARY_OP(*)
+XRAY_MATH_LANES_BINARY_OP(/)
+
+#undef XRAY_MATH_LANES_BINARY_OP
+
+#define XRAY_MATH_LANES_COMPARE_OP(op)                                         \
+  template <typename T, size_t N>                                              \
+  inline scalar_lanes_mask<T, N> operator op(                                  \
+      const scalar_lanes<T, N>& a, const scalar_lanes<T, N>& b) noexcept {     \
+    uint32_t bits = 0;                                                         \
+    for (size_t i = 0; i < N; ++i)                                             \
+      bits |= static_cast<uint32_t>(a.v[i] op b.v[i]) << i;                    \
+    return {bits};                                                             \
+  }
+
+XRAY_MATH_LANES_COMPARE_OP(<)
+XRAY_MATH_LANES_COMPARE_OP(<=)
+XRAY_MATH_LANES_COMPARE_OP(>)
+XRAY_MATH_LANES_COMPARE_OP(>=)
+
+#undef XRAY_MATH_LANES_COMPARE_OP
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> operator-(const scalar_lanes<T, N>& a) noexcept {
+  scalar_lanes<T, N> result;
+  for (size_t i = 0; i < N; ++i)
+    result.v[i] = -a.v[i];
+  return result;
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> min(const scalar_lanes<T, N>& a,
+                              const scalar_lanes<T, N>& b) noexcept {
+  scalar_lanes<T, N> result;
+  for (size_t i = 0; i < N; ++i)
+    result.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+  return result;
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> max(const scalar_lanes<T, N>& a,
+                              const scalar_lanes<T, N>& b) noexcept {
+  scalar_lanes<T, N> result;
+  for (size_t i = 0; i < N; ++i)
+    result.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+  return result;
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> sqrt(const scalar_lanes<T, N>& a) noexcept {
+  scalar_lanes<T, N> result;
+  for (size_t i = 0; i < N; ++i)
+    result.v[i] = std::sqrt(a.v[i]);
+  return result;
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> abs(const scalar_lanes<T, N>& a) noexcept {
+  scalar_lanes<T, N> result;
+  for (size_t i = 0; i < N; ++i)
+    result.v[i] = std::abs(a.v[i]);
+  return result;
+}
+
+/// \brief Picks lanes from \a a where the mask is set, from \a b otherwise.
+template <typename T, size_t N>
+inline scalar_lanes<T, N> select(const scalar_lanes_mask<T, N>& m,
+                                 const scalar_lanes<T, N>&      a,
+                                 const scalar_lanes<T, N>&      b) noexcept {
+  scalar_lanes<T, N> result;
+  for (size_t i = 0; i < N; ++i)
+    result.v[i] = (m.bits & (1u << i)) ? a.v[i] : b.v[i];
+  return result;
+}
+
+template <typename T, size_t N>
+inline scalar_lanes_mask<T, N>
+operator&(const scalar_lanes_mask<T, N>& a,
+          const scalar_lanes_mask<T, N>& b) noexcept {
+  return {a.bits & b.bits};
+}
+
+template <typename T, size_t N>
+inline scalar_lanes_mask<T, N>
+operator|(const scalar_lanes_mask<T, N>& a,
+          const scalar_lanes_mask<T, N>& b) noexcept {
+  return {a.bits | b.bits};
+}
+
+/// \brief Returns the mask as an integer, bit i corresponding to lane i.
+template <typename T, size_t N>
+inline uint32_t mask_bits(const scalar_lanes_mask<T, N>& m) noexcept {
+  return m.bits;
+}
+
+#if defined(XRAY_MATH_SIMD_SSE)
+
+template <>
+struct scalar_lanes_mask<float, 4> {
+  __m128 m;
+};
+
+template <>
+struct scalar_lanes<float, 4> {
+  using value_type = float;
+  using mask_type  = scalar_lanes_mask<float, 4>;
+  static constexpr size_t lanes = 4;
+
+  __m128 v;
+
+  scalar_lanes() noexcept = default;
+
+  explicit scalar_lanes(const float val) noexcept : v{_mm_set1_ps(val)} {}
+
+  explicit scalar_lanes(const __m128 r) noexcept : v{r} {}
+
+  static scalar_lanes load(const float* src) noexcept {
+    return scalar_lanes{_mm_loadu_ps(src)};
+  }
+
+  void store(float* dst) const noexcept { _mm_storeu_ps(dst, v); }
+
+  float operator[](const size_t lane) const noexcept {
+    assert(lane < 4);
+    alignas(16) float tmp[4];
+    _mm_store_ps(tmp, v);
+    return tmp[lane];
+  }
+};
+
+inline scalar_lanes<float, 4> operator+(const scalar_lanes<float, 4>& a,
+                                        const scalar_lanes<float, 4>& b) noexcept {
+  return scalar_lanes<float, 4>{_mm_add_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 4> operator-(const scalar_lanes<float, 4>& a,
+                                        const scalar_lanes<float, 4>& b) noexcept {
+  return scalar_lanes<float, 4>{_mm_sub_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 4> operator*(const scalar_lanes<float, 4>& a,
+                                        const scalar_lanes<float, 4>& b) noexcept {
+  return scalar_lanes<float, 4>{_mm_mul_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 4> operator/(const scalar_lanes<float, 4>& a,
+                                        const scalar_lanes<float, 4>& b) noexcept {
+  return scalar_lanes<float, 4>{_mm_div_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 4>
+operator-(const scalar_lanes<float, 4>& a) noexcept {
+  return scalar_lanes<float, 4>{_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))};
+}
+
+inline scalar_lanes_mask<float, 4>
+operator<(const scalar_lanes<float, 4>& a,
+          const scalar_lanes<float, 4>& b) noexcept {
+  return {_mm_cmplt_ps(a.v, b.v)};
+}
+
+inline scalar_lanes_mask<float, 4>
+operator<=(const scalar_lanes<float, 4>& a,
+           const scalar_lanes<float, 4>& b) noexcept {
+  return {_mm_cmple_ps(a.v, b.v)};
+}
+
+inline scalar_lanes_mask<float, 4>
+operator>(const scalar_lanes<float, 4>& a,
+          const scalar_lanes<float, 4>& b) noexcept {
+  return {_mm_cmpgt_ps(a.v, b.v)};
+}
+
+inline scalar_lanes_mask<float, 4>
+operator>=(const scalar_lanes<float, 4>& a,
+           const scalar_lanes<float, 4>& b) noexcept {
+  return {_mm_cmpge_ps(a.v, b.v)};
+}
+
+//
+// minps/maxps return the second operand when the comparison fails, just like
+// the a < b ? a : b expression used by the scalar min/max.
+inline scalar_lanes<float, 4> min(const scalar_lanes<float, 4>& a,
+                                  const scalar_lanes<float, 4>& b) noexcept {
+  return scalar_lanes<float, 4>{_mm_min_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 4> max(const scalar_lanes<float, 4>& a,
+                                  const scalar_lanes<float, 4>& b) noexcept {
+  return scalar_lanes<float, 4>{_mm_max_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 4> sqrt(const scalar_lanes<float, 4>& a) noexcept {
+  return scalar_lanes<float, 4>{_mm_sqrt_ps(a.v)};
+}
+
+inline scalar_lanes<float, 4> abs(const scalar_lanes<float, 4>& a) noexcept {
+  return scalar_lanes<float, 4>{_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+}
+
+inline scalar_lanes<float, 4> select(const scalar_lanes_mask<float, 4>& m,
+                                     const scalar_lanes<float, 4>&      a,
+                                     const scalar_lanes<float, 4>& b) noexcept {
+  return scalar_lanes<float, 4>{
+      _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v))};
+}
+
+inline scalar_lanes_mask<float, 4>
+operator&(const scalar_lanes_mask<float, 4>& a,
+          const scalar_lanes_mask<float, 4>& b) noexcept {
+  return {_mm_and_ps(a.m, b.m)};
+}
+
+inline scalar_lanes_mask<float, 4>
+operator|(const scalar_lanes_mask<float, 4>& a,
+          const scalar_lanes_mask<float, 4>& b) noexcept {
+  return {_mm_or_ps(a.m, b.m)};
+}
+
+inline uint32_t mask_bits(const scalar_lanes_mask<float, 4>& m) noexcept {
+  return static_cast<uint32_t>(_mm_movemask_ps(m.m));
+}
+
+#endif /* XRAY_MATH_SIMD_SSE */
+
+#if defined(XRAY_MATH_SIMD_AVX)
+
+template <>
+struct scalar_lanes_mask<float, 8> {
+  __m256 m;
+};
+
+template <>
+struct scalar_lanes<float, 8> {
+  using value_type = float;
+  using mask_type  = scalar_lanes_mask<float, 8>;
+  static constexpr size_t lanes = 8;
+
+  __m256 v;
+
+  scalar_lanes() noexcept = default;
+
+  explicit scalar_lanes(const float val) noexcept : v{_mm256_set1_ps(val)} {}
+
+  explicit scalar_lanes(const __m256 r) noexcept : v{r} {}
+
+  static scalar_lanes load(const float* src) noexcept {
+    return scalar_lanes{_mm256_loadu_ps(src)};
+  }
+
+  void store(float* dst) const noexcept { _mm256_storeu_ps(dst, v); }
+
+  float operator[](const size_t lane) const noexcept {
+    assert(lane < 8);
+    alignas(32) float tmp[8];
+    _mm256_store_ps(tmp, v);
+    return tmp[lane];
+  }
+};
+
+inline scalar_lanes<float, 8> operator+(const scalar_lanes<float, 8>& a,
+                                        const scalar_lanes<float, 8>& b) noexcept {
+  return scalar_lanes<float, 8>{_mm256_add_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 8> operator-(const scalar_lanes<float, 8>& a,
+                                        const scalar_lanes<float, 8>& b) noexcept {
+  return scalar_lanes<float, 8>{_mm256_sub_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 8> operator*(const scalar_lanes<float, 8>& a,
+                                        const scalar_lanes<float, 8>& b) noexcept {
+  return scalar_lanes<float, 8>{_mm256_mul_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 8> operator/(const scalar_lanes<float, 8>& a,
+                                        const scalar_lanes<float, 8>& b) noexcept {
+  return scalar_lanes<float, 8>{_mm256_div_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 8>
+operator-(const scalar_lanes<float, 8>& a) noexcept {
+  return scalar_lanes<float, 8>{_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f))};
+}
+
+inline scalar_lanes_mask<float, 8>
+operator<(const scalar_lanes<float, 8>& a,
+          const scalar_lanes<float, 8>& b) noexcept {
+  return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)};
+}
+
+inline scalar_lanes_mask<float, 8>
+operator<=(const scalar_lanes<float, 8>& a,
+           const scalar_lanes<float, 8>& b) noexcept {
+  return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)};
+}
+
+inline scalar_lanes_mask<float, 8>
+operator>(const scalar_lanes<float, 8>& a,
+          const scalar_lanes<float, 8>& b) noexcept {
+  return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)};
+}
+
+inline scalar_lanes_mask<float, 8>
+operator>=(const scalar_lanes<float, 8>& a,
+           const scalar_lanes<float, 8>& b) noexcept {
+  return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)};
+}
+
+inline scalar_lanes<float, 8> min(const scalar_lanes<float, 8>& a,
+                                  const scalar_lanes<float, 8>& b) noexcept {
+  return scalar_lanes<float, 8>{_mm256_min_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 8> max(const scalar_lanes<float, 8>& a,
+                                  const scalar_lanes<float, 8>& b) noexcept {
+  return scalar_lanes<float, 8>{_mm256_max_ps(a.v, b.v)};
+}
+
+inline scalar_lanes<float, 8> sqrt(const scalar_lanes<float, 8>& a) noexcept {
+  return scalar_lanes<float, 8>{_mm256_sqrt_ps(a.v)};
+}
+
+inline scalar_lanes<float, 8> abs(const scalar_lanes<float, 8>& a) noexcept {
+  return scalar_lanes<float, 8>{_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)};
+}
+
+inline scalar_lanes<float, 8> select(const scalar_lanes_mask<float, 8>& m,
+                                     const scalar_lanes<float, 8>&      a,
+                                     const scalar_lanes<float, 8>& b) noexcept {
+  return scalar_lanes<float, 8>{_mm256_blendv_ps(b.v, a.v, m.m)};
+}
+
+inline scalar_lanes_mask<float, 8>
+operator&(const scalar_lanes_mask<float, 8>& a,
+          const scalar_lanes_mask<float, 8>& b) noexcept {
+  return {_mm256_and_ps(a.m, b.m)};
+}
+
+inline scalar_lanes_mask<float, 8>
+operator|(const scalar_lanes_mask<float, 8>& a,
+          const scalar_lanes_mask<float, 8>& b) noexcept {
+  return {_mm256_or_ps(a.m, b.m)};
+}
+
+inline uint32_t mask_bits(const scalar_lanes_mask<float, 8>& m) noexcept {
+  return static_cast<uint32_t>(_mm256_movemask_ps(m.m));
+}
+
+#endif /* XRAY_MATH_SIMD_AVX */
+
+/// \name Operations with scalars and mask queries, common to all lane types.
+/// @{
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> operator*(const scalar_lanes<T, N>& a,
+                                    const T                   k) noexcept {
+  return a * scalar_lanes<T, N>{k};
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> operator*(const T                   k,
+                                    const scalar_lanes<T, N>& a) noexcept {
+  return scalar_lanes<T, N>{k} * a;
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> operator/(const scalar_lanes<T, N>& a,
+                                    const T                   k) noexcept {
+  return a / scalar_lanes<T, N>{k};
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> operator+(const scalar_lanes<T, N>& a,
+                                    const T                   k) noexcept {
+  return a + scalar_lanes<T, N>{k};
+}
+
+template <typename T, size_t N>
+inline scalar_lanes<T, N> operator-(const scalar_lanes<T, N>& a,
+                                    const T                   k) noexcept {
+  return a - scalar_lanes<T, N>{k};
+}
+
+/// \brief Restricts each lane to the [min_val, max_val] range.
+template <typename T, size_t N>
+inline scalar_lanes<T, N> clamp(const scalar_lanes<T, N>& val,
+                                const scalar_lanes<T, N>& min_val,
+                                const scalar_lanes<T, N>& max_val) noexcept {
+  return min(max(val, min_val), max_val);
+}
+
+/// \brief Lane wise linear interpolation. Factors must be in the [0, 1] range.
+template <typename T, size_t N>
+inline scalar_lanes<T, N> mix(const scalar_lanes<T, N>& a,
+                              const scalar_lanes<T, N>& b,
+                              const scalar_lanes<T, N>& u) noexcept {
+  return a * (scalar_lanes<T, N>{T(1)} - u) + b * u;
+}
+
+template <typename T, size_t N>
+inline bool any(const scalar_lanes_mask<T, N>& m) noexcept {
+  return mask_bits(m) != 0;
+}
+
+template <typename T, size_t N>
+inline bool all(const scalar_lanes_mask<T, N>& m) noexcept {
+  return mask_bits(m) == ((N == 32) ? ~0u : ((1u << N) - 1));
+}
+
+template <typename T, size_t N>
+inline bool none(const scalar_lanes_mask<T, N>& m) noexcept {
+  return mask_bits(m) == 0;
+}
+
+/// @}
+
+using float_x4 = scalar_lanes<float, 4>;
+using float_x8 = scalar_lanes<float, 8>;
+
+/// \brief Number of float lanes in a native SIMD register.
+#if defined(XRAY_MATH_SIMD_AVX)
+constexpr size_t native_float_lanes = 8;
+#else
+constexpr size_t native_float_lanes = 4;
+#endif
+
+/// @}
+
+} // namespace math
+} // namespace xray
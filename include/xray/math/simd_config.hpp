@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file simd_config.hpp
+/// \brief Selects the SIMD instruction set used by the math library.
+/// The selection is done at compile time, based on the target architecture
+/// flags passed to the compiler. Define XRAY_MATH_NO_SIMD to force the
+/// scalar code paths.
+
+#include "xray/xray.hpp"
+
+#if defined(XRAY_MATH_SIMD_SSE)
+#undef XRAY_MATH_SIMD_SSE
+#endif
+
+#if defined(XRAY_MATH_SIMD_AVX)
+#undef XRAY_MATH_SIMD_AVX
+#endif
+
+#if !defined(XRAY_MATH_NO_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define XRAY_MATH_SIMD_SSE
+#endif
+
+#if defined(XRAY_MATH_SIMD_SSE) && defined(__AVX__)
+#define XRAY_MATH_SIMD_AVX
+#endif
+
+#endif /* !XRAY_MATH_NO_SIMD */
+
+#if defined(XRAY_MATH_SIMD_AVX)
+#include <immintrin.h>
+#elif defined(XRAY_MATH_SIMD_SSE)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
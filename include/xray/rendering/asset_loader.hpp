@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+/// \file   asset_loader.hpp    Background loading of meshes and textures.
+
+#include "xray/xray.hpp"
+#include "xray/rendering/mesh.hpp"
+#include "xray/rendering/opengl/gl_handles.hpp"
+#include "xray/rendering/texture_loader.hpp"
+#include "xray/rendering/vertex_format/vertex_format.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <tbb/concurrent_queue.h>
+#include <tbb/task_group.h>
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+enum class asset_state : uint8_t { loading, resident, failed };
+
+struct async_mesh_handle {
+  uint32_t id;
+};
+
+struct async_texture_handle {
+  uint32_t id;
+};
+
+/// \brief  Loads meshes and textures without stalling the render thread.
+///         Files are parsed and decoded (Assimp, stb) on TBB worker
+///         threads. The GL objects are created on the render thread by
+///         process_uploads(), a few per frame, within a time budget. Until
+///         an asset is resident a placeholder is returned in its place
+///         (a cube for meshes, a grey texel for textures).
+///
+///         All member functions must be called on the render thread.
+class asset_loader {
+public:
+  static constexpr float default_upload_budget_ms = 2.0f;
+
+  /// \brief  Needs a current GL context (creates the placeholder texture).
+  asset_loader();
+
+  /// \brief  Waits for the jobs still running.
+  ~asset_loader();
+
+  async_mesh_handle load_mesh(
+      const vertex_format fmt, const char* file_path,
+      const uint32_t load_options = mesh_load_option::remove_points_lines);
+
+  async_mesh_handle load_mesh(
+      const vertex_format fmt, const std::string& file_path,
+      const uint32_t load_options = mesh_load_option::remove_points_lines) {
+    return load_mesh(fmt, file_path.c_str(), load_options);
+  }
+
+  async_texture_handle
+  load_texture(const char*                file_path,
+               const texture_load_options opts = texture_load_options::none);
+
+  async_texture_handle
+  load_texture(const std::string&         file_path,
+               const texture_load_options opts = texture_load_options::none) {
+    return load_texture(file_path.c_str(), opts);
+  }
+
+  /// \brief  Creates the GL objects of loaded assets until the budget is
+  ///         used up. At least one asset is uploaded per call, if any is
+  ///         ready.
+  /// \returns Number of assets uploaded.
+  size_t process_uploads(const float budget_ms = default_upload_budget_ms);
+
+  /// \brief  Blocks until every asset is loaded and uploaded.
+  void finish();
+
+  /// \brief  Number of assets not yet resident (or failed).
+  size_t pending() const noexcept { return _pending; }
+
+  asset_state state(const async_mesh_handle mh) const noexcept {
+    return _meshes[mh.id].state;
+  }
+
+  asset_state state(const async_texture_handle th) const noexcept {
+    return _textures[th.id].state;
+  }
+
+  /// \brief  The mesh, or a placeholder in the same vertex format while it
+  ///         is loading (and if it failed to load).
+  simple_mesh& mesh(const async_mesh_handle mh);
+
+  /// \brief  The texture, or the placeholder texture while it is loading
+  ///         (and if it failed to load).
+  GLuint texture(const async_texture_handle th) const noexcept;
+
+private:
+  struct pending_upload;
+
+  void upload(pending_upload& job);
+
+  struct mesh_slot {
+    vertex_format fmt{vertex_format::undefined};
+    asset_state   state{asset_state::loading};
+    simple_mesh   mesh;
+  };
+
+  struct texture_slot {
+    asset_state    state{asset_state::loading};
+    scoped_texture texture;
+  };
+
+  std::deque<mesh_slot>    _meshes;
+  std::deque<texture_slot> _textures;
+
+  ///< One placeholder cube per vertex format, created on first use.
+  std::deque<mesh_slot> _placeholder_meshes;
+  scoped_texture        _placeholder_texture;
+
+  ///< Jobs finished by the workers, waiting for their GL objects.
+  tbb::concurrent_queue<pending_upload*> _completed;
+  tbb::task_group                        _jobs;
+  size_t                                 _pending{0};
+
+private:
+  XRAY_NO_COPY(asset_loader);
+};
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
@@ -40,6 +40,8 @@ class camera;
 
 namespace rendering {
 
+class uniform_ring_buffer;
+
 struct draw_context_t {
   uint32_t             window_width;
   uint32_t             window_height;
@@ -48,6 +50,7 @@ struct draw_context_t {
   math::float4x4       proj_view_matrix;
   const scene::camera* active_camera;
   void*                renderer;
+  uniform_ring_buffer* uniform_ring{nullptr};
 };
 
 } // namespace rendering
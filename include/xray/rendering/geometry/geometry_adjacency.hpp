@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_adjacency.hpp    Vertex to face adjacency for indexed
+///         triangle lists.
+
+#include "xray/xray.hpp"
+#include <cassert>
+#include <cstdint>
+#include <span.h>
+#include <vector>
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Faces incident to each vertex of an indexed triangle list, in
+///         compressed sparse row form : the faces of vertex v are
+///         faces[offsets[v]] ... faces[offsets[v + 1] - 1], in increasing
+///         order. A face index f refers to indices 3f, 3f + 1, 3f + 2.
+struct vertex_face_adjacency {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> faces;
+
+  size_t vertex_count() const noexcept {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+
+  gsl::span<const uint32_t> faces_of(const uint32_t vertex) const noexcept {
+    assert(vertex < vertex_count());
+    return {faces.data() + offsets[vertex],
+            static_cast<ptrdiff_t>(offsets[vertex + 1] - offsets[vertex])};
+  }
+};
+
+/// \brief  Builds the vertex to face adjacency of a triangle list.
+/// \param  indices       Triangle list, must hold a multiple of 3 indices.
+/// \param  vertex_count  Number of vertices referenced by the list.
+/// \param  base_vertex   Value subtracted from every index (first vertex of
+///                       a submesh whose indices are not zero based).
+inline void build_vertex_face_adjacency(gsl::span<const uint32_t> indices,
+                                        const size_t              vertex_count,
+                                        const uint32_t            base_vertex,
+                                        vertex_face_adjacency*    adj) {
+  assert(adj != nullptr);
+  assert((indices.size() % 3) == 0);
+
+  //
+  //  Two linear passes over the index buffer : count the faces of each
+  //  vertex, prefix sum the counts, then fill. Filling in face order keeps
+  //  the face list of every vertex sorted.
+  adj->offsets.assign(vertex_count + 1, 0);
+  adj->faces.resize(static_cast<size_t>(indices.size()));
+
+  for (const auto idx : indices) {
+    assert(idx - base_vertex < vertex_count);
+    ++adj->offsets[idx - base_vertex + 1];
+  }
+
+  for (size_t v = 0; v < vertex_count; ++v) {
+    adj->offsets[v + 1] += adj->offsets[v];
+  }
+
+  std::vector<uint32_t> cursor{adj->offsets.begin(), adj->offsets.end() - 1};
+  const auto face_count = static_cast<uint32_t>(indices.size() / 3);
+
+  for (uint32_t f = 0; f < face_count; ++f) {
+    for (uint32_t c = 0; c < 3; ++c) {
+      const auto v = indices[f * 3 + c] - base_vertex;
+      adj->faces[cursor[v]++] = f;
+    }
+  }
+}
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
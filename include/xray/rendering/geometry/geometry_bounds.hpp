@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_bounds.hpp    Bounding volumes for vertex streams.
+
+#include "xray/xray.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/bounds_batch.hpp"
+#include "xray/math/sphere.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <cassert>
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Computes the bounding box and sphere of \a count vertices,
+///         starting at \a first.
+inline void compute_vertex_bounds(const vertex_pntt* first, const size_t count,
+                                  math::aabb3f*   bounding_box,
+                                  math::sphere3f* bounding_sphere) noexcept {
+  assert(bounding_box != nullptr);
+  assert(bounding_sphere != nullptr);
+
+  *bounding_box = math::compute_aabb(&first->position, sizeof(vertex_pntt),
+                                     count);
+  *bounding_sphere = math::compute_bounding_sphere(
+      &first->position, sizeof(vertex_pntt), count, *bounding_box);
+}
+
+/// \brief  Fills in the bounds of every submesh and of the whole mesh.
+/// \remarks Called by geometry_factory after a shape is generated or a model
+///          is imported. Call it again after modifying vertex positions.
+inline void compute_bounds(geometry_data_t* mesh) noexcept {
+  assert(mesh != nullptr);
+
+  const auto vertices = base::raw_ptr(mesh->geometry);
+
+  for (auto& sm : mesh->submeshes) {
+    assert(sm.base_vertex + sm.vertex_count <= mesh->vertex_count);
+    compute_vertex_bounds(vertices + sm.base_vertex, sm.vertex_count,
+                          &sm.bounding_box, &sm.bounding_sphere);
+  }
+
+  compute_vertex_bounds(vertices, mesh->vertex_count, &mesh->bounding_box,
+                        &mesh->bounding_sphere);
+}
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
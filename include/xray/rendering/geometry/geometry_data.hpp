@@ -32,9 +32,13 @@
 
 #include "xray/xray.hpp"
 #include "xray/base/unique_pointer.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/sphere.hpp"
 #include "xray/rendering/vertex_format/vertex_pntt.hpp"
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace xray {
 namespace rendering {
@@ -42,6 +46,32 @@ namespace rendering {
 /// \addtogroup __GroupXrayRendering
 /// @{
 
+/// \brief  A contiguous range of vertices and indices inside a
+///         geometry_data_t (one imported mesh of a model file).
+///         Indices are absolute : base_vertex is already added to them.
+struct geometry_submesh {
+  uint32_t       base_vertex{0};
+  uint32_t       vertex_count{0};
+  uint32_t       index_offset{0};
+  uint32_t       index_count{0};
+
+  ///< Index of the material in the model file (aiMesh::mMaterialIndex).
+  uint32_t       material_index{0};
+  math::aabb3f   bounding_box{math::aabb3f::stdc::empty};
+  math::sphere3f bounding_sphere{math::float3::stdc::zero, 0.0f};
+};
+
+/// \brief  One level of detail : a range of the index buffer drawing a
+///         simplified version of the mesh with the same vertices.
+struct geometry_lod {
+  uint32_t index_offset{0};
+  uint32_t index_count{0};
+
+  ///< Largest distance between the simplified and the original surface, in
+  ///< object space units. Zero for the full detail level.
+  float error{0.0f};
+};
+
 ///     Stores geometry data (vertices and conectivity information).
 struct geometry_data_t {
   template <typename vector_type>
@@ -61,6 +91,10 @@ struct geometry_data_t {
     geometry =
         scoped_vector_array_t<vertex_pntt>{new vertex_pntt[num_vertices]};
     indices = scoped_vector_array_t<uint32_t>{new uint32_t[num_indices]};
+    bounding_box    = math::aabb3f::stdc::empty;
+    bounding_sphere = math::sphere3f{math::float3::stdc::zero, 0.0f};
+    submeshes.clear();
+    lods.clear();
   }
 
   size_type                          vertex_count{0};
@@ -68,6 +102,18 @@ struct geometry_data_t {
   scoped_vector_array_t<vertex_pntt> geometry;
   scoped_vector_array_t<uint32_t>    indices;
 
+  ///< Bounds of all the vertices, filled by compute_bounds().
+  math::aabb3f   bounding_box{math::aabb3f::stdc::empty};
+  math::sphere3f bounding_sphere{math::float3::stdc::zero, 0.0f};
+
+  ///< Empty for generated shapes, one entry per mesh for imported models.
+  std::vector<geometry_submesh> submeshes;
+
+  ///< Empty, or the levels of detail from finest (lods[0], the original
+  ///< triangles) to coarsest, see generate_lods(). Submesh index ranges
+  ///< refer to lods[0].
+  std::vector<geometry_lod> lods;
+
 private:
   XRAY_NO_COPY(geometry_data_t);
 };
@@ -48,7 +48,13 @@ enum class mesh_import_options : uint16_t {
   convert_left_handed = 1U << 0,
 
   ///< Remove any points and lines from the mesh (leaving only triangles/quads)
-  remove_points_lines = 1U << 1
+  remove_points_lines = 1U << 1,
+
+  ///< Import profile (see mesh_import_profile.hpp). Without one, the default
+  ///< profile of the application is used.
+  profile_fast     = 1U << 2,
+  profile_balanced = 1U << 3,
+  profile_full     = 1U << 4
 };
 
 inline constexpr mesh_import_options
@@ -135,6 +141,14 @@ public:
   //                                    const uint32_t   tess_factor_vert,
   //                                    geometry_data_t* mesh);
 
+  /// Highest subdivision level accepted by geosphere().
+  static constexpr uint32_t geosphere_max_subdivisions = 8;
+
+  /// Creates a sphere, centered at the origin, by repeatedly subdividing an
+  /// icosahedron. Vertices on shared edges are shared, so level L has
+  /// 10 * 4^L + 2 vertices and 20 * 4^L faces.
+  /// \param  max_subdivisions    Subdivision level, clamped to
+  ///         geosphere_max_subdivisions.
   static void geosphere(const float radius, const uint32_t max_subdivisions,
                         geometry_data_t* mesh);
 
@@ -145,6 +159,10 @@ public:
   /// space.
   static void fullscreen_quad(geometry_data_t* grid_geometry);
 
+  /// Imports a model file. OBJ and PLY files are read by the native
+  /// parsers (see geometry_import_native.hpp), other formats by Assimp.
+  /// The result is kept in the binary mesh cache (see mesh_cache.hpp) and
+  /// read from it while the file is unchanged.
   static bool
   load_model(geometry_data_t* mesh, const char* file_path,
              const mesh_import_options import_opts = mesh_import_options::none);
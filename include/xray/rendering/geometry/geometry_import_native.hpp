@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_import_native.hpp    Multithreaded OBJ and PLY readers.
+
+#include "xray/xray.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace xray {
+namespace rendering {
+
+struct geometry_data_t;
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Model formats that are read without going through Assimp.
+enum class native_model_format : uint8_t { none, obj, ply };
+
+/// \brief  Returns the native format matching the extension of the file
+///         (case insensitive), or native_model_format::none.
+native_model_format native_model_format_from_path(const char* path) noexcept;
+
+/// \brief  Properties of a model read by import_native_model().
+struct native_import_info {
+  ///< True when every vertex has a normal from the file.
+  bool has_normals{false};
+
+  ///< True when every vertex has texture coordinates from the file.
+  bool has_texcoords{false};
+};
+
+/// \brief  Reads a Wavefront OBJ or a PLY model from memory, straight into
+///         a geometry_data_t with a single submesh.
+///         Polygons are split into triangle fans, point and line elements are
+///         skipped. Missing texture coordinates are set to (0.5, 0.5),
+///         missing normals and all the tangents are left zeroed.
+///         OBJ : the text is split into chunks of whole lines, parsed in
+///         parallel. Negative (relative) indices are supported. Identical
+///         position/texcoord/normal index tuples share one vertex, vertices
+///         are numbered in the order they are first used. Groups, materials
+///         and smoothing groups are ignored.
+///         PLY : ascii, binary_little_endian and binary_big_endian. Vertex
+///         elements must have fixed size properties (x, y, z and optionally
+///         nx, ny, nz and u, v / s, t / texture_u, texture_v). Faces are
+///         read from the vertex_indices (or vertex_index) list property;
+///         binary files with triangles only are converted in parallel.
+/// \returns False if the data is malformed or uses an unsupported feature;
+///          the mesh is left in an unspecified state.
+bool import_native_model(const void* data, const size_t size,
+                         const native_model_format fmt, geometry_data_t* mesh,
+                         native_import_info* info);
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_meshlet.hpp    Splits meshes into small clusters of
+///         triangles (meshlets) that can be culled individually.
+
+#include "xray/xray.hpp"
+#include "xray/math/frustum.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/sphere.hpp"
+#include <cstdint>
+#include <span.h>
+#include <vector>
+
+namespace xray {
+namespace rendering {
+
+struct geometry_data_t;
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// Limits used by build_meshlets() when none are given. Small enough that
+/// local vertex indices fit in a byte and that a meshlet maps to one mesh
+/// shader workgroup.
+constexpr uint32_t default_meshlet_max_vertices  = 64;
+constexpr uint32_t default_meshlet_max_triangles = 124;
+
+/// \brief  A cluster of triangles. Its vertices are
+///         meshlet_data::vertices[vertex_offset ... vertex_offset +
+///         vertex_count - 1] (indices into the vertex buffer of the mesh);
+///         its triangles are triplets of local vertex numbers in
+///         meshlet_data::triangles, starting at 3 * triangle_offset.
+struct meshlet {
+  uint32_t vertex_offset{0};
+  uint32_t triangle_offset{0};
+  uint32_t vertex_count{0};
+  uint32_t triangle_count{0};
+};
+
+/// \brief  Normal cone of a meshlet. Every triangle of the meshlet faces
+///         away from any viewer for which
+///         dot(normalize(apex - eye), axis) >= cutoff.
+///         A cutoff of 1 disables the test (the normals spread too much).
+struct meshlet_cone {
+  math::float3 apex;
+  math::float3 axis;
+  float        cutoff;
+};
+
+/// \brief  Meshlets of a mesh, with their bounds. All arrays are contiguous
+///         and ordered by meshlet so they can be streamed or uploaded as is;
+///         spheres and cones are kept apart from the meshlets so that the
+///         spheres can be frustum culled in batches.
+struct meshlet_data {
+  std::vector<meshlet>        meshlets;
+  std::vector<math::sphere3f> spheres;
+  std::vector<meshlet_cone>   cones;
+  std::vector<uint32_t>       vertices;
+  std::vector<uint8_t>        triangles;
+
+  ///< Meshlets of submesh i are submesh_offsets[i] ...
+  ///< submesh_offsets[i + 1] - 1. A mesh without submeshes is treated as a
+  ///< single submesh.
+  std::vector<uint32_t> submesh_offsets;
+
+  size_t meshlet_count() const noexcept { return meshlets.size(); }
+};
+
+/// \brief  Partitions the triangles of a mesh into meshlets of at most
+///         \a max_vertices vertices and \a max_triangles triangles. Meshlets
+///         do not span submeshes. Triangles are grown into a meshlet from
+///         its neighbours, so meshes ordered by optimize_vertex_cache()
+///         yield the most compact meshlets.
+/// \remarks Only the full detail triangles (lods[0]) are clustered.
+void build_meshlets(const geometry_data_t& mesh, meshlet_data* meshlets,
+                    const uint32_t max_vertices  = default_meshlet_max_vertices,
+                    const uint32_t max_triangles = default_meshlet_max_triangles);
+
+/// \brief  Culls the meshlets of a mesh against a view frustum and against
+///         their normal cones, and writes the triangles of the surviving
+///         ones into an index list that can be drawn with the vertex buffer
+///         of the mesh. The scratch buffers are kept between calls, so a
+///         culler reused every frame does not allocate.
+class meshlet_culler {
+public:
+  /// \param  frustum   View frustum, in the object space of the mesh.
+  /// \param  eye_pos   Position of the viewer, in the object space of the
+  ///                   mesh.
+  /// \returns Number of indices in indices().
+  size_t cull(const meshlet_data& meshlets, const math::frustum3f& frustum,
+              const math::float3& eye_pos);
+
+  /// \brief  Index list built by the last call to cull().
+  gsl::span<const uint32_t> indices() const noexcept {
+    return {_indices.data(), static_cast<ptrdiff_t>(_index_count)};
+  }
+
+  /// \brief  Number of meshlets that passed the last call to cull().
+  size_t visible_meshlets() const noexcept { return _visible.size(); }
+
+private:
+  std::vector<uint32_t> _visibility_mask;
+  std::vector<uint32_t> _visible;
+  std::vector<uint32_t> _offsets;
+  std::vector<uint32_t> _indices;
+  size_t                _index_count{0};
+};
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
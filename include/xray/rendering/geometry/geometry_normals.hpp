@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_normals.hpp    Recomputes vertex normals and tangents.
+
+#include "xray/xray.hpp"
+#include "xray/rendering/geometry/geometry_adjacency.hpp"
+#include <cstdint>
+
+namespace xray {
+namespace rendering {
+
+struct geometry_data_t;
+struct geometry_submesh;
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  How the normals of the faces sharing a vertex are blended.
+enum class normal_weighting : uint8_t {
+  ///< Every face counts the same.
+  uniform,
+
+  ///< Faces are weighted by their area.
+  area,
+
+  ///< Faces are weighted by the angle of the corner at the vertex. Gives
+  ///< results that do not depend on how the surface is triangulated.
+  angle
+};
+
+/// \brief  Recomputes the normals of all the vertices of a mesh as the
+///         weighted average of the normals of the faces sharing them.
+/// \param  adjacency   Vertex to face adjacency of the mesh. When null it is
+///                     built internally; pass it in to share it with
+///                     compute_tangents().
+/// \remarks Each vertex gathers from its own faces, so the work is split
+///          across TBB worker threads with no write conflicts and the
+///          result does not depend on the number of threads.
+void compute_normals(
+    geometry_data_t*             mesh,
+    const normal_weighting       weighting = normal_weighting::area,
+    const vertex_face_adjacency* adjacency = nullptr);
+
+/// \brief  Recomputes the normals of the vertices of a single submesh.
+void compute_normals(
+    geometry_data_t* mesh, const geometry_submesh& submesh,
+    const normal_weighting       weighting = normal_weighting::area,
+    const vertex_face_adjacency* adjacency = nullptr);
+
+/// \brief  Recomputes the tangents (direction of increasing u) from the
+///         positions and texture coordinates. Normals must be valid, the
+///         tangents are made orthogonal to them.
+void compute_tangents(geometry_data_t*             mesh,
+                      const vertex_face_adjacency* adjacency = nullptr);
+
+void compute_tangents(geometry_data_t* mesh, const geometry_submesh& submesh,
+                      const vertex_face_adjacency* adjacency = nullptr);
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_optimize.hpp    Reorders triangles and vertices for the
+///         post-transform vertex cache, overdraw and vertex fetch.
+
+#include "xray/xray.hpp"
+#include <cstdint>
+#include <span.h>
+
+namespace xray {
+namespace rendering {
+
+struct geometry_data_t;
+struct vertex_pntt;
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Post-transform vertex cache efficiency of an index buffer, as
+///         measured by a FIFO cache simulation.
+struct vertex_cache_stats {
+  uint32_t triangles{0};
+
+  ///< Number of distinct vertices referenced by the triangles.
+  uint32_t vertices{0};
+
+  ///< Number of vertex shader invocations (cache misses).
+  uint32_t vertices_transformed{0};
+
+  ///< Average cache miss ratio : transformed vertices per triangle. Ranges
+  ///< from 3 (no reuse) to about 0.5 for large regular meshes.
+  float acmr{0.0f};
+
+  ///< Average transform to vertex ratio : transformed vertices per distinct
+  ///< vertex. 1 is optimal.
+  float atvr{0.0f};
+};
+
+/// Cache size used by analyze_vertex_cache() when none is given. Close to
+/// the effective post-transform cache of current GPUs.
+constexpr uint32_t default_vertex_cache_size = 16;
+
+/// \brief  Simulates a FIFO post-transform cache over a triangle list.
+/// \param  base_vertex   Value subtracted from every index.
+vertex_cache_stats
+analyze_vertex_cache(gsl::span<const uint32_t> indices,
+                     const size_t vertex_count, const uint32_t base_vertex = 0,
+                     const uint32_t cache_size = default_vertex_cache_size);
+
+/// \brief  Cache statistics of a whole mesh.
+vertex_cache_stats
+analyze_vertex_cache(const geometry_data_t& mesh,
+                     const uint32_t cache_size = default_vertex_cache_size);
+
+/// \brief  Reorders the triangles of a list to maximize post-transform
+///         cache hits (Forsyth, "Linear-Speed Vertex Cache Optimisation").
+///         Vertices are not modified.
+void optimize_vertex_cache(gsl::span<uint32_t> indices,
+                           const size_t        vertex_count,
+                           const uint32_t      base_vertex = 0);
+
+/// \brief  Reorders groups of triangles so that the ones facing away from
+///         the center of the mesh are drawn first, reducing overdraw. The
+///         index list should be optimized with optimize_vertex_cache()
+///         first; clusters are cut where doing so keeps the ACMR within
+///         \a threshold times its original value (1.05 allows a 5% loss).
+/// \param  vertices  First vertex referenced by the list (the vertex at
+///                   \a base_vertex).
+void optimize_overdraw(gsl::span<uint32_t> indices,
+                       const vertex_pntt* vertices, const size_t vertex_count,
+                       const uint32_t base_vertex = 0,
+                       const float    threshold   = 1.05f);
+
+/// \brief  Reorders vertices in the order they are first referenced by the
+///         index list, and remaps the indices. Vertices that are not
+///         referenced end up at the back.
+void optimize_vertex_fetch(gsl::span<uint32_t> indices, vertex_pntt* vertices,
+                           const size_t   vertex_count,
+                           const uint32_t base_vertex = 0);
+
+/// \brief  Runs vertex cache, overdraw and vertex fetch optimization on every
+///         submesh of the mesh (or on the whole mesh when it has no
+///         submeshes). Submeshes are processed in parallel; their vertex and
+///         index ranges are preserved.
+/// \remarks Vertex order changes, so anything relying on the layout produced
+///          by geometry_factory (e.g. grid rows) must not call this.
+void optimize_geometry(geometry_data_t* mesh,
+                       const float      overdraw_threshold = 1.05f);
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
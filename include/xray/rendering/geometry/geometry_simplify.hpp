@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_simplify.hpp    Quadric error mesh simplification and
+///         level of detail generation.
+
+#include "xray/xray.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span.h>
+
+namespace xray {
+namespace rendering {
+
+struct geometry_data_t;
+struct vertex_pntt;
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Simplifies a triangle list by collapsing edges in order of
+///         increasing quadric error (Garland - Heckbert). Vertices are
+///         collapsed onto one of their neighbours, never moved, so the
+///         result indexes the original vertex array.
+/// \param  indices             Input triangle list.
+/// \param  vertices            Vertex referenced by index \a base_vertex.
+/// \param  target_index_count  Stop once the list has this many indices
+///                             or less.
+/// \param  target_error        Never collapse an edge that would move the
+///                             surface by more than this distance.
+/// \param  destination         Receives the simplified list, must have room
+///                             for indices.size() indices.
+/// \param  result_error        If not null, receives the largest distance
+///                             the surface moved, in object space units.
+/// \returns Number of indices written to \a destination.
+/// \remarks Vertices on open borders and on attribute seams (several
+///          vertices sharing a position but with different normals or
+///          texture coordinates) are never removed, so borders and seams
+///          keep their exact shape. Collapses that would flip a triangle
+///          are rejected.
+size_t simplify(gsl::span<const uint32_t> indices, const vertex_pntt* vertices,
+                const size_t vertex_count, const uint32_t base_vertex,
+                const size_t target_index_count, const float target_error,
+                uint32_t* destination, float* result_error = nullptr);
+
+/// \brief  Builds a chain of levels of detail for a mesh. Level 0 is the
+///         original triangle list; level i (i >= 1) is simplified to about
+///         triangle_ratios[i - 1] of the original triangles. All levels
+///         share the vertex array; their index lists are appended to the
+///         index buffer and described by mesh->lods.
+/// \param  target_error  Upper bound on the error of any level. Levels
+///                       stop simplifying when they reach it, so coarse
+///                       levels may end up with more triangles than asked.
+/// \remarks Levels are simplified from the original mesh independently,
+///          in parallel. Every level gets its triangles ordered for the
+///          vertex cache. Run this last: passes that treat the whole index
+///          buffer as one triangle list must not see the appended levels.
+void generate_lods(
+    geometry_data_t* mesh, gsl::span<const float> triangle_ratios,
+    const float target_error = std::numeric_limits<float>::max());
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_strip.hpp    Conversion between triangle lists and
+///         triangle strips joined with primitive restart.
+
+#include "xray/xray.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span.h>
+#include <vector>
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Converts a triangle list to triangle strips, separated by
+///         \a restart_index. Triangles keep their winding : triangle k of a
+///         strip s is (s[k], s[k + 1], s[k + 2]) for even k and
+///         (s[k + 1], s[k], s[k + 2]) for odd k, as GL draws them.
+/// \param  vertex_count  Number of vertices referenced by the list.
+/// \param  base_vertex   Value subtracted from every index (first vertex of
+///                       a submesh whose indices are not zero based). The
+///                       strips hold the indices unchanged.
+/// \param  restart_index Must not be used by any vertex.
+/// \param  strip         Receives the strips (previous contents are lost).
+/// \returns Number of indices in the strips. Can be larger than the list
+///          for meshes with poor connectivity.
+/// \remarks Strips follow mesh connectivity rather than the triangle
+///          order, so they give up most of the ordering done by
+///          optimize_vertex_cache().
+size_t stripify(gsl::span<const uint32_t> indices, const size_t vertex_count,
+                const uint32_t base_vertex, const uint32_t restart_index,
+                std::vector<uint32_t>* strip);
+
+/// \brief  Converts triangle strips separated by \a restart_index back to a
+///         triangle list, dropping degenerate triangles.
+size_t unstripify(gsl::span<const uint32_t> strip, const uint32_t restart_index,
+                  std::vector<uint32_t>* indices);
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
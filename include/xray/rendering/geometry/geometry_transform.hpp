@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_transform.hpp    Transforms vertex streams on the CPU.
+
+#include "xray/xray.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/scalar4x4_math_batch.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <span.h>
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Transforms a vertex stream in place. Positions are transformed as
+///         points by \a m, normals and tangents as vectors by
+///         \a normal_matrix (for transforms with non uniform scaling pass
+///         the inverse transpose of \a m). Normals and tangents are not
+///         renormalized.
+inline void transform_vertices(const math::float4x4&   m,
+                               const math::float4x4&   normal_matrix,
+                               gsl::span<vertex_pntt> vertices) noexcept {
+  const auto count = static_cast<size_t>(vertices.size());
+  if (count == 0)
+    return;
+
+  auto first = vertices.data();
+  math::mul_point_n(m, &first->position, sizeof(vertex_pntt), &first->position,
+                    sizeof(vertex_pntt), count);
+  math::mul_vec_n(normal_matrix, &first->normal, sizeof(vertex_pntt),
+                  &first->normal, sizeof(vertex_pntt), count);
+  math::mul_vec_n(normal_matrix, &first->tangent, sizeof(vertex_pntt),
+                  &first->tangent, sizeof(vertex_pntt), count);
+}
+
+/// \brief  Transforms a vertex stream in place, using the same matrix for
+///         positions and directions (rigid body transforms, uniform scaling).
+inline void transform_vertices(const math::float4x4&   m,
+                               gsl::span<vertex_pntt> vertices) noexcept {
+  transform_vertices(m, m, vertices);
+}
+
+/// \brief  Transforms all the vertices of a mesh in place.
+inline void transform_geometry(const math::float4x4& m,
+                               const math::float4x4& normal_matrix,
+                               geometry_data_t*      mesh) noexcept {
+  transform_vertices(m, normal_matrix,
+                     gsl::span<vertex_pntt>{
+                         base::raw_ptr(mesh->geometry),
+                         static_cast<ptrdiff_t>(mesh->vertex_count)});
+}
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
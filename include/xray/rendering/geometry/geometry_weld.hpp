@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   geometry_weld.hpp    Merges duplicate vertices.
+
+#include "xray/xray.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace xray {
+namespace rendering {
+
+struct geometry_data_t;
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Vertex components compared when welding (positions are always
+///         compared). Can be combined via |.
+struct weld_attribute {
+  enum {
+    normal   = 1u << 0,
+    texcoord = 1u << 1,
+    tangent  = 1u << 2,
+    all      = normal | texcoord | tangent
+  };
+};
+
+/// \brief  Two vertices are merged when every compared component differs by
+///         at most the matching epsilon (per coordinate).
+struct weld_options {
+  float    position_epsilon{1.0e-5f};
+  float    normal_epsilon{1.0e-3f};
+  float    texcoord_epsilon{1.0e-5f};
+  float    tangent_epsilon{1.0e-3f};
+  uint32_t attributes{weld_attribute::all};
+};
+
+/// \brief  Merges vertices that are equal within the given tolerances,
+///         compacts the vertex array and remaps the index buffer.
+///         Each submesh is welded separately, so vertices are never shared
+///         between submeshes; submesh ranges are updated.
+/// \returns The number of vertices after welding.
+/// \remarks Vertices are bucketed in a spatial hash of cells four times the
+///          position epsilon wide; only the cells within epsilon of a
+///          vertex are searched. Hashing, sorting, matching and remapping
+///          run on TBB worker threads. The result is deterministic : every
+///          vertex maps to the lowest numbered vertex it matches.
+size_t weld_vertices(geometry_data_t* mesh, const weld_options& opts = {});
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
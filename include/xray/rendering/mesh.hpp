@@ -32,25 +32,125 @@
 ///         geometrical shapes.
 
 #include "xray/xray.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/sphere.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/mesh_cache.hpp"
 #include "xray/rendering/opengl/gl_handles.hpp"
 #include "xray/rendering/vertex_format/vertex_format.hpp"
+#include "xray/rendering/vertex_format/vertex_packing.hpp"
 #include <cstdint>
+#include <span.h>
 #include <string>
+#include <vector>
 
 namespace xray {
 namespace rendering {
 
-struct geometry_data_t;
-
 struct mesh_load_option {
-  enum { remove_points_lines = 1u << 1, convert_left_handed = 1u << 2 };
+  enum {
+    remove_points_lines = 1u << 1,
+    convert_left_handed = 1u << 2,
+
+    ///< Draw triangle strips joined by primitive restart when they need
+    ///< fewer indices than the triangle list. Ignored for meshes with
+    ///< levels of detail.
+    use_strips = 1u << 3,
+
+    ///< Always import with Assimp, neither read nor write the binary mesh
+    ///< cache (see mesh_cache.hpp).
+    no_cache = 1u << 4,
+
+    ///< Import profile (see mesh_import_profile.hpp). Without one, the
+    ///< default profile of the application is used.
+    profile_fast     = 1u << 5,
+    profile_balanced = 1u << 6,
+    profile_full     = 1u << 7
+  };
+};
+
+/// \brief  Size of the index buffer of a mesh, compared with a 32 bit
+///         triangle list.
+struct mesh_index_stats {
+  index_format format{index_format::u32};
+  bool         strips{false};
+
+  ///< Indices in the buffer, including restart indices.
+  size_t index_count{0};
+  size_t buffer_bytes{0};
+
+  ///< Size of the same triangles as a 32 bit triangle list.
+  size_t list_u32_bytes{0};
+
+  size_t bytes_saved() const noexcept { return list_u32_bytes - buffer_bytes; }
+};
+
+/// \brief  Index ranges of the submeshes sharing one material, drawn with
+///         a single call by simple_mesh::draw_material().
+struct mesh_material_batch {
+  uint32_t material_index{0};
+
+  ///< Entries of the batch in the range tables of the mesh. Submeshes
+  ///< adjacent in the index buffer are merged into one range.
+  uint32_t first_range{0};
+  uint32_t range_count{0};
+};
+
+/// \brief  Contents of the buffers of a simple_mesh, built without touching
+///         OpenGL (import, vertex conversion, index narrowing, strips), so
+///         that it can be done on a worker thread. See asset_loader.
+class simple_mesh_data {
+public:
+  simple_mesh_data() noexcept = default;
+
+  XRAY_DEFAULT_MOVE(simple_mesh_data);
+
+  /// \brief  Loads a model file, from the mesh cache when possible.
+  static bool from_file(const vertex_format fmt, const char* mesh_file,
+                        const uint32_t    load_options,
+                        simple_mesh_data* mesh_data);
+
+  /// \param load_options Only mesh_load_option::use_strips applies.
+  static bool from_geometry(const vertex_format    fmt,
+                            const geometry_data_t& geometry,
+                            const uint32_t         load_options,
+                            simple_mesh_data*      mesh_data);
+
+  const mesh_cache_data& contents() const noexcept { return _contents; }
+
+  const std::vector<geometry_lod>& lods() const noexcept { return _lods; }
+
+private:
+  bool import_model(const char* model_data, const size_t data_size,
+                    const uint32_t mesh_process_opts, const vertex_format fmt,
+                    const uint32_t mesh_import_opts, const char* asset_name);
+
+private:
+  ///< Set when loaded from the cache, the contents refer to the mapping.
+  mesh_cache_file               _cached;
+  std::vector<uint8_t>          _vertices;
+  std::vector<uint8_t>          _indices;
+  std::vector<geometry_submesh> _submeshes;
+  std::vector<geometry_lod>     _lods;
+  mesh_cache_data               _contents;
+
+private:
+  XRAY_NO_COPY(simple_mesh_data);
 };
 
 class simple_mesh {
 public:
   simple_mesh() noexcept = default;
 
-  simple_mesh(const vertex_format fmt, const geometry_data_t& geometry);
+  /// \brief Creates the buffers of a mesh loaded in advance.
+  explicit simple_mesh(const simple_mesh_data& mesh_data) {
+    upload(mesh_data);
+  }
+
+  /// \param load_options Only mesh_load_option::use_strips applies.
+  simple_mesh(const vertex_format fmt, const geometry_data_t& geometry,
+              const uint32_t load_options = 0);
 
   simple_mesh(
       const vertex_format fmt, const char* mesh_file,
@@ -68,10 +168,73 @@ public:
 
   void draw();
 
+  /// \brief Draws one level of detail. Level 0 is the full mesh.
+  void draw(const size_t lod);
+
+  /// \brief Number of levels of detail, at least 1 for a valid mesh.
+  size_t lod_count() const noexcept {
+    return _lods.empty() ? 1 : _lods.size();
+  }
+
+  const std::vector<geometry_lod>& lods() const noexcept { return _lods; }
+
+  /// \brief Index type and layout chosen for the mesh (16 bit indices
+  ///        whenever the vertex count allows it).
+  const mesh_index_stats& index_stats() const noexcept { return _indexstats; }
+
+  /// \brief Transform from the quantized positions of a packed vertex
+  ///        format to object space, to apply before the world transform.
+  ///        Identity for the other formats.
+  math::float4x4 position_dequantization() const noexcept {
+    return is_packed_format(_vertexformat) ? _quantization.dequantize_matrix()
+                                           : math::float4x4::stdc::identity;
+  }
+
+  /// \brief Returns the coarsest level of detail whose error is no larger
+  ///        than max_error (in object space units).
+  size_t select_lod(const float max_error) const noexcept;
+
+  /// \brief Bounds of the whole mesh, computed when the mesh is created.
+  const math::aabb3f& aabb() const noexcept { return _aabb; }
+
+  const math::sphere3f& bounding_sphere() const noexcept {
+    return _bounding_sphere;
+  }
+
+  /// \brief Vertex/index ranges and bounds of each mesh in the imported
+  ///        model file. Empty for meshes created from a geometry_data_t
+  ///        without submeshes.
+  const std::vector<geometry_submesh>& submeshes() const noexcept {
+    return _submeshes;
+  }
+
+  /// \brief Draws one submesh (full level of detail).
+  void draw_submesh(const size_t submesh);
+
+  /// \brief Draws a subset of the submeshes (full level of detail) with a
+  ///        single glMultiDrawElements call.
+  void draw_submeshes(const gsl::span<const uint32_t> submesh_indices);
+
+  /// \brief Draws every submesh using the material (full level of detail)
+  ///        with a single glMultiDrawElements call. Draws nothing if no
+  ///        submesh uses it.
+  void draw_material(const uint32_t material_index);
+
+  /// \brief One entry per material used by the submeshes, sorted by
+  ///        material index.
+  const std::vector<mesh_material_batch>& material_batches() const noexcept {
+    return _material_batches;
+  }
+
 private:
-  bool load_model_impl(const char* model_data, const size_t data_size,
-                       const uint32_t mesh_process_opts,
-                       const uint32_t mesh_import_opts);
+  void upload(const simple_mesh_data& mesh_data);
+
+  void build_material_batches();
+
+  void draw_ranges(const GLsizei* counts, const void* const* offsets,
+                   const size_t range_count);
+
+  const void* index_buffer_offset(const uint32_t first_index) const noexcept;
 
   void create_vertexarray();
 
@@ -82,6 +245,17 @@ private:
   vertex_format                        _vertexformat{vertex_format::undefined};
   index_format                         _indexformat{index_format::u16};
   uint32_t                             _indexcount{};
+  math::aabb3f                         _aabb{math::aabb3f::stdc::empty};
+  math::sphere3f                       _bounding_sphere{math::float3::stdc::zero,
+                                                        0.0f};
+  std::vector<geometry_submesh>        _submeshes;
+  std::vector<geometry_lod>            _lods;
+  std::vector<mesh_material_batch>     _material_batches;
+  std::vector<GLsizei>                 _batch_counts;
+  std::vector<const void*>             _batch_offsets;
+  vertex_quantization                  _quantization;
+  mesh_index_stats                     _indexstats;
+  bool                                 _strips{false};
   bool                                 _valid{false};
 
 private:
@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   mesh_cache.hpp    Engine native binary mesh files, written after
+///         a model is imported and memory mapped on the next load so that
+///         Assimp only runs when the source changes.
+
+#include "xray/xray.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/sphere.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_format.hpp"
+#include "xray/rendering/vertex_format/vertex_packing.hpp"
+#include <cstdint>
+#include <memory>
+#include <platformstl/filesystem/memory_mapped_file.hpp>
+#include <span.h>
+#include <string>
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Identifies the result of importing a model : the source file, as
+///         it was when imported, and everything that changes the result.
+///         A cache file is only used if its key matches exactly.
+struct mesh_cache_key {
+  uint64_t source_size{0};
+  int64_t  source_mtime{0};
+  uint32_t source_path_hash{0};
+  uint32_t import_options{0};
+  uint32_t vertex_format{0};
+  uint32_t reserved{0};
+};
+
+/// \brief  Builds the key for a model file.
+/// \returns False if the source file cannot be accessed.
+bool make_mesh_cache_key(const char* source_path, const uint32_t import_options,
+                         const vertex_format fmt, mesh_cache_key* key);
+
+/// \brief  Path of the cache file for a key, in the cache directory of the
+///         application (see app_config::cache_path()). Empty when there is no
+///         application configuration.
+std::string mesh_cache_path(const mesh_cache_key& key);
+
+/// \brief  Contents of a cache file. When read from a file, the pointers
+///         refer to the file mapping.
+struct mesh_cache_data {
+  vertex_format                     vertex_fmt{vertex_format::undefined};
+  index_format                      index_fmt{index_format::u32};
+  bool                              strips{false};
+  const void*                       vertices{nullptr};
+  uint32_t                          vertex_count{0};
+  uint32_t                          vertex_size{0};
+  const void*                       indices{nullptr};
+  uint32_t                          index_count{0};
+
+  ///< Indices of the same triangles as a list (for strips).
+  uint32_t                          list_index_count{0};
+  gsl::span<const geometry_submesh> submeshes;
+  math::aabb3f                      bounding_box{math::aabb3f::stdc::empty};
+  math::sphere3f bounding_sphere{math::float3::stdc::zero, 0.0f};
+  vertex_quantization quantization;
+};
+
+/// \brief  Writes a cache file. The file is written under a temporary name
+///         and renamed when complete, so readers never see partial files.
+bool write_mesh_cache(const char* cache_file, const mesh_cache_key& key,
+                      const mesh_cache_data& data);
+
+/// \brief  A memory mapped cache file. Vertex, index and submesh data are
+///         used in place, straight from the mapping.
+class mesh_cache_file {
+public:
+  mesh_cache_file() noexcept = default;
+
+  XRAY_DEFAULT_MOVE(mesh_cache_file);
+
+  /// \brief  Maps a cache file and validates it against a key.
+  /// \returns False if the file does not exist, is damaged or was written
+  ///          for a different key (the source has changed).
+  bool open(const char* cache_file, const mesh_cache_key& key);
+
+  const mesh_cache_data& data() const noexcept { return _data; }
+
+private:
+  std::unique_ptr<platformstl::memory_mapped_file> _mapping;
+  mesh_cache_data                                  _data;
+
+private:
+  XRAY_NO_COPY(mesh_cache_file);
+};
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
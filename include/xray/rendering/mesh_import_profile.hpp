@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+/// \file   mesh_import_profile.hpp    Assimp post-processing presets and a
+///         timed import, used by simple_mesh and geometry_factory.
+
+#include "xray/xray.hpp"
+#include <cstddef>
+#include <cstdint>
+
+struct aiScene;
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Trade import time for mesh quality.
+enum class mesh_import_profile : uint8_t {
+  ///< Triangulation, indexing, normals and tangents only.
+  fast,
+
+  ///< Adds cleanup of degenerate/invalid data, mesh merging, UV
+  ///< generation and vertex cache ordering.
+  balanced,
+
+  ///< Adds validation, instance detection, bone limits and splitting of
+  ///< large meshes.
+  full
+};
+
+/// \brief  Returns the profile with the given name ("fast", "balanced",
+///         "full").
+/// \returns False for unknown names.
+bool parse_mesh_import_profile(const char*          name,
+                               mesh_import_profile* profile) noexcept;
+
+const char*
+mesh_import_profile_name(const mesh_import_profile profile) noexcept;
+
+/// \brief  Profile of the application (import.mesh_profile in the app_config
+///         file), full when not set.
+mesh_import_profile default_mesh_import_profile() noexcept;
+
+/// \brief  The aiProcess_* post-processing steps of a profile.
+uint32_t mesh_import_profile_steps(const mesh_import_profile profile) noexcept;
+
+/// \brief  An integer Assimp import property (one of the AI_CONFIG_*
+///         names).
+struct mesh_import_property {
+  const char* name;
+  int32_t     value;
+};
+
+/// \brief  Reads a model with Assimp, then applies the post-processing
+///         steps one at a time, logging the time taken by each of them.
+/// \param  import_props  Properties set on the importer before reading.
+/// \param  asset_name  Name used in the log messages.
+/// \returns The imported scene, to release with aiReleaseImport() (that also
+///          deletes the importer owning it), or null if the import or one of
+///          the steps fails.
+const aiScene*
+import_scene_timed(const void* model_data, const size_t data_size,
+                   const uint32_t              post_process_steps,
+                   const mesh_import_property* import_props,
+                   const size_t props_count, const char* asset_name);
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
@@ -31,6 +31,7 @@
 #include "xray/xray.hpp"
 #include "xray/base/array_dimension.hpp"
 #include "xray/base/debug/debug_ext.hpp"
+#include "xray/base/fnv_hash.hpp"
 #include "xray/base/logger.hpp"
 #include "xray/base/unique_handle.hpp"
 #include "xray/base/unique_pointer.hpp"
@@ -41,6 +42,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <opengl/opengl.hpp>
 #include <string>
 #include <vector>
@@ -48,6 +50,8 @@
 namespace xray {
 namespace rendering {
 
+class uniform_ring_buffer;
+
 enum pipeline_stage : uint8_t { vertex, geometry, fragment, last };
 
 struct gpu_program_handle {
@@ -65,13 +69,63 @@ struct gpu_program_handle {
 
 using scoped_program_handle = xray::base::unique_handle<gpu_program_handle>;
 
+/// \brief  Links a program from compiled shaders. With retrievable_binary
+///         set, the driver is asked to keep the program binary around for
+///         glGetProgramBinary.
 GLuint make_gpu_program(const GLuint* shaders_to_attach,
-                        const size_t  shaders_count) noexcept;
+                        const size_t  shaders_count,
+                        const bool    retrievable_binary = false) noexcept;
 
 void set_uniform_impl(const GLuint program_id, const GLint uniform_location,
                       const uint32_t uniform_type, const void* uniform_data,
                       const size_t item_count) noexcept;
 
+/// \brief  FNV-1a hash of a uniform or uniform block name. Written as a
+///         string literal with the _hashed suffix, which is hashed at compile
+///         time : prog.set_uniform("light_count"_hashed, count).
+struct hashed_name {
+  uint32_t value;
+};
+
+constexpr hashed_name operator"" _hashed(const char* name,
+                                         const size_t /*length*/) noexcept {
+  return hashed_name{FNV::fnv1a_constexpr(name)};
+}
+
+/// \brief  Uniform of a gpu_program, looked up once with
+///         gpu_program::uniform_handle(). Setting a uniform through a handle
+///         needs no name lookup. Only valid for the program that returned it.
+struct gpu_uniform_handle {
+  static constexpr uint32_t invalid_index = 0xFFFFFFFFu;
+
+  uint32_t index{invalid_index};
+
+  bool valid() const noexcept { return index != invalid_index; }
+};
+
+/// \brief  Uniform block of a gpu_program, see gpu_uniform_handle.
+struct gpu_uniform_block_handle {
+  static constexpr uint32_t invalid_index = 0xFFFFFFFFu;
+
+  uint32_t index{invalid_index};
+
+  bool valid() const noexcept { return index != invalid_index; }
+};
+
+/// \brief  Uniform buffer writes done by gpu_program::bind_to_pipeline(),
+///         summed over all programs since the last reset.
+struct uniform_upload_stats {
+  ///< Bytes written to uniform buffers.
+  uint64_t bytes_uploaded{0};
+
+  ///< Size of the blocks that had changes, the bytes that uploading whole
+  ///< blocks would have written.
+  uint64_t dirty_block_bytes{0};
+
+  ///< Number of buffer writes, one per dirty range.
+  uint32_t ranges_uploaded{0};
+};
+
 class gpu_program {
 public:
   using handle_type = gpu_program_handle::handle_type;
@@ -87,13 +141,69 @@ public:
   explicit gpu_program(const GLuint (&arr_ref)[shaders_cnt__]) noexcept
       : gpu_program{&arr_ref[0], XR_COUNTOF__(arr_ref)} {}
 
+  /// \brief Takes ownership of an already linked program. Reflection data
+  ///        written by save_reflection() for the same program is used
+  ///        instead of querying the program; when missing or damaged the
+  ///        program is reflected as usual.
+  gpu_program(const GLuint linked_program, const void* reflection_data,
+              const size_t reflection_bytes) noexcept;
+
+  /// \brief Serializes the uniform blocks, uniforms and subroutines
+  ///        of the program, for use with the constructor above.
+  void save_reflection(std::vector<uint8_t>* blob) const;
+
   bool valid() const noexcept { return valid_; }
 
   explicit operator bool() const noexcept { return valid(); }
 
   handle_type handle() const noexcept { return base::raw_handle(prog_handle_); }
 
-  void bind_to_pipeline();
+  /// \brief Uploads the modified ranges of the uniform blocks, binds the
+  ///        blocks and makes the program current.
+  ///
+  ///        When a ring is given, blocks are written into the ring's current
+  ///        frame and bound with glBindBufferRange, so that consecutive draws
+  ///        do not wait on each other's buffer. A block that did not change
+  ///        since it was last written to the ring in the same frame is bound
+  ///        at its previous offset. If the ring is exhausted, the block's
+  ///        own buffer is used.
+  void bind_to_pipeline(uniform_ring_buffer* ring = nullptr);
+
+  /// \brief Upload statistics of all programs. Meant to be read and reset
+  ///        once per frame, from the thread owning the OpenGL context.
+  static uniform_upload_stats upload_stats() noexcept;
+
+  static void reset_upload_stats() noexcept;
+
+  /// \brief Declares a uniform block as shared. In programs linked after
+  ///        this call, blocks with this name and the same layout (size,
+  ///        member names, types and offsets) use one CPU store and one GPU
+  ///        buffer, bound at bindpoint instead of the binding point set in
+  ///        the shader. Data common to all programs (camera, lights) is then
+  ///        uploaded once per frame, no matter how many programs use it.
+  ///        Shared blocks are not written to uniform ring buffers.
+  ///        A program fails to build if another of its blocks uses
+  ///        bindpoint.
+  static void share_uniform_block(const char*    block_name,
+                                  const uint32_t bindpoint);
+
+  /// \name Uniform and uniform block handles
+  /// Names are looked up with a binary search, hashed names in a table of
+  /// hashes built when the program is linked. An invalid handle is returned
+  /// for names that do not exist.
+  /// @{
+public:
+  gpu_uniform_handle uniform_handle(const char* uniform_name) const noexcept;
+
+  gpu_uniform_handle uniform_handle(const hashed_name uniform_name) const
+      noexcept;
+
+  gpu_uniform_block_handle uniform_block_handle(const char* block_name) const
+      noexcept;
+
+  gpu_uniform_block_handle uniform_block_handle(const hashed_name block_name)
+      const noexcept;
+  /// @}
 
   /// \name Uniform block functions
   /// @{
@@ -103,8 +213,26 @@ public:
     set_uniform_block(block_name, &data, sizeof(data));
   }
 
+  template <typename block_data_type>
+  void set_uniform_block(const hashed_name      block_name,
+                         const block_data_type& data) {
+    set_uniform_block(block_name, &data, sizeof(data));
+  }
+
+  template <typename block_data_type>
+  void set_uniform_block(const gpu_uniform_block_handle block,
+                         const block_data_type&         data) {
+    set_uniform_block(block, &data, sizeof(data));
+  }
+
   void set_uniform_block(const char* block_name, const void* block_data,
                          const size_t byte_count);
+
+  void set_uniform_block(const hashed_name block_name, const void* block_data,
+                         const size_t byte_count);
+
+  void set_uniform_block(const gpu_uniform_block_handle block,
+                         const void* block_data, const size_t byte_count);
   /// @}
 
   /// \name Uniform functions
@@ -125,6 +253,38 @@ public:
   void set_uniform(const char* uniform_name, const uniform_data_type* data,
                    const size_t count);
 
+  template <typename uniform_data_type, size_t size>
+  void set_uniform(const hashed_name uniform_name,
+                   const uniform_data_type (&arr_ref)[size]) {
+    set_uniform(uniform_name, &arr_ref[0], size);
+  }
+
+  template <typename uniform_data_type>
+  void set_uniform(const hashed_name        uniform_name,
+                   const uniform_data_type& data) {
+    set_uniform(uniform_name, &data, 1);
+  }
+
+  template <typename uniform_data_type>
+  void set_uniform(const hashed_name uniform_name,
+                   const uniform_data_type* data, const size_t count);
+
+  template <typename uniform_data_type, size_t size>
+  void set_uniform(const gpu_uniform_handle uniform,
+                   const uniform_data_type (&arr_ref)[size]) {
+    set_uniform(uniform, &arr_ref[0], size);
+  }
+
+  template <typename uniform_data_type>
+  void set_uniform(const gpu_uniform_handle uniform,
+                   const uniform_data_type& data) {
+    set_uniform(uniform, &data, 1);
+  }
+
+  template <typename uniform_data_type>
+  void set_uniform(const gpu_uniform_handle uniform,
+                   const uniform_data_type* data, const size_t count);
+
   void set_subroutine_uniform(const pipeline_stage stage,
                               const char*          uniform_name,
                               const char*          subroutine_name) noexcept;
@@ -133,6 +293,46 @@ public:
 private:
   bool reflect();
 
+  /// \brief  Byte ranges [first, last) of a uniform block modified since the
+  ///         last upload. Ranges that overlap or are less than merge_gap
+  ///         bytes apart are merged; when all the slots are used the new
+  ///         range is merged with the closest one.
+  struct dirty_ranges_t {
+    static constexpr uint32_t max_ranges = 4;
+    static constexpr uint32_t merge_gap  = 64;
+
+    struct range_t {
+      uint32_t first;
+      uint32_t last;
+    };
+
+    range_t  ranges[max_ranges];
+    uint32_t count{0};
+
+    void add(uint32_t first, uint32_t last) noexcept;
+
+    void clear() noexcept { count = 0; }
+
+    bool empty() const noexcept { return count == 0; }
+  };
+
+  /// \brief  Uniform block data shared by all programs that declare a block
+  ///         with the same name and layout. See share_uniform_block().
+  struct shared_uniform_block_t {
+    std::string                     name{};
+    uint32_t                        layout_hash{0};
+    uint32_t                        size{0};
+    uint32_t                        bindpoint{0};
+    base::unique_pointer<uint8_t[]> store{};
+    dirty_ranges_t                  dirty{};
+    scoped_buffer                   gl_buff{};
+  };
+
+  /// \brief  Shared block declarations and live shared blocks.
+  struct shared_block_registry_t;
+
+  static shared_block_registry_t& shared_block_registry();
+
   /// \brief  Description of a uniform block in a shader program.
   struct uniform_block_t {
     ///< Name of the uniform block as defined in the shader code.
@@ -150,8 +350,21 @@ private:
     ///< Binding point.
     uint32_t bindpoint{0};
 
-    ///< True if data is out of sync with the GPU buffer.
-    bool dirty{false};
+    ///< Ranges of the block that are out of sync with the GPU buffer.
+    dirty_ranges_t dirty{};
+
+    ///< Ring buffer and frame the block was last written to, with the
+    ///< offset of the copy in the ring's buffer.
+    const uniform_ring_buffer* ring{nullptr};
+    uint64_t                   ring_frame{0};
+    uint32_t                   ring_offset{0};
+
+    ///< True if the block changed since it was last written to the ring.
+    bool ring_stale{true};
+
+    ///< Store and buffer of a shared block, used instead of the program's
+    ///< own when set.
+    std::shared_ptr<shared_uniform_block_t> shared{};
 
     ///< Handle to the GPU buffer.
     scoped_buffer gl_buff{};
@@ -188,8 +401,44 @@ private:
 
   bool collect_uniform_blocks();
 
+  /// \brief Allocates the CPU store and the GPU buffers of the blocks and
+  ///        makes them the program's blocks.
+  bool create_uniform_block_storage(std::vector<uniform_block_t> ublocks);
+
+  /// \brief Restores state saved by save_reflection() and sets valid_.
+  ///        Returns false, leaving the program untouched, if the data is
+  ///        malformed.
+  bool load_reflection(const void* data, const size_t bytes);
+
   bool collect_uniforms();
 
+  /// \brief Hash of a uniform or block name and its index in the list of
+  ///        uniforms or blocks.
+  struct name_hash_t {
+    uint32_t hash;
+    uint32_t index;
+  };
+
+  void hash_uniform_names();
+
+  /// \brief Copies data into the storage of a block, marking the bytes that
+  ///        change as dirty.
+  void write_block_data(uniform_block_t* block, const uint32_t offset,
+                        const void* data, const size_t byte_count) noexcept;
+
+  /// \brief Writes the dirty ranges of a block to its GPU buffer.
+  static bool upload_dirty_ranges(const GLuint buffer, const uint8_t* src,
+                                  const uint32_t  size,
+                                  dirty_ranges_t* dirty) noexcept;
+
+  /// \brief Hash of the block's size and of the name, type and offset of
+  ///        each of its members.
+  uint32_t uniform_block_layout_hash(const uint32_t blk_idx) const noexcept;
+
+  /// \brief Attaches the blocks declared as shared to the registry's shared
+  ///        blocks, creating them for layouts seen for the first time.
+  bool share_uniform_blocks();
+
   ///   \name Subroutine uniforms
   ///   @{
 
@@ -244,6 +493,10 @@ private:
   /// \brief List of active uniforms in the shader.
   std::vector<uniform_t> uniforms_;
 
+  /// \brief Name hashes of the uniform blocks and uniforms, sorted by hash.
+  std::vector<name_hash_t> uniform_block_hashes_;
+  std::vector<name_hash_t> uniform_hashes_;
+
   /// \brief Storage for uniform block data
   base::unique_pointer<uint8_t[]> ublocks_datastore_;
 
@@ -272,36 +525,60 @@ void gpu_program::set_uniform(const char*              uniform_name,
                               const size_t             count) {
   assert(valid());
 
-  using namespace std;
+  const auto uniform = uniform_handle(uniform_name);
+  if (!uniform.valid()) {
+    XR_LOG_ERR("Uniform {} does not exist", uniform_name);
+    return;
+  }
 
-  auto u_iter =
-      find_if(begin(uniforms_), end(uniforms_),
-              [uniform_name](const auto& u) { return u.name == uniform_name; });
+  set_uniform(uniform, data, count);
+}
 
-  if (u_iter == end(uniforms_)) {
-    // OUTPUT_DBG_MSG("Uniform %s does not exist!", uniform_name);
-    XR_LOG_ERR("Uniform {} does not exist", uniform_name);
+template <typename uniform_data_type>
+void gpu_program::set_uniform(const hashed_name        uniform_name,
+                              const uniform_data_type* data,
+                              const size_t             count) {
+  assert(valid());
+
+  const auto uniform = uniform_handle(uniform_name);
+  if (!uniform.valid()) {
+    XR_LOG_ERR("Uniform with name hash {:#x} does not exist",
+               uniform_name.value);
     return;
   }
 
+  set_uniform(uniform, data, count);
+}
+
+template <typename uniform_data_type>
+void gpu_program::set_uniform(const gpu_uniform_handle uniform,
+                              const uniform_data_type* data,
+                              const size_t             count) {
+  assert(valid());
+
   //
-  // Standalone uniform.
-  if (u_iter->parent_block_idx == -1) {
-    set_uniform_impl(handle(), u_iter->location, u_iter->type, data, count);
+  // Also catches invalid handles (missing names) in release builds.
+  if (uniform.index >= uniforms_.size()) {
+    XR_LOG_ERR("Invalid uniform handle {:#x}", uniform.index);
     return;
   }
 
-  using namespace xray::base;
+  const auto& u = uniforms_[uniform.index];
+
+  //
+  // Standalone uniform.
+  if (u.parent_block_idx == -1) {
+    set_uniform_impl(handle(), u.location, u.type, data, count);
+    return;
+  }
 
   //
   // Uniform is part of a block.
-  auto&      par_blk       = uniform_blocks_[u_iter->parent_block_idx];
-  const auto mem_offset    = par_blk.store_offset + u_iter->block_store_offset;
   const auto bytes_to_copy = count * sizeof(*data);
+  assert(bytes_to_copy == u.byte_size);
 
-  assert(bytes_to_copy == u_iter->byte_size);
-  memcpy(raw_ptr(ublocks_datastore_) + mem_offset, data, bytes_to_copy);
-  par_blk.dirty = true;
+  write_block_data(&uniform_blocks_[u.parent_block_idx], u.block_store_offset,
+                   data, bytes_to_copy);
 }
 
 } // namespace rendering
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "xray/xray.hpp"
+#include "xray/rendering/opengl/gpu_program.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace xray {
+namespace rendering {
+
+/// \brief  Source file of a program stage.
+struct shader_source_file {
+  ///< Stage (gl::VERTEX_SHADER, gl::FRAGMENT_SHADER, etc).
+  uint32_t shader_type;
+
+  ///< Path of the GLSL source.
+  const char* path;
+};
+
+/// \brief  Builds a program from GLSL source files, going through the on
+///         disk program binary cache (app_config::program_cache_path()).
+///
+///         Each cache entry stores the identity of the program : the type,
+///         path and source hash of every stage, the defines and the driver's
+///         vendor, renderer and version strings. Entries are named by a 64
+///         bit hash of the identity, which is compared in full before the
+///         binary is used; editing a shader or updating the driver misses
+///         the cache. On a hit the program is loaded with glProgramBinary
+///         and its reflection data is read from the same file, so there is
+///         no compiling, linking or reflection. A missing, outdated or
+///         rejected binary falls back to compiling the sources and refreshes
+///         the cache entry.
+///
+/// \param  defines Text inserted after the #version line of each stage
+///         (e.g. "#define USE_FOG 1\n"), may be null.
+gpu_program make_cached_gpu_program(const shader_source_file* stages,
+                                    const size_t              stages_count,
+                                    const char* defines = nullptr);
+
+template <size_t stages_count__>
+gpu_program
+make_cached_gpu_program(const shader_source_file (&stages)[stages_count__],
+                        const char* defines = nullptr) {
+  return make_cached_gpu_program(&stages[0], stages_count__, defines);
+}
+
+} // namespace rendering
+} // namespace xray
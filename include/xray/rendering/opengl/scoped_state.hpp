@@ -87,6 +87,27 @@ private:
   XRAY_NO_MOVE(scoped_element_array_binding);
 };
 
+struct scoped_capability {
+public:
+  scoped_capability(const GLenum capability, const bool enabled) noexcept
+      : _capability{capability}
+      , _was_enabled{gl::IsEnabled(capability) == gl::TRUE_} {
+    enabled ? gl::Enable(capability) : gl::Disable(capability);
+  }
+
+  ~scoped_capability() {
+    _was_enabled ? gl::Enable(_capability) : gl::Disable(_capability);
+  }
+
+private:
+  GLenum _capability;
+  bool   _was_enabled;
+
+private:
+  XRAY_NO_COPY(scoped_capability);
+  XRAY_NO_MOVE(scoped_capability);
+};
+
 //struct scoped_
 
 } // namespace rendering
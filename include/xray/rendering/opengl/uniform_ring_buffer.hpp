@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "xray/xray.hpp"
+#include "xray/rendering/opengl/gl_handles.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <opengl/opengl.hpp>
+
+namespace xray {
+namespace rendering {
+
+/// \brief  Memory handed out by uniform_ring_buffer::allocate(). An empty
+///         allocation (null memory) means the frame's region is exhausted.
+struct uniform_ring_allocation {
+  ///< Write pointer, valid until the end of the frame.
+  void* memory{nullptr};
+
+  ///< Offset of the allocation in the ring's buffer, to be used with
+  ///< glBindBufferRange.
+  uint32_t offset{0};
+
+  uint32_t size{0};
+
+  explicit operator bool() const noexcept { return memory != nullptr; }
+};
+
+/// \brief  Persistently and coherently mapped buffer for uniform data that
+///         changes from draw to draw. The buffer is split in one region per
+///         frame in flight; a frame sub-allocates linearly from its region
+///         and places a fence when it ends. A region is reused only after
+///         its fence signals, so writes never touch memory the GPU may
+///         still be reading and draws never wait on a map/unmap.
+///
+///         Usage : begin_frame(), any number of allocate() calls, end_frame(),
+///         all on the thread owning the OpenGL context.
+class uniform_ring_buffer {
+public:
+  static constexpr uint32_t frames_in_flight = 3;
+
+  uniform_ring_buffer() noexcept = default;
+
+  /// \param  bytes_per_frame Size of each frame's region. Rounded up to
+  ///         the uniform buffer offset alignment.
+  explicit uniform_ring_buffer(const uint32_t bytes_per_frame) noexcept;
+
+  ~uniform_ring_buffer() noexcept;
+
+  bool valid() const noexcept { return mapped_ != nullptr; }
+
+  explicit operator bool() const noexcept { return valid(); }
+
+  GLuint handle() const noexcept { return base::raw_handle(buffer_); }
+
+  /// \brief  Identifies the current frame; it changes with every
+  ///         begin_frame() call.
+  uint64_t frame_id() const noexcept { return frame_id_; }
+
+  /// \brief  Waits until the GPU is done with the region of the frame that
+  ///         used it frames_in_flight frames ago and starts allocating from
+  ///         it.
+  void begin_frame() noexcept;
+
+  /// \brief  Fences the commands that read the current region.
+  void end_frame() noexcept;
+
+  /// \brief  Allocates bytes from the current frame's region, aligned for
+  ///         use as a uniform buffer range.
+  uniform_ring_allocation allocate(const size_t bytes) noexcept;
+
+private:
+  scoped_buffer buffer_{};
+  uint8_t*      mapped_{nullptr};
+  uint32_t      region_bytes_{0};
+  uint32_t      alignment_{0};
+  uint32_t      region_idx_{0};
+  uint32_t      region_offset_{0};
+  uint64_t      frame_id_{0};
+  bool          overflow_logged_{false};
+  GLsync        fences_[frames_in_flight]{};
+
+private:
+  XRAY_NO_COPY(uniform_ring_buffer);
+};
+
+} // namespace rendering
+} // namespace xray
@@ -34,7 +34,25 @@
 namespace xray {
 namespace rendering {
 
-enum class vertex_format { undefined, p, pn, pt, pnt, pntt };
+enum class vertex_format {
+  undefined,
+  p,
+  pn,
+  pt,
+  pnt,
+  pntt,
+
+  ///< Packed formats : quantized positions, snorm10 normals/tangents and
+  ///< half float texture coordinates. See vertex_packing.hpp.
+  pnt_packed,
+  pntt_packed
+};
+
+/// \brief Returns true for the formats that store quantized positions and
+///        need a dequantization transform (see vertex_quantization).
+inline constexpr bool is_packed_format(const vertex_format fmt) noexcept {
+  return fmt == vertex_format::pnt_packed || fmt == vertex_format::pntt_packed;
+}
 
 enum class index_format { u16, u32 };
 
@@ -47,7 +65,12 @@ struct component_type {
     signed_int,
     unsigned_int,
     float_,
-    double_
+    double_,
+    half_float,
+
+    ///< Four components in 32 bits : x, y, z in 10 bits, w in 2 bits
+    ///< (GL_INT_2_10_10_10_REV).
+    packed_int_2_10_10_10
   };
 };
 
@@ -55,6 +78,10 @@ struct vertex_format_entry_desc {
   uint32_t component_count;
   uint32_t component_type;
   uint32_t component_offset;
+
+  ///< Integer components are mapped to [0, 1] (unsigned) or [-1, 1]
+  ///< (signed) instead of being converted as is.
+  bool normalized;
 };
 
 template <xray::rendering::vertex_format fmt>
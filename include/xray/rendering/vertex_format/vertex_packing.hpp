@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   vertex_packing.hpp    Conversion of vertex_pntt data to the
+///         packed vertex formats, and measurement of the precision lost.
+
+#include "xray/xray.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/rendering/vertex_format/vertex_format.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span.h>
+
+namespace xray {
+namespace rendering {
+
+struct vertex_pntt;
+struct vertex_pnt_packed;
+struct vertex_pntt_packed;
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Maps quantized positions back to object space :
+///         position = offset + scale * q, with q in [0, 1]^3 (the value
+///         the vertex shader reads from a normalized unsigned attribute).
+struct vertex_quantization {
+  math::float3 offset{math::float3::stdc::zero};
+  math::float3 scale{math::float3::stdc::one};
+
+  /// \brief  Matrix to apply before the world transform of a mesh with a
+  ///         packed vertex format.
+  math::float4x4 dequantize_matrix() const noexcept {
+    // clang-format off
+
+    return {
+      scale.x, 0.0f,    0.0f,    offset.x,
+      0.0f,    scale.y, 0.0f,    offset.y,
+      0.0f,    0.0f,    scale.z, offset.z,
+      0.0f,    0.0f,    0.0f,    1.0f
+    };
+
+    // clang-format on
+  }
+};
+
+/// \brief  Quantization covering a bounding box. Flat axes get a unit scale
+///         so that dequantization never divides by zero.
+inline vertex_quantization
+make_vertex_quantization(const math::aabb3f& box) noexcept {
+  const auto extent = box.max - box.min;
+
+  vertex_quantization q;
+  q.offset = box.min;
+  q.scale  = {extent.x > 0.0f ? extent.x : 1.0f,
+             extent.y > 0.0f ? extent.y : 1.0f,
+             extent.z > 0.0f ? extent.z : 1.0f};
+  return q;
+}
+
+/// \name Scalar encoding and decoding of the packed components.
+/// @{
+
+/// \brief  Packs a vector with components in [-1, 1] and a w in
+///         {-1, 0, 1} into the 2_10_10_10_REV signed normalized layout.
+inline uint32_t pack_snorm10(const math::float3& v, const int32_t w) noexcept {
+  const auto encode = [](const float f) {
+    const auto c = f < -1.0f ? -1.0f : (f > 1.0f ? 1.0f : f);
+    const auto s = c * 511.0f + (c < 0.0f ? -0.5f : 0.5f);
+    return static_cast<uint32_t>(static_cast<int32_t>(s)) & 0x3FFu;
+  };
+
+  return encode(v.x) | (encode(v.y) << 10) | (encode(v.z) << 20) |
+         ((static_cast<uint32_t>(w) & 0x3u) << 30);
+}
+
+inline math::float3 unpack_snorm10(const uint32_t packed) noexcept {
+  const auto decode = [](const uint32_t bits) {
+    //
+    //  Sign extend the 10 bit value, -512 decodes to -1 like -511.
+    const auto i = static_cast<int32_t>(bits << 22) >> 22;
+    const auto f = static_cast<float>(i) / 511.0f;
+    return f < -1.0f ? -1.0f : f;
+  };
+
+  return {decode(packed & 0x3FFu), decode((packed >> 10) & 0x3FFu),
+          decode((packed >> 20) & 0x3FFu)};
+}
+
+/// \brief  Converts a float to an IEEE 754 half float, rounding to nearest
+///         even. Values too large for a half become infinities.
+inline uint16_t float_to_half(const float f) noexcept {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+
+  const auto sign     = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  auto       abs_bits = bits & 0x7FFFFFFFu;
+
+  //
+  //  Inf and NaN.
+  if (abs_bits >= 0x7F800000u)
+    return sign | 0x7C00u | (abs_bits > 0x7F800000u ? 0x200u : 0u);
+
+  //
+  //  Rounds to 65520 or more, the first value past the largest half.
+  if (abs_bits >= 0x477FF000u)
+    return sign | 0x7C00u;
+
+  //
+  //  Below the smallest normal half : a multiple of 2^-24.
+  if (abs_bits < 0x38800000u) {
+    float abs_val;
+    memcpy(&abs_val, &abs_bits, sizeof(abs_val));
+    return sign | static_cast<uint16_t>(std::lrint(abs_val * 16777216.0f));
+  }
+
+  //
+  //  Rebias the exponent (127 -> 15) and round the mantissa to 10 bits.
+  abs_bits += 0xC8000FFFu + ((abs_bits >> 13) & 1u);
+  return sign | static_cast<uint16_t>(abs_bits >> 13);
+}
+
+inline float half_to_float(const uint16_t h) noexcept {
+  const uint32_t sign     = static_cast<uint32_t>(h & 0x8000u) << 16;
+  const uint32_t exponent = (h >> 10) & 0x1Fu;
+  const uint32_t mantissa = h & 0x3FFu;
+
+  if (exponent == 0) {
+    const auto f = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+    return sign ? -f : f;
+  }
+
+  const uint32_t bits =
+      exponent == 0x1Fu ? sign | 0x7F800000u | (mantissa << 13)
+                        : sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+/// @}
+
+/// \brief  Converts vertices to the packed format. Normals and tangents
+///         are processed native_float_lanes vertices at a time.
+void pack_vertices(gsl::span<const vertex_pntt> vertices,
+                   const vertex_quantization& quantization,
+                   vertex_pnt_packed*         packed);
+
+void pack_vertices(gsl::span<const vertex_pntt> vertices,
+                   const vertex_quantization& quantization,
+                   vertex_pntt_packed*        packed);
+
+/// \brief  Largest and mean error introduced by packing, per attribute.
+///         Position errors are distances in object space units, normal
+///         and tangent errors are angles in degrees.
+struct vertex_packing_error {
+  float position_max{0.0f};
+  float position_mean{0.0f};
+  float normal_max{0.0f};
+  float normal_mean{0.0f};
+  float tangent_max{0.0f};
+  float tangent_mean{0.0f};
+  float texcoord_max{0.0f};
+  float texcoord_mean{0.0f};
+};
+
+/// \brief  Packs \a vertices to \a fmt (pnt_packed or pntt_packed), unpacks
+///         them and compares the result with the source. Tangent errors
+///         are zero for formats without tangents.
+vertex_packing_error
+measure_packing_error(gsl::span<const vertex_pntt> vertices,
+                      const vertex_format          fmt,
+                      const vertex_quantization&   quantization);
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
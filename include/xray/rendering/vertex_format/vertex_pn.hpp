@@ -68,8 +68,10 @@ struct vertex_format_traits<xray::rendering::vertex_format::pn> {
 
   static const vertex_format_entry_desc* description() {
     static constexpr vertex_format_entry_desc vdesc[] = {
-        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pn, position)},
-        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pn, normal)}};
+        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pn, position),
+         false},
+        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pn, normal),
+         false}};
 
     return vdesc;
   }
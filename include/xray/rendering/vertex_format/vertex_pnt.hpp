@@ -74,9 +74,12 @@ struct vertex_format_traits<xray::rendering::vertex_format::pnt> {
 
   static const vertex_format_entry_desc* description() {
     static constexpr vertex_format_entry_desc vdesc[] = {
-        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pnt, position)},
-        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pnt, normal)},
-        {2, component_type::float_, XR_U32_OFFSETOF(vertex_pnt, texcoord)}};
+        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pnt, position),
+         false},
+        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pnt, normal),
+         false},
+        {2, component_type::float_, XR_U32_OFFSETOF(vertex_pnt, texcoord),
+         false}};
 
     return vdesc;
   }
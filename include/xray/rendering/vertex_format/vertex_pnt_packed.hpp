@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2011, 2012, 2013 Adrian Hodos
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the author nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR THE CONTRIBUTORS BE LIABLE FOR
+// ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/// \file   vertex_pnt_packed.hpp
+///
+
+#include "xray/xray.hpp"
+#include "xray/rendering/vertex_format/vertex_format.hpp"
+#include <cstdint>
+
+namespace xray {
+namespace rendering {
+
+/// \addtogroup __GroupXrayRendering
+/// @{
+
+/// \brief  Packed position, normal and texture coordinates (16 bytes).
+///         The position is quantized to 16 bits per axis over the bounding
+///         box of the mesh (see vertex_quantization), the normal is stored
+///         as signed normalized 10 bit components and the texture
+///         coordinates as half floats.
+struct vertex_pnt_packed {
+  ///< Unsigned normalized x, y, z; the last element is padding.
+  uint16_t position[4];
+
+  ///< Signed normalized 10 bit x, y, z (2_10_10_10_REV layout).
+  uint32_t normal;
+
+  ///< Half float u, v.
+  uint16_t texcoords[2];
+};
+
+static_assert(sizeof(vertex_pnt_packed) == 16, "Unexpected padding!");
+
+template <>
+struct vertex_format_traits<xray::rendering::vertex_format::pnt_packed> {
+  using vertex_type = xray::rendering::vertex_pnt_packed;
+  static constexpr size_t   bytes_size{sizeof(vertex_pnt_packed)};
+  static constexpr uint32_t components{3};
+
+  static const vertex_format_entry_desc* description() {
+    static constexpr vertex_format_entry_desc vdesc[] = {
+        {3, component_type::unsigned_short,
+         XR_U32_OFFSETOF(vertex_pnt_packed, position), true},
+        {4, component_type::packed_int_2_10_10_10,
+         XR_U32_OFFSETOF(vertex_pnt_packed, normal), true},
+        {2, component_type::half_float,
+         XR_U32_OFFSETOF(vertex_pnt_packed, texcoords), false}};
+
+    return vdesc;
+  }
+};
+
+/// @}
+
+} // namespace rendering
+} // namespace xray
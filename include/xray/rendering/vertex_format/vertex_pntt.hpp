@@ -73,10 +73,14 @@ struct vertex_format_traits<xray::rendering::vertex_format::pntt> {
 
   static const vertex_format_entry_desc* description() {
     static constexpr vertex_format_entry_desc vdesc[] = {
-        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, position)},
-        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, normal)},
-        {2, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, texcoords)},
-        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, tangent)},
+        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, position),
+         false},
+        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, normal),
+         false},
+        {2, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, texcoords),
+         false},
+        {3, component_type::float_, XR_U32_OFFSETOF(vertex_pntt, tangent),
+         false},
     };
 
     return vdesc;
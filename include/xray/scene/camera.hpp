@@ -29,6 +29,7 @@
 #pragma once
 
 #include "xray/xray.hpp"
+#include "xray/math/frustum.hpp"
 #include "xray/math/scalar3.hpp"
 #include "xray/math/scalar4x4.hpp"
 #include "xray/xray_types.hpp"
@@ -59,6 +60,9 @@ public:
 
   const math::float4x4& projection_view() const noexcept;
 
+  /// \brief Frustum planes, in world space, extracted from projection_view().
+  const math::frustum3f& view_frustum() const noexcept;
+
   void look_at(const math::float3& eye_pos, const math::float3& target,
                const math::float3& world_up) noexcept;
 
@@ -68,14 +72,15 @@ private:
   void update() const noexcept;
 
 private:
-  math::float3           right_{math::float3::stdc::zero};
-  math::float3           up_{math::float3::stdc::zero};
-  math::float3           direction_{math::float3::stdc::zero};
-  math::float3           origin_{math::float3::stdc::zero};
-  mutable math::float4x4 view_{math::float4x4::stdc::identity};
-  mutable math::float4x4 projection_{math::float4x4::stdc::identity};
-  mutable math::float4x4 projection_view_{math::float4x4::stdc::identity};
-  mutable bool           updated_{false};
+  math::float3            right_{math::float3::stdc::zero};
+  math::float3            up_{math::float3::stdc::zero};
+  math::float3            direction_{math::float3::stdc::zero};
+  math::float3            origin_{math::float3::stdc::zero};
+  mutable math::float4x4  view_{math::float4x4::stdc::identity};
+  mutable math::float4x4  projection_{math::float4x4::stdc::identity};
+  mutable math::float4x4  projection_view_{math::float4x4::stdc::identity};
+  mutable math::frustum3f frustum_;
+  mutable bool            updated_{false};
 };
 
 /// @}
@@ -0,0 +1,46 @@
+//
+//  Generates geospheres at every subdivision level and reports the vertex and
+//  face counts, the memory used by the vertex and index buffers and the
+//  generation time (best of several runs).
+
+#include "xray/base/basic_timer.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/geometry/geometry_factory.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+using namespace xray::base;
+using namespace xray::rendering;
+
+static constexpr uint32_t RUNS = 5;
+
+int main() {
+  printf("%5s %10s %10s %12s %12s\n", "level", "vertices", "faces", "memory",
+         "time");
+
+  constexpr auto max_level = geometry_factory::geosphere_max_subdivisions;
+
+  for (uint32_t level = 0; level <= max_level; ++level) {
+    geometry_data_t mesh;
+    double          best_ms{1.0e30};
+
+    for (uint32_t run = 0; run < RUNS; ++run) {
+      timer_highp timer;
+      timer.start();
+      geometry_factory::geosphere(1.0f, level, &mesh);
+      timer.end();
+      best_ms = std::min(best_ms, timer.elapsed_millis());
+    }
+
+    const auto mesh_bytes = mesh.vertex_count * sizeof(vertex_pntt) +
+                            mesh.index_count * sizeof(uint32_t);
+
+    printf("%5u %10zu %10zu %9.2f MB %9.3f ms\n", level, mesh.vertex_count,
+           mesh.index_count / 3,
+           static_cast<double>(mesh_bytes) / (1024.0 * 1024.0), best_ms);
+  }
+
+  return 0;
+}
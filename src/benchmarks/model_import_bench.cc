@@ -0,0 +1,146 @@
+//
+//  Reads OBJ and PLY files with the native importer (import_native_model())
+//  and with Assimp, and reports the time and throughput of both. Files are
+//  loaded in memory first, so disk reads are not timed. Assimp is asked for
+//  the same output as the native importer : triangles, with identical
+//  vertices joined.
+//
+//  Usage : model_import_bench file.obj|file.ply ...
+
+#include "xray/base/basic_timer.hpp"
+#include "xray/base/file_io.hpp"
+#include "xray/base/logger.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/geometry/geometry_import_native.hpp"
+#include <algorithm>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace xray::base;
+using namespace xray::rendering;
+using namespace std;
+
+static constexpr uint32_t RUNS = 5;
+
+static constexpr uint32_t ASSIMP_STEPS =
+    aiProcess_Triangulate | aiProcess_JoinIdenticalVertices;
+
+struct import_result {
+  double best_ms{1.0e30};
+  size_t vertex_count{};
+  size_t index_count{};
+  bool   ok{true};
+};
+
+static import_result time_native(const string&             contents,
+                                 const native_model_format fmt) {
+  import_result result;
+
+  for (uint32_t run = 0; result.ok && run < RUNS; ++run) {
+    geometry_data_t    mesh;
+    native_import_info info;
+
+    timer_highp timer;
+    timer.start();
+    result.ok = import_native_model(contents.data(), contents.size(), fmt,
+                                    &mesh, &info);
+    timer.end();
+
+    result.best_ms      = std::min(result.best_ms, timer.elapsed_millis());
+    result.vertex_count = mesh.vertex_count;
+    result.index_count  = mesh.index_count;
+  }
+
+  return result;
+}
+
+static import_result time_assimp(const string& contents,
+                                 const char*   format_hint) {
+  import_result result;
+
+  for (uint32_t run = 0; result.ok && run < RUNS; ++run) {
+    Assimp::Importer importer;
+
+    timer_highp timer;
+    timer.start();
+    const auto scene = importer.ReadFileFromMemory(
+        contents.data(), contents.size(), ASSIMP_STEPS, format_hint);
+    timer.end();
+
+    result.ok = scene != nullptr;
+    if (!result.ok) {
+      XR_LOG_ERR("Assimp : {}", importer.GetErrorString());
+      break;
+    }
+
+    result.best_ms      = std::min(result.best_ms, timer.elapsed_millis());
+    result.vertex_count = 0;
+    result.index_count  = 0;
+
+    for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
+      result.vertex_count += scene->mMeshes[i]->mNumVertices;
+      result.index_count += size_t{scene->mMeshes[i]->mNumFaces} * 3;
+    }
+  }
+
+  return result;
+}
+
+static void report(const char* importer, const size_t bytes,
+                   const import_result& r) {
+  if (!r.ok) {
+    printf("  %-8s failed\n", importer);
+    return;
+  }
+
+  printf("  %-8s %10.3f ms %9.1f MB/s %10zu vertices %10zu indices\n",
+         importer, r.best_ms,
+         static_cast<double>(bytes) / (1024.0 * 1024.0) /
+             std::max(r.best_ms * 1.0e-3, 1.0e-9),
+         r.vertex_count, r.index_count);
+}
+
+int main(int argc, char** argv) {
+  XR_LOGGER_START(argc, argv);
+
+  if (argc < 2) {
+    printf("Usage : %s file.obj|file.ply ...\n", argv[0]);
+    return 1;
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    const char* path = argv[i];
+    const auto  fmt  = native_model_format_from_path(path);
+
+    if (fmt == native_model_format::none) {
+      printf("%s : not an OBJ or PLY file, skipped\n", path);
+      continue;
+    }
+
+    string contents;
+    if (!read_file(path, &contents)) {
+      printf("%s : failed to read file, skipped\n", path);
+      continue;
+    }
+
+    printf("%s (%.2f MB)\n", path,
+           static_cast<double>(contents.size()) / (1024.0 * 1024.0));
+
+    const auto native = time_native(contents, fmt);
+    const auto assimp =
+        time_assimp(contents, fmt == native_model_format::obj ? "obj" : "ply");
+
+    report("native", contents.size(), native);
+    report("assimp", contents.size(), assimp);
+
+    if (native.ok && assimp.ok)
+      printf("  speedup  %10.2fx\n", assimp.best_ms / native.best_ms);
+  }
+
+  return 0;
+}
@@ -0,0 +1,156 @@
+//
+//  Blends N pairs of orientations, stored both as unit quaternions and as the
+//  equivalent rotation matrices :
+//  - slerp_n (quaternion_math_batch.hpp),
+//  - slerp, one element at a time,
+//  - slerp_n followed by the conversion to float4x4, so that the output is
+//    the same as the matrix path,
+//  - the float4x4 path : element wise lerp of the two matrices, followed by
+//    re-orthonormalization of the rotation part.
+//  Each method runs several times, the best time is reported.
+
+#include "xray/base/basic_timer.hpp"
+#include "xray/math/quaternion.hpp"
+#include "xray/math/quaternion_math.hpp"
+#include "xray/math/quaternion_math_batch.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/scalar4x4_math.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace xray::base;
+using namespace xray::math;
+using namespace std;
+
+static constexpr size_t   BLEND_COUNTS[] = {1024, 16384, 262144};
+static constexpr uint32_t RUNS           = 10;
+
+struct blend_inputs {
+  vector<quaternionf> qa;
+  vector<quaternionf> qb;
+  vector<float4x4>    ma;
+  vector<float4x4>    mb;
+  vector<float>       t;
+};
+
+static blend_inputs make_inputs(const size_t count) {
+  mt19937                          rng{0x5eed};
+  uniform_real_distribution<float> component{-1.0f, 1.0f};
+  uniform_real_distribution<float> factor{0.0f, 1.0f};
+
+  const auto random_rotation = [&]() {
+    return normalize(quaternionf{component(rng), component(rng),
+                                 component(rng), component(rng)});
+  };
+
+  blend_inputs in;
+  in.qa.reserve(count);
+  in.qb.reserve(count);
+  in.ma.reserve(count);
+  in.mb.reserve(count);
+  in.t.reserve(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    in.qa.push_back(random_rotation());
+    in.qb.push_back(random_rotation());
+    in.ma.push_back(to_scalar4x4(in.qa.back()));
+    in.mb.push_back(to_scalar4x4(in.qb.back()));
+    in.t.push_back(factor(rng));
+  }
+
+  return in;
+}
+
+static float4x4 lerp_rotation(const float4x4& a, const float4x4& b,
+                              const float t) noexcept {
+  auto m = a * (1.0f - t) + b * t;
+
+  //
+  //  Gram-Schmidt on the rows of the rotation part.
+  const auto r0 = normalize(float3{m.a00, m.a01, m.a02});
+  auto       r1 = float3{m.a10, m.a11, m.a12};
+  r1            = normalize(r1 - r0 * dot(r0, r1));
+  const auto r2 = cross(r0, r1);
+
+  m.a00 = r0.x, m.a01 = r0.y, m.a02 = r0.z;
+  m.a10 = r1.x, m.a11 = r1.y, m.a12 = r1.z;
+  m.a20 = r2.x, m.a21 = r2.y, m.a22 = r2.z;
+  return m;
+}
+
+//
+//  Runs fn RUNS times, returns the best time in milliseconds.
+template <typename blend_fn>
+static double best_time(blend_fn fn) {
+  double best{1.0e30};
+
+  for (uint32_t run = 0; run < RUNS; ++run) {
+    timer_highp timer;
+    timer.start();
+    fn();
+    timer.end();
+    best = std::min(best, timer.elapsed_millis());
+  }
+
+  return best;
+}
+
+static void report(const char* method, const size_t count, const double ms,
+                   const float checksum) {
+  printf("%-24s %8zu %10.3f ms %8.2f ns/blend (checksum %g)\n", method, count,
+         ms, ms * 1.0e6 / static_cast<double>(count), checksum);
+}
+
+int main() {
+  printf("%-24s %8s %13s %16s\n", "method", "count", "time", "per blend");
+
+  for (const auto count : BLEND_COUNTS) {
+    const auto in = make_inputs(count);
+
+    vector<quaternionf> q_out(count);
+    vector<float4x4>    m_out(count);
+
+    const auto q_checksum = [&q_out]() {
+      float sum{};
+      for (const auto& q : q_out)
+        sum += q.w + q.x + q.y + q.z;
+      return sum;
+    };
+
+    const auto m_checksum = [&m_out]() {
+      float sum{};
+      for (const auto& m : m_out)
+        sum += m.a00 + m.a11 + m.a22;
+      return sum;
+    };
+
+    auto ms = best_time([&]() { slerp_n(in.qa, in.qb, in.t, q_out); });
+    report("slerp_n", count, ms, q_checksum());
+
+    ms = best_time([&]() {
+      for (size_t i = 0; i < count; ++i)
+        q_out[i] = slerp(in.qa[i], in.qb[i], in.t[i]);
+    });
+    report("slerp (per element)", count, ms, q_checksum());
+
+    ms = best_time([&]() {
+      slerp_n(in.qa, in.qb, in.t, q_out);
+      for (size_t i = 0; i < count; ++i)
+        m_out[i] = to_scalar4x4(q_out[i]);
+    });
+    report("slerp_n + to_scalar4x4", count, ms, m_checksum());
+
+    ms = best_time([&]() {
+      for (size_t i = 0; i < count; ++i)
+        m_out[i] = lerp_rotation(in.ma[i], in.mb[i], in.t[i]);
+    });
+    report("float4x4 lerp + ortho", count, ms, m_checksum());
+  }
+
+  return 0;
+}
@@ -13,8 +13,8 @@
 #include "xray/rendering/draw_context.hpp"
 #include "xray/rendering/geometry/geometry_data.hpp"
 #include "xray/rendering/geometry/geometry_factory.hpp"
-#include "xray/rendering/opengl/shader_base.hpp"
-#include "xray/rendering/vertex_format/vertex_pn.hpp"
+#include "xray/rendering/opengl/program_binary_cache.hpp"
+#include "xray/rendering/vertex_format/vertex_format.hpp"
 #include "xray/scene/camera.hpp"
 #include <algorithm>
 #include <cmath>
@@ -66,91 +66,52 @@ void app::multiple_lights_demo::init() {
 
   geometry_factory::torus(0.7f, 0.3f, 30, 30, &obj_meshes[1]);
 
-  draw_info_[0].base_vertex = 0;
-  draw_info_[1].base_vertex = obj_meshes[0].vertex_count;
-  draw_info_[0].index_end   = obj_meshes[0].index_count;
-  draw_info_[1].index_start = obj_meshes[0].index_count;
-  draw_info_[1].index_end =
-      obj_meshes[0].index_count + obj_meshes[1].index_count;
-
-  vector<vertex_pn> vertices;
-  vertices.reserve(obj_meshes[0].vertex_count + obj_meshes[1].vertex_count);
-
-  gsl::span<vertex_pntt> input_vert_spans[] = {
-      {raw_ptr(obj_meshes[0].geometry),
-       static_cast<ptrdiff_t>(obj_meshes[0].vertex_count)},
-      {raw_ptr(obj_meshes[1].geometry),
-       static_cast<ptrdiff_t>(obj_meshes[1].vertex_count)}};
-
-  for (const auto& in_vtx_span : input_vert_spans) {
-    transform(begin(in_vtx_span), end(in_vtx_span), back_inserter(vertices),
-              [](const auto& in_vertex) {
-                return vertex_pn{in_vertex.position, in_vertex.normal};
+  //
+  //  Both objects share one vertex and index buffer, one submesh each.
+  geometry_data_t scene_geometry{
+      obj_meshes[0].vertex_count + obj_meshes[1].vertex_count,
+      obj_meshes[0].index_count + obj_meshes[1].index_count};
+
+  uint32_t base_vertex  = 0;
+  uint32_t index_offset = 0;
+
+  for (uint32_t idx = 0; idx < multiple_lights_demo::NUM_MESHES; ++idx) {
+    const auto& obj_mesh = obj_meshes[idx];
+
+    copy_n(raw_ptr(obj_mesh.geometry), obj_mesh.vertex_count,
+           raw_ptr(scene_geometry.geometry) + base_vertex);
+    transform(raw_ptr(obj_mesh.indices),
+              raw_ptr(obj_mesh.indices) + obj_mesh.index_count,
+              raw_ptr(scene_geometry.indices) + index_offset,
+              [base_vertex](const uint32_t index) {
+                return index + base_vertex;
               });
-  }
 
-  {
-    GLuint vbuff{0};
-    gl::CreateBuffers(1, &vbuff);
-    gl::NamedBufferStorage(vbuff, bytes_size(vertices), &vertices[0], 0);
-    unique_handle_reset(vertex_buff_, vbuff);
-  }
-
-  {
-    vector<uint32_t> indices;
-    indices.reserve(obj_meshes[0].index_count + obj_meshes[1].index_count);
-
-    {
-      const auto in_span = gsl::span<uint32_t>{
-          raw_ptr(obj_meshes[0].indices),
-          static_cast<ptrdiff_t>(obj_meshes[0].index_count)};
-      copy(begin(in_span), end(in_span), back_inserter(indices));
-    }
+    geometry_submesh submesh;
+    submesh.base_vertex    = base_vertex;
+    submesh.vertex_count   = static_cast<uint32_t>(obj_mesh.vertex_count);
+    submesh.index_offset   = index_offset;
+    submesh.index_count    = static_cast<uint32_t>(obj_mesh.index_count);
+    submesh.material_index = idx;
+    scene_geometry.submeshes.push_back(submesh);
 
-    {
-      const auto in_span = gsl::span<uint32_t>{
-          raw_ptr(obj_meshes[1].indices),
-          static_cast<ptrdiff_t>(obj_meshes[1].index_count)};
-      copy(begin(in_span), end(in_span), back_inserter(indices));
-    }
-
-    GLuint ibuff{0};
-    gl::CreateBuffers(1, &ibuff);
-    gl::NamedBufferStorage(ibuff, bytes_size(indices), &indices[0], 0);
-    unique_handle_reset(index_buff_, ibuff);
+    base_vertex += submesh.vertex_count;
+    index_offset += submesh.index_count;
   }
 
-  {
-    GLuint vao{};
-    gl::CreateVertexArrays(1, &vao);
-    gl::BindVertexArray(vao);
-
-    gl::BindBuffer(gl::ELEMENT_ARRAY_BUFFER, raw_handle(index_buff_));
-    gl::VertexArrayVertexBuffer(vao, 0, raw_handle(vertex_buff_), 0,
-                                sizeof(vertex_pn));
-
-    gl::EnableVertexArrayAttrib(vao, 0);
-    gl::EnableVertexArrayAttrib(vao, 1);
-
-    gl::VertexArrayAttribFormat(vao, 0, 3, gl::FLOAT, gl::FALSE_,
-                                XR_U32_OFFSETOF(vertex_pn, position));
-    gl::VertexArrayAttribFormat(vao, 1, 3, gl::FLOAT, gl::FALSE_,
-                                XR_U32_OFFSETOF(vertex_pn, normal));
-
-    gl::VertexArrayAttribBinding(vao, 0, 0);
-    gl::VertexArrayAttribBinding(vao, 1, 0);
-
-    unique_handle_reset(layout_, vao);
+  meshes_ = simple_mesh{vertex_format::pn, scene_geometry};
+  if (!meshes_) {
+    XR_LOG_CRITICAL("Failed to create meshes !!!");
+    return;
   }
 
   {
-    const GLuint compiled_shaders[] = {
-        make_shader(gl::VERTEX_SHADER,
-                    "shaders/cap4/multiple_lights/vert_shader.glsl"),
-        make_shader(gl::FRAGMENT_SHADER,
-                    "shaders/cap4/multiple_lights/frag_shader.glsl")};
+    const shader_source_file program_stages[] = {
+        {gl::VERTEX_SHADER, "shaders/cap4/multiple_lights/vert_shader.glsl"},
+        {gl::FRAGMENT_SHADER,
+         "shaders/cap4/multiple_lights/frag_shader.glsl"}};
 
-    draw_prog_ = gpu_program{compiled_shaders};
+    draw_prog_ = make_cached_gpu_program(program_stages);
     if (!draw_prog_) {
       XR_LOG_CRITICAL("Failed to link drawing program !!!");
       return;
@@ -234,8 +195,6 @@ void app::multiple_lights_demo::draw(
 
   assert(valid());
 
-  gl::BindVertexArray(raw_handle(layout_));
-
   //
   // Set shared uniforms
   {
@@ -266,13 +225,9 @@ void app::multiple_lights_demo::draw(
 
     draw_prog_.set_uniform_block("material_info", material::stdc::copper);
     draw_prog_.set_uniform_block("transforms", tf_uniform);
-    draw_prog_.bind_to_pipeline();
+    draw_prog_.bind_to_pipeline(dc.uniform_ring);
 
-    gl::DrawElementsBaseVertex(
-        gl::TRIANGLES, static_cast<GLsizei>(draw_info_[1].index_end -
-                                            draw_info_[1].index_start),
-        gl::UNSIGNED_INT, offset_cast<uint32_t>(draw_info_[1].index_start),
-        static_cast<GLint>(draw_info_[1].base_vertex));
+    meshes_.draw_submesh(1);
   }
 
   {
@@ -285,51 +240,8 @@ void app::multiple_lights_demo::draw(
 
     draw_prog_.set_uniform_block("material_info", material::stdc::gold);
     draw_prog_.set_uniform_block("transforms", tf_uniform);
-    draw_prog_.bind_to_pipeline();
+    draw_prog_.bind_to_pipeline(dc.uniform_ring);
 
-    gl::DrawElementsBaseVertex(
-        gl::TRIANGLES, static_cast<GLsizei>(draw_info_[0].index_end -
-                                            draw_info_[0].index_start),
-        gl::UNSIGNED_INT, offset_cast<uint32_t>(draw_info_[0].index_start),
-        static_cast<GLint>(draw_info_[0].base_vertex));
+    meshes_.draw_submesh(0);
   }
-
-  //  auto draw_fn_option_draw = [this]() {
-
-  //    for (const auto &drw_info : draw_info_) {
-  //      const GLsizei index_count =
-  //          static_cast<GLsizei>(drw_info.index_end - drw_info.index_start);
-  //      const auto ib_offset = static_cast<const char *>(nullptr) +
-  //                             drw_info.index_start * sizeof(uint32_t);
-
-  //      gl::DrawElementsBaseVertex(gl::TRIANGLES, index_count,
-  //      gl::UNSIGNED_INT,
-  //                                 ib_offset,
-  //                                 static_cast<GLint>(drw_info.base_vertex));
-  //    }
-  //  };
-
-  //  //  draw_fn_option_draw();
-
-  //  auto draw_fn_option_multidraw = [this]() {
-  //    const GLsizei index_count[] = {
-  //        static_cast<GLsizei>(draw_info_[0].index_end -
-  //                             draw_info_[0].index_start),
-  //        static_cast<GLsizei>(draw_info_[1].index_end -
-  //                             draw_info_[1].index_start)};
-
-  //    const void *ib_offets[] = {
-  //        offset_cast<uint32_t>(draw_info_[0].index_start),
-  //        offset_cast<uint32_t>(draw_info_[1].index_start)};
-
-  //    const GLint base_vertices[] = {
-  //        static_cast<GLint>(draw_info_[0].base_vertex),
-  //        static_cast<GLint>(draw_info_[1].base_vertex)};
-
-  //    gl::MultiDrawElementsBaseVertex(gl::TRIANGLES, index_count,
-  //                                    gl::UNSIGNED_INT, ib_offets, 2,
-  //                                    base_vertices);
-  //  };
-
-  //  draw_fn_option_multidraw();
 }
@@ -31,6 +31,7 @@
 #include "xray/xray.hpp"
 #include "light_source.hpp"
 #include "material.hpp"
+#include "xray/rendering/mesh.hpp"
 #include "xray/rendering/opengl/gl_handles.hpp"
 #include "xray/rendering/opengl/gpu_program.hpp"
 #include "xray/rendering/rendering_fwd.hpp"
@@ -38,12 +39,6 @@
 
 namespace app {
 
-struct mesh_draw_info {
-  uint32_t      base_vertex{0};
-  uint32_t      index_start{0};
-  uint32_t      index_end{0};
-};
-
 class multiple_lights_demo {
 public:
   static constexpr uint32_t NUM_LIGHTS = 5;
@@ -65,11 +60,9 @@ private:
   void init();
 
 private:
-  xray::rendering::scoped_buffer vertex_buff_;
-  xray::rendering::scoped_buffer index_buff_;
-  xray::rendering::scoped_vertex_array    layout_;
-  xray::rendering::gpu_program          draw_prog_;
-  mesh_draw_info draw_info_[multiple_lights_demo::NUM_MESHES];
+  ///< One submesh per object.
+  xray::rendering::simple_mesh meshes_;
+  xray::rendering::gpu_program draw_prog_;
   light_source2  lights_[NUM_LIGHTS];
   bool           valid_{false};
   float         _rot_angle_x{};
@@ -271,7 +271,7 @@ void app::spotlight_demo::draw(const xray::rendering::draw_context_t &dc) {
 
     _draw_prog.set_uniform_block("obj_matrix_pack", transform_pack);
     _draw_prog.set_uniform_block("object_material", mesh.mat);
-    _draw_prog.bind_to_pipeline();
+    _draw_prog.bind_to_pipeline(dc.uniform_ring);
 
     gl::DrawElementsBaseVertex(gl::TRIANGLES, mesh.index_count,
                                gl::UNSIGNED_INT,
@@ -60,7 +60,9 @@ void app::edge_detect_demo::draw(const xray::rendering::draw_context_t& dc) {
     } const obj_transforms{obj_to_view, obj_to_view,
                            dc.projection_matrix * obj_to_view};
 
-    _drawprog_first_pass.set_uniform_block("transform_pack", obj_transforms);
+    const auto& uniforms = _first_pass_uniforms;
+    _drawprog_first_pass.set_uniform_block(uniforms.transform_pack,
+                                           obj_transforms);
 
     point_light lights[edge_detect_demo::max_lights];
     transform(begin(_lights), end(_lights), begin(lights),
@@ -69,11 +71,11 @@ void app::edge_detect_demo::draw(const xray::rendering::draw_context_t& dc) {
                         mul_point(dc.view_matrix, in_light.position)};
               });
 
-    _drawprog_first_pass.set_uniform_block("scene_lighting", lights);
-    _drawprog_first_pass.set_uniform("light_count", _lightcount);
-    _drawprog_first_pass.set_uniform("mat_diffuse", 0);
-    _drawprog_first_pass.set_uniform("mat_specular", 1);
-    _drawprog_first_pass.set_uniform("mat_shininess", _mat_spec_pwr);
+    _drawprog_first_pass.set_uniform_block(uniforms.scene_lighting, lights);
+    _drawprog_first_pass.set_uniform(uniforms.light_count, _lightcount);
+    _drawprog_first_pass.set_uniform(uniforms.mat_diffuse, 0);
+    _drawprog_first_pass.set_uniform(uniforms.mat_specular, 1);
+    _drawprog_first_pass.set_uniform(uniforms.mat_shininess, _mat_spec_pwr);
     _drawprog_first_pass.bind_to_pipeline();
 
     {
@@ -84,16 +86,18 @@ void app::edge_detect_demo::draw(const xray::rendering::draw_context_t& dc) {
     }
 
     {
-      const GLuint materials[] = {raw_handle(_obj_material),
-                                  raw_handle(_obj_material)};
+      const GLuint materials[] = {_assets.texture(_obj_material),
+                                  _assets.texture(_obj_material)};
       gl::BindTextures(0, XR_I32_COUNTOF__(materials), materials);
     }
 
-    _object.draw();
+    _assets.mesh(_object).draw();
   }
 }
 
-void app::edge_detect_demo::update(const float /*delta_ms*/) {}
+void app::edge_detect_demo::update(const float /*delta_ms*/) {
+  _assets.process_uploads();
+}
 
 void app::edge_detect_demo::key_event(const int32_t /*key_code*/,
                                       const int32_t /*action*/,
@@ -165,6 +169,34 @@ void app::edge_detect_demo::init() {
     return gpu_program{compiled_shaders};
   }();
 
+  if (!_drawprog_first_pass) {
+    XR_LOG_ERR("Failed to create first pass program!");
+    return;
+  }
+
+  _first_pass_uniforms.transform_pack =
+      _drawprog_first_pass.uniform_block_handle("transform_pack"_hashed);
+  _first_pass_uniforms.scene_lighting =
+      _drawprog_first_pass.uniform_block_handle("scene_lighting"_hashed);
+  _first_pass_uniforms.light_count =
+      _drawprog_first_pass.uniform_handle("light_count"_hashed);
+  _first_pass_uniforms.mat_diffuse =
+      _drawprog_first_pass.uniform_handle("mat_diffuse"_hashed);
+  _first_pass_uniforms.mat_specular =
+      _drawprog_first_pass.uniform_handle("mat_specular"_hashed);
+  _first_pass_uniforms.mat_shininess =
+      _drawprog_first_pass.uniform_handle("mat_shininess"_hashed);
+
+  {
+    const auto& uniforms = _first_pass_uniforms;
+    if (!uniforms.transform_pack.valid() || !uniforms.scene_lighting.valid() ||
+        !uniforms.light_count.valid() || !uniforms.mat_diffuse.valid() ||
+        !uniforms.mat_specular.valid() || !uniforms.mat_shininess.valid()) {
+      XR_LOG_ERR("First pass program is missing uniforms!");
+      return;
+    }
+  }
+
   config_file app_cfg{"config/cap6/edge_detect/app.conf"};
   if (!app_cfg) {
     XR_LOG_ERR("Fatal error : config file not found !");
@@ -178,12 +210,10 @@ void app::edge_detect_demo::init() {
       return;
     }
 
-    _object =
-        simple_mesh{vertex_format::pnt, xr_app_config->model_path(model_file)};
-    if (!_object) {
-      XR_LOG_ERR("Failed to load model from file!");
-      return;
-    }
+    //
+    //  Drawn as a placeholder until loaded, see update().
+    _object = _assets.load_mesh(vertex_format::pnt,
+                                xr_app_config->model_path(model_file));
   }
 
   {
@@ -203,33 +233,21 @@ void app::edge_detect_demo::init() {
     }
   }
 
-  _obj_material = [&app_cfg]() {
+  {
     const char* material_file{};
     app_cfg.lookup_value("app.scene.material.file", material_file);
-    if (!material_file)
-      return GLuint{};
+    if (!material_file) {
+      XR_LOG_ERR("Material file not defined in config file!");
+      return;
+    }
 
     bool flip_yaxis{false};
     app_cfg.lookup_value("app.scene.material.flip_y", flip_yaxis);
 
-    texture_loader tex_ldr{xr_app_config->texture_path(material_file),
-                           flip_yaxis ? texture_load_options::flip_y
-                                      : texture_load_options::none};
-    if (!tex_ldr)
-      return GLuint{};
-
-    GLuint texh{};
-    gl::CreateTextures(gl::TEXTURE_2D, 1, &texh);
-    constexpr uint32_t internal_format[] = {gl::RGB8, gl::RGBA8};
-    gl::TextureStorage2D(texh, 1, internal_format[tex_ldr.depth() == 4],
-                         tex_ldr.width(), tex_ldr.height());
-    constexpr uint32_t img_format[] = {gl::RGB, gl::RGBA};
-    gl::TextureSubImage2D(texh, 0, 0, 0, tex_ldr.width(), tex_ldr.height(),
-                          img_format[tex_ldr.depth() == 4], gl::UNSIGNED_BYTE,
-                          tex_ldr.data());
-
-    return texh;
-  }();
+    _obj_material = _assets.load_texture(
+        xr_app_config->texture_path(material_file),
+        flip_yaxis ? texture_load_options::flip_y : texture_load_options::none);
+  }
 
   //  _obj_diffuse_map = [&app_cfg]() {
   //    const char* file_name{};
@@ -33,6 +33,7 @@
 #include "material.hpp"
 #include "xray/math/scalar2.hpp"
 #include "xray/math/scalar3.hpp"
+#include "xray/rendering/asset_loader.hpp"
 #include "xray/rendering/colors/rgb_color.hpp"
 #include "xray/rendering/mesh.hpp"
 #include "xray/rendering/opengl/gl_handles.hpp"
@@ -70,13 +71,25 @@ private:
     xray::rendering::scoped_texture      fbo_texture;
     xray::rendering::scoped_sampler      fbo_sampler;
   } _fbo;
-  xray::rendering::gpu_program    _drawprog_first_pass;
-  xray::rendering::simple_mesh    _object;
-  xray::rendering::scoped_texture _obj_material;
-  xray::rendering::scoped_texture _obj_diffuse_map;
-  xray::scene::point_light        _lights[edge_detect_demo::max_lights];
-  uint32_t                        _lightcount{2};
-  float                           _mat_spec_pwr{50.0f};
+  xray::rendering::gpu_program          _drawprog_first_pass;
+
+  ///< Uniforms of the first pass, resolved once in init().
+  struct first_pass_uniforms {
+    xray::rendering::gpu_uniform_block_handle transform_pack;
+    xray::rendering::gpu_uniform_block_handle scene_lighting;
+    xray::rendering::gpu_uniform_handle       light_count;
+    xray::rendering::gpu_uniform_handle       mat_diffuse;
+    xray::rendering::gpu_uniform_handle       mat_specular;
+    xray::rendering::gpu_uniform_handle       mat_shininess;
+  } _first_pass_uniforms;
+
+  xray::rendering::asset_loader         _assets;
+  xray::rendering::async_mesh_handle    _object;
+  xray::rendering::async_texture_handle _obj_material;
+  xray::rendering::scoped_texture       _obj_diffuse_map;
+  xray::scene::point_light _lights[edge_detect_demo::max_lights];
+  uint32_t                 _lightcount{2};
+  float                    _mat_spec_pwr{50.0f};
 
 private:
   XRAY_NO_COPY(edge_detect_demo);
@@ -114,6 +114,12 @@ void app::fractal_painter::init() {
     quad_draw_prg_ = gpu_program{attached_shaders};
     if (!quad_draw_prg_)
       return;
+
+    fractal_params_block_ =
+        quad_draw_prg_.uniform_block_handle("fractal_params"_hashed);
+
+    if (!fractal_params_block_.valid())
+      return;
   }
 
   initialized_ = true;
@@ -128,7 +134,7 @@ void app::fractal_painter::draw(const xray::ui::window_context& wnd_ctx) {
   fp_.shape_re   = kNiceShapes[shape_idx_ % XR_COUNTOF__(kNiceShapes)].x;
   fp_.shape_im   = kNiceShapes[shape_idx_ % XR_COUNTOF__(kNiceShapes)].y;
 
-  quad_draw_prg_.set_uniform_block("fractal_params", fp_);
+  quad_draw_prg_.set_uniform_block(fractal_params_block_, fp_);
 
   gl::BindBuffer(gl::ELEMENT_ARRAY_BUFFER, raw_handle(quad_ib_));
   gl::BindVertexArray(raw_handle(quad_layout_));
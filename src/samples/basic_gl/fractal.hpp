@@ -43,6 +43,7 @@ private:
   xray::rendering::scoped_buffer quad_ib_;
   xray::rendering::scoped_vertex_array    quad_layout_;
   xray::rendering::gpu_program          quad_draw_prg_;
+  xray::rendering::gpu_uniform_block_handle fractal_params_block_;
   bool                                  initialized_{false};
   uint32_t                              shape_idx_{0u};
   uint32_t                              iter_sel_{5u};
@@ -39,6 +39,8 @@
 #include "xray/math/transforms_r3.hpp"
 #include "xray/rendering/colors/rgb_color.hpp"
 #include "xray/rendering/draw_context.hpp"
+#include "xray/rendering/opengl/gpu_program.hpp"
+#include "xray/rendering/opengl/uniform_ring_buffer.hpp"
 #include "xray/scene/camera.hpp"
 #include "xray/scene/camera_controller_spherical_coords.hpp"
 #include "xray/scene/config_reader_scene.hpp"
@@ -87,6 +89,8 @@ private:
   static constexpr const char* controller_cfg_file_path =
       "config/cam_controller_spherical.conf";
 
+  static constexpr uint32_t uniform_ring_frame_bytes = 256 * 1024;
+
   using compose_ui_event = xray::base::fast_delegate<void(void)>;
 
   struct {
@@ -95,6 +99,8 @@ private:
 
   void setup_ui();
 
+  void compose_stats_ui();
+
 private:
   bool initialized_{false};
   //  lit_object                                      obj_;
@@ -115,12 +121,15 @@ private:
   //  render_texture_demo                             obj_;
   edge_detect_demo                                obj_;
   xray::rendering::draw_context_t                 draw_ctx_;
+  xray::rendering::uniform_ring_buffer            _uniform_ring{
+      uniform_ring_frame_bytes};
   xray::scene::camera                             cam_;
   xray::scene::camera_controller_spherical_coords cam_control_{
       &cam_, controller_cfg_file_path};
   xray::ui::imgui_backend                      _ui;
   xray::base::stats_thread                     _stats_collector;
   xray::base::stats_thread::process_stats_info _proc_stats;
+  xray::rendering::uniform_upload_stats         _upload_stats;
   bool                                         _ui_active{false};
   basic_window*                                _appwnd;
   rgb_color _clear_color{0.0f, 0.0f, 0.0f, 1.0f};
@@ -146,6 +155,7 @@ basic_scene::basic_scene(basic_window* app_wnd) : _appwnd{app_wnd} {
       1000.0f));
 
   draw_ctx_.active_camera = &cam_;
+  draw_ctx_.uniform_ring  = _uniform_ring ? &_uniform_ring : nullptr;
 
   gl::Viewport(0, 0, static_cast<int32_t>(draw_ctx_.window_width),
                static_cast<int32_t>(draw_ctx_.window_height));
@@ -191,6 +201,8 @@ void basic_scene::tick_event(const float delta) {
 
     if (events.compose_ui)
       events.compose_ui();
+
+    compose_stats_ui();
   }
 
   obj_.update(delta);
@@ -202,10 +214,19 @@ void basic_scene::draw(const xray::ui::window_context& /* wnd_ctx */) {
   gl::ClearDepth(1.0f);
   gl::Clear(gl::COLOR_BUFFER_BIT | gl::DEPTH_BUFFER_BIT);
 
+  if (draw_ctx_.uniform_ring)
+    draw_ctx_.uniform_ring->begin_frame();
+
   obj_.draw(draw_ctx_);
   if (_ui_active) {
     _ui.draw_event(draw_ctx_);
   }
+
+  if (draw_ctx_.uniform_ring)
+    draw_ctx_.uniform_ring->end_frame();
+
+  _upload_stats = gpu_program::upload_stats();
+  gpu_program::reset_upload_stats();
 }
 
 void basic_scene::input_event(
@@ -253,6 +274,17 @@ void basic_scene::setup_ui() {
   ImGui::SliderFloat("Blue", &_clear_color.b, 0.0f, 1.0f, "%3.3f");
   ImGui::End();
 }
+
+void basic_scene::compose_stats_ui() {
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 120.0f), ImGuiSetCond_FirstUseEver);
+  ImGui::Begin("Uniform uploads (last frame)");
+  ImGui::Text("Bytes uploaded : %u",
+              static_cast<uint32_t>(_upload_stats.bytes_uploaded));
+  ImGui::Text("Dirty block bytes : %u",
+              static_cast<uint32_t>(_upload_stats.dirty_block_bytes));
+  ImGui::Text("Ranges : %u", _upload_stats.ranges_uploaded);
+  ImGui::End();
+}
 }
 
 template <typename enter_fn, typename exit_fn>
@@ -0,0 +1,118 @@
+//
+//  Checks the SSE/AVX float4x4 overloads (scalar4x4_math_simd.hpp) against
+//  the generic templates, on random matrices. The SIMD code is documented as
+//  bit identical to the generic code, so results are compared exactly.
+
+#include "xray/math/scalar3x3.hpp"
+#include "xray/math/scalar4x4.hpp"
+#include "xray/math/scalar4x4_math.hpp"
+#include "xray/math/transforms_r3.hpp"
+#include "xray/math/transforms_r4.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#if defined(XRAY_MATH_SIMD_AVX) && (defined(__GNUC__) || defined(__clang__))
+#define XRAY_TEST_CHECK_AVX_SUPPORT
+#endif
+
+using namespace xray::math;
+using namespace std;
+
+static constexpr uint32_t MATRIX_COUNT = 10000;
+
+static uint32_t failures{};
+
+static void check(const char* op, const uint32_t iteration,
+                  const float4x4& simd, const float4x4& generic) {
+  if (memcmp(simd.components, generic.components, sizeof(generic)) == 0)
+    return;
+
+  if (++failures > 10)
+    return;
+
+  printf("%s mismatch (matrix %u) :\n", op, iteration);
+  for (size_t idx = 0; idx < 16; ++idx) {
+    printf("  [%2zu] %.9g %.9g\n", idx, simd.components[idx],
+           generic.components[idx]);
+  }
+}
+
+static void check(const char* op, const uint32_t iteration,
+                  const float3& simd, const float3& generic) {
+  if (simd.x == generic.x && simd.y == generic.y && simd.z == generic.z)
+    return;
+
+  if (++failures > 10)
+    return;
+
+  printf("%s mismatch (point %u) : (%.9g %.9g %.9g) (%.9g %.9g %.9g)\n", op,
+         iteration, simd.x, simd.y, simd.z, generic.x, generic.y, generic.z);
+}
+
+static const char* simd_path() noexcept {
+#if defined(XRAY_MATH_SIMD_AVX)
+  return "AVX";
+#elif defined(XRAY_MATH_SIMD_SSE)
+  return "SSE";
+#else
+  return "none";
+#endif
+}
+
+int main() {
+#if defined(XRAY_TEST_CHECK_AVX_SUPPORT)
+  if (!__builtin_cpu_supports("avx")) {
+    printf("AVX not supported by this CPU, skipped.\n");
+    return 0;
+  }
+#endif
+
+  mt19937                          rng{0x5eed};
+  uniform_real_distribution<float> value{-10.0f, 10.0f};
+  uniform_real_distribution<float> angle{-3.14159265f, 3.14159265f};
+
+  const auto random_matrix = [&]() {
+    float4x4 m;
+    for (auto& c : m.components)
+      c = value(rng);
+    return m;
+  };
+
+  for (uint32_t i = 0; i < MATRIX_COUNT; ++i) {
+    const auto a = random_matrix();
+    const auto b = random_matrix();
+
+    //
+    //  Explicit template arguments select the generic versions.
+    check("multiply", i, a * b, operator*<float>(a, b));
+    check("transpose", i, transpose(a), transpose<float>(a));
+
+    if (std::abs(determinant(a)) > 1.0e-3f)
+      check("invert", i, invert(a), invert<float>(a));
+
+    //
+    //  Affine transforms, composed with the product and applied to points.
+    const auto rotation = float4x4{
+        R3::rotate_xyz(angle(rng), angle(rng), angle(rng))};
+    const auto translation =
+        R4::translate(value(rng), value(rng), value(rng));
+
+    const auto tf         = translation * rotation;
+    const auto tf_generic = operator*<float>(translation, rotation);
+    check("transform", i, tf, tf_generic);
+
+    const float3 pt{value(rng), value(rng), value(rng)};
+    check("transform point", i, mul_point(tf, pt), mul_point(tf_generic, pt));
+    check("transform vector", i, mul_vec(tf, pt), mul_vec(tf_generic, pt));
+
+    check("affine invert", i, affine_invert(tf), affine_invert<float>(tf));
+  }
+
+  printf("float4x4 SIMD (%s) vs generic : %u matrices, %u failures\n",
+         simd_path(), MATRIX_COUNT, failures);
+
+  return failures == 0 ? 0 : 1;
+}
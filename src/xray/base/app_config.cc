@@ -17,11 +17,13 @@ xray::base::app_config::app_config(const char* cfg_path /*= nullptr*/) {
 
   //
   // set come defaults
-  paths_.model_path       = "assets/models";
-  paths_.texture_path     = "assets/textures";
-  paths_.shader_path      = "assets/shaders";
-  paths_.camera_cfg_path  = "config/camera";
-  paths_.objects_cfg_path = "config/objects";
+  paths_.model_path         = "assets/models";
+  paths_.texture_path       = "assets/textures";
+  paths_.shader_path        = "assets/shaders";
+  paths_.camera_cfg_path    = "config/camera";
+  paths_.objects_cfg_path   = "config/objects";
+  paths_.cache_path         = "cache";
+  paths_.program_cache_path = "cache/programs";
 
   const auto config_file_path = cfg_path ? cfg_path : "config/app_config.conf";
 
@@ -31,6 +33,14 @@ xray::base::app_config::app_config(const char* cfg_path /*= nullptr*/) {
     return;
   }
 
+  {
+    const char* profile_name{nullptr};
+    if (app_conf_file.lookup_value("import.mesh_profile", profile_name) &&
+        profile_name) {
+      mesh_import_profile_ = profile_name;
+    }
+  }
+
   const char* root_dir = nullptr;
 
   constexpr const char* const ROOT_DIR_ENTRY =
@@ -67,7 +77,9 @@ xray::base::app_config::app_config(const char* cfg_path /*= nullptr*/) {
       {"directories.shader_configs", &paths_.shader_cfg_path},
       {"directories.camera_configs", &paths_.camera_cfg_path},
       {"directories.object_configs", &paths_.objects_cfg_path},
-      {"directories.engine_ini", &paths_.engine_ini_file}};
+      {"directories.engine_ini", &paths_.engine_ini_file},
+      {"directories.cache", &paths_.cache_path},
+      {"directories.program_cache", &paths_.program_cache_path}};
 
   for (auto& path_load_info : paths_to_load) {
     const char* path_value{nullptr};
@@ -95,6 +107,26 @@ xray::base::app_config::app_config(const char* cfg_path /*= nullptr*/) {
     path_load_info.path->push(loaded_path);
   }
 
+  //
+  //  Unless configured, program binaries go in a directory of the cache.
+  {
+    const char* program_cache{nullptr};
+    if (!app_conf_file.lookup_value("directories.program_cache",
+                                    program_cache) ||
+        !program_cache) {
+      paths_.program_cache_path = paths_.cache_path;
+      paths_.program_cache_path.push("programs");
+    }
+  }
+
+  //
+  //  The caches only hold generated files, create them if missing.
+  for (const auto cache_dir :
+       {paths_.cache_path.c_str(), paths_.program_cache_path.c_str()}) {
+    if (!platformstl::filesystem_traits<char>::is_directory(cache_dir))
+      platformstl::filesystem_traits<char>::create_directory(cache_dir);
+  }
+
   XR_LOG_INFO("Dumping configured directories/paths :");
   for (const auto& pi : paths_to_load) {
     XR_LOG_INFO("{} = {}", pi.conf_file_entry_name, pi.path->c_str());
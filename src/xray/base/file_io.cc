@@ -0,0 +1,77 @@
+#include "xray/base/file_io.hpp"
+#include "xray/base/logger.hpp"
+#include <cassert>
+#include <cstdio>
+#include <memory>
+
+using namespace std;
+
+struct file_closer {
+  void operator()(FILE* fp) const noexcept {
+    if (fp)
+      fclose(fp);
+  }
+};
+
+bool xray::base::read_file(const char* path, std::string* contents) {
+  assert(path != nullptr);
+  assert(contents != nullptr);
+
+  unique_ptr<FILE, file_closer> fp{fopen(path, "rb")};
+  if (!fp)
+    return false;
+
+  if (fseek(fp.get(), 0, SEEK_END) != 0)
+    return false;
+
+  const auto file_size = ftell(fp.get());
+  if (file_size < 0 || fseek(fp.get(), 0, SEEK_SET) != 0)
+    return false;
+
+  contents->resize(static_cast<size_t>(file_size));
+  return file_size == 0 ||
+         fread(&(*contents)[0], 1, contents->size(), fp.get()) ==
+             contents->size();
+}
+
+bool xray::base::atomic_write_file(const char*             path,
+                                   const file_write_chunk* chunks,
+                                   const size_t            chunks_count) {
+  assert(path != nullptr);
+  assert(chunks != nullptr || chunks_count == 0);
+
+  const string tmp_file{string{path} + ".tmp"};
+
+  {
+    unique_ptr<FILE, file_closer> fp{fopen(tmp_file.c_str(), "wb")};
+    if (!fp) {
+      XR_LOG_ERR("Failed to create file {}", tmp_file);
+      return false;
+    }
+
+    bool ok = true;
+    for (size_t idx = 0; ok && idx < chunks_count; ++idx) {
+      ok = chunks[idx].bytes == 0 ||
+           fwrite(chunks[idx].data, 1, chunks[idx].bytes, fp.get()) ==
+               chunks[idx].bytes;
+    }
+
+    if (!ok || fflush(fp.get()) != 0) {
+      XR_LOG_ERR("Failed to write file {}", tmp_file);
+      fp.reset();
+      remove(tmp_file.c_str());
+      return false;
+    }
+  }
+
+  //
+  //  rename() does not replace existing files on every platform.
+  remove(path);
+  if (rename(tmp_file.c_str(), path) != 0) {
+    XR_LOG_ERR("Failed to rename {} to {}", tmp_file, path);
+    remove(tmp_file.c_str());
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,194 @@
+#include "xray/rendering/asset_loader.hpp"
+#include "xray/base/logger.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/math_std.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/geometry/geometry_factory.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <limits>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::rendering;
+
+//
+//  Result of a job, handed from a worker to the render thread.
+struct xray::rendering::asset_loader::pending_upload {
+  enum class asset_kind { mesh, texture };
+
+  asset_kind       kind;
+  uint32_t         id;
+  bool             loaded{false};
+  simple_mesh_data mesh_data;
+  texture_loader   image;
+};
+
+xray::rendering::asset_loader::asset_loader() {
+  _placeholder_texture = []() {
+    const uint8_t grey_texel[] = {128, 128, 128, 255};
+
+    GLuint texh{};
+    gl::CreateTextures(gl::TEXTURE_2D, 1, &texh);
+    gl::TextureStorage2D(texh, 1, gl::RGBA8, 1, 1);
+    gl::TextureSubImage2D(texh, 0, 0, 0, 1, 1, gl::RGBA, gl::UNSIGNED_BYTE,
+                          grey_texel);
+    return texh;
+  }();
+}
+
+xray::rendering::asset_loader::~asset_loader() {
+  _jobs.wait();
+
+  pending_upload* job{};
+  while (_completed.try_pop(job))
+    delete job;
+}
+
+async_mesh_handle xray::rendering::asset_loader::load_mesh(
+    const vertex_format fmt, const char* file_path,
+    const uint32_t load_options) {
+  assert(file_path != nullptr);
+
+  const auto id = static_cast<uint32_t>(_meshes.size());
+  _meshes.emplace_back();
+  _meshes.back().fmt = fmt;
+  ++_pending;
+
+  _jobs.run([ this, id, fmt, path = string{file_path}, load_options ]() {
+    unique_pointer<pending_upload> job{new pending_upload{}};
+    job->kind   = pending_upload::asset_kind::mesh;
+    job->id     = id;
+    job->loaded = simple_mesh_data::from_file(fmt, path.c_str(), load_options,
+                                              &job->mesh_data);
+
+    _completed.push(unique_pointer_release(job));
+  });
+
+  return {id};
+}
+
+async_texture_handle xray::rendering::asset_loader::load_texture(
+    const char* file_path, const texture_load_options opts) {
+  assert(file_path != nullptr);
+
+  const auto id = static_cast<uint32_t>(_textures.size());
+  _textures.emplace_back();
+  ++_pending;
+
+  _jobs.run([ this, id, path = string{file_path}, opts ]() {
+    unique_pointer<pending_upload> job{new pending_upload{}};
+    job->kind   = pending_upload::asset_kind::texture;
+    job->id     = id;
+    job->image  = texture_loader{path.c_str(), opts};
+    job->loaded = static_cast<bool>(job->image);
+
+    _completed.push(unique_pointer_release(job));
+  });
+
+  return {id};
+}
+
+size_t xray::rendering::asset_loader::process_uploads(const float budget_ms) {
+  using clock_type = chrono::high_resolution_clock;
+
+  const auto start = clock_type::now();
+  size_t     uploaded{};
+
+  pending_upload* completed_job{};
+  while (_completed.try_pop(completed_job)) {
+    unique_pointer<pending_upload> job{completed_job};
+    upload(*job);
+    ++uploaded;
+
+    const chrono::duration<float, milli> elapsed{clock_type::now() - start};
+    if (elapsed.count() >= budget_ms)
+      break;
+  }
+
+  return uploaded;
+}
+
+void xray::rendering::asset_loader::finish() {
+  _jobs.wait();
+  process_uploads(numeric_limits<float>::max());
+}
+
+void xray::rendering::asset_loader::upload(pending_upload& job) {
+  assert(_pending != 0);
+  --_pending;
+
+  if (job.kind == pending_upload::asset_kind::mesh) {
+    auto& slot = _meshes[job.id];
+
+    if (job.loaded)
+      slot.mesh = simple_mesh{job.mesh_data};
+
+    slot.state = slot.mesh ? asset_state::resident : asset_state::failed;
+    return;
+  }
+
+  auto& slot = _textures[job.id];
+
+  if (job.loaded) {
+    const auto& img = job.image;
+
+    //
+    //  stb returns 1 to 4 (8 bit) components per texel.
+    const GLenum internal_formats[] = {gl::R8, gl::RG8, gl::RGB8, gl::RGBA8};
+    const GLenum image_formats[]    = {gl::RED, gl::RG, gl::RGB, gl::RGBA};
+    const auto   fmt_idx =
+        static_cast<size_t>(xray::math::clamp(img.depth(), 1, 4) - 1);
+
+    slot.texture = [&]() {
+      GLuint texh{};
+      gl::CreateTextures(gl::TEXTURE_2D, 1, &texh);
+      gl::TextureStorage2D(texh, 1, internal_formats[fmt_idx], img.width(),
+                           img.height());
+
+      //
+      //  Rows of RGB images are not 4 byte aligned.
+      gl::PixelStorei(gl::UNPACK_ALIGNMENT, 1);
+      gl::TextureSubImage2D(texh, 0, 0, 0, img.width(), img.height(),
+                            image_formats[fmt_idx], gl::UNSIGNED_BYTE,
+                            img.data());
+      gl::PixelStorei(gl::UNPACK_ALIGNMENT, 4);
+
+      return texh;
+    }();
+  }
+
+  slot.state = slot.texture ? asset_state::resident : asset_state::failed;
+}
+
+simple_mesh&
+xray::rendering::asset_loader::mesh(const async_mesh_handle mh) {
+  auto& slot = _meshes[mh.id];
+  if (slot.state == asset_state::resident)
+    return slot.mesh;
+
+  auto placeholder =
+      find_if(begin(_placeholder_meshes), end(_placeholder_meshes),
+              [fmt = slot.fmt](const mesh_slot& ms) { return ms.fmt == fmt; });
+
+  if (placeholder != end(_placeholder_meshes))
+    return placeholder->mesh;
+
+  geometry_data_t cube;
+  geometry_factory::hexahedron(&cube);
+
+  _placeholder_meshes.emplace_back();
+  _placeholder_meshes.back().fmt   = slot.fmt;
+  _placeholder_meshes.back().state = asset_state::resident;
+  _placeholder_meshes.back().mesh  = simple_mesh{slot.fmt, cube};
+
+  return _placeholder_meshes.back().mesh;
+}
+
+GLuint xray::rendering::asset_loader::texture(
+    const async_texture_handle th) const noexcept {
+  const auto& slot = _textures[th.id];
+  return slot.state == asset_state::resident ? raw_handle(slot.texture)
+                                             : raw_handle(_placeholder_texture);
+}
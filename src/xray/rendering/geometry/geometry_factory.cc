@@ -1,5 +1,6 @@
 #include "xray/rendering/geometry/geometry_factory.hpp"
 #include "xray/base/array_dimension.hpp"
+#include "xray/base/basic_timer.hpp"
 #include "xray/base/debug/debug_ext.hpp"
 #include "xray/base/logger.hpp"
 #include "xray/base/unique_pointer.hpp"
@@ -10,17 +11,25 @@
 #include "xray/math/scalar3.hpp"
 #include "xray/math/scalar3_math.hpp"
 #include "xray/math/scalar3_math.hpp"
+#include "xray/rendering/geometry/geometry_bounds.hpp"
 #include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/geometry/geometry_import_native.hpp"
+#include "xray/rendering/geometry/geometry_normals.hpp"
+#include "xray/rendering/geometry/geometry_weld.hpp"
+#include "xray/rendering/mesh_cache.hpp"
+#include "xray/rendering/mesh_import_profile.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/cimport.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
 #include <platformstl/filesystem/memory_mapped_file.hpp>
 #include <span.h>
 #include <tbb/tbb.h>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -28,111 +37,70 @@ using namespace xray::base;
 using namespace xray::math;
 using namespace xray::rendering;
 
-static void
-compute_normals(xray::rendering::geometry_data_t* geometry) noexcept {
-  using namespace xray::math;
-
-  assert(geometry != nullptr);
-  assert((geometry->index_count % 3) == 0);
-
-  for (size_t idx = 0; idx < geometry->vertex_count; ++idx) {
-    geometry->geometry[idx].normal = float3::stdc::zero;
-  }
-
-  for (size_t tri_idx = 0; tri_idx < geometry->index_count / 3; ++tri_idx) {
-    const float3& p0 =
-        geometry->geometry[geometry->indices[tri_idx * 3 + 0]].position;
-    const float3& p1 =
-        geometry->geometry[geometry->indices[tri_idx * 3 + 1]].position;
-    const float3& p2 =
-        geometry->geometry[geometry->indices[tri_idx * 3 + 2]].position;
-
-    const float3 normal{cross(p1 - p0, p2 - p0)};
-
-    geometry->geometry[geometry->indices[tri_idx * 3 + 0]].normal += normal;
-    geometry->geometry[geometry->indices[tri_idx * 3 + 1]].normal += normal;
-    geometry->geometry[geometry->indices[tri_idx * 3 + 2]].normal += normal;
+//
+//  Returns the index of the vertex at the middle of the edge (i0, i1),
+//  creating it (projected onto the unit sphere) the first time the edge is
+//  seen. Both triangles sharing the edge get the same vertex.
+static uint32_t
+edge_midpoint(const uint32_t i0, const uint32_t i1,
+              std::vector<float3>*                    positions,
+              std::unordered_map<uint64_t, uint32_t>* midpoints) {
+  const auto key = i0 < i1 ? (uint64_t{i0} << 32) | i1
+                           : (uint64_t{i1} << 32) | i0;
+
+  const auto ins = midpoints->emplace(
+      key, static_cast<uint32_t>(positions->size()));
+
+  if (ins.second) {
+    const auto& p0 = (*positions)[i0];
+    const auto& p1 = (*positions)[i1];
+    positions->push_back(normalize(
+        float3{0.5f * (p0.x + p1.x), 0.5f * (p0.y + p1.y),
+               0.5f * (p0.z + p1.z)}));
   }
 
-  for (size_t idx = 0; idx < geometry->vertex_count; ++idx) {
-    geometry->geometry[idx].normal = normalize(geometry->geometry[idx].normal);
-  }
+  return ins.first->second;
 }
 
-static void subdivide_geometry(std::vector<vertex_pntt>* input_vertices,
-                               std::vector<uint32_t>*    input_indices) {
-  //
-  //  Save a copy of the input geometry.
-  vector<vertex_pntt> old_vertices{*input_vertices};
-  vector<uint32_t>    old_indices{*input_indices};
-
-  input_vertices->resize(0);
-  input_indices->resize(0);
-
-  /*
-      v1
-       .
-      / \
-     /   \
-  m0.-----.m1
-   / \   / \
-  /   \ /   \
-  .-----.-----.
-  v0    m2     v2
-
-   */
-
-  const uint32_t triangle_count = static_cast<uint32_t>(old_indices.size() / 3);
-
-  for (uint32_t i = 0; i < triangle_count; ++i) {
-    const auto& v0 = old_vertices[old_indices[i * 3 + 0]];
-    const auto& v1 = old_vertices[old_indices[i * 3 + 1]];
-    const auto& v2 = old_vertices[old_indices[i * 3 + 2]];
-
-    //
-    // Generate the midpoints.
-    vertex_pntt m0, m1, m2;
+//
+//  Splits every triangle into 4, reusing the midpoint of edges shared
+//  between triangles.
+/*
+    v1
+     .
+    / \
+   /   \
+m0.-----.m1
+ / \   / \
+/   \ /   \
+.-----.-----.
+v0    m2     v2
+ */
+static void subdivide_geometry(const std::vector<uint32_t>& input_indices,
+                               std::vector<float3>*         positions,
+                               std::vector<uint32_t>*       output_indices) {
+  const size_t triangle_count = input_indices.size() / 3;
 
-    // For subdivision, we just care about the position component.  We derive
-    // the other vertex_pntt components in CreateGeosphere.
+  //
+  //  Closed mesh : every edge is shared by 2 triangles.
+  std::unordered_map<uint64_t, uint32_t> midpoints;
+  midpoints.reserve(triangle_count * 3 / 2);
 
-    m0.position = float3{0.5f * (v0.position.x + v1.position.x),
-                         0.5f * (v0.position.y + v1.position.y),
-                         0.5f * (v0.position.z + v1.position.z)};
+  output_indices->resize(triangle_count * 12);
+  auto out = output_indices->data();
 
-    m1.position = float3{0.5f * (v1.position.x + v2.position.x),
-                         0.5f * (v1.position.y + v2.position.y),
-                         0.5f * (v1.position.z + v2.position.z)};
+  for (size_t i = 0; i < triangle_count; ++i) {
+    const auto v0 = input_indices[i * 3 + 0];
+    const auto v1 = input_indices[i * 3 + 1];
+    const auto v2 = input_indices[i * 3 + 2];
 
-    m2.position = float3{0.5f * (v0.position.x + v2.position.x),
-                         0.5f * (v0.position.y + v2.position.y),
-                         0.5f * (v0.position.z + v2.position.z)};
+    const auto m0 = edge_midpoint(v0, v1, positions, &midpoints);
+    const auto m1 = edge_midpoint(v1, v2, positions, &midpoints);
+    const auto m2 = edge_midpoint(v0, v2, positions, &midpoints);
 
-    //
-    // Add new geometry.
-
-    input_vertices->push_back(v0); // 0
-    input_vertices->push_back(v1); // 1
-    input_vertices->push_back(v2); // 2
-    input_vertices->push_back(m0); // 3
-    input_vertices->push_back(m1); // 4
-    input_vertices->push_back(m2); // 5
-
-    input_indices->push_back(i * 6 + 0);
-    input_indices->push_back(i * 6 + 5);
-    input_indices->push_back(i * 6 + 3);
-
-    input_indices->push_back(i * 6 + 3);
-    input_indices->push_back(i * 6 + 5);
-    input_indices->push_back(i * 6 + 4);
-
-    input_indices->push_back(i * 6 + 5);
-    input_indices->push_back(i * 6 + 2);
-    input_indices->push_back(i * 6 + 4);
-
-    input_indices->push_back(i * 6 + 3);
-    input_indices->push_back(i * 6 + 4);
-    input_indices->push_back(i * 6 + 1);
+    const uint32_t tris[] = {v0, m0, m2, m0, m1, m2,
+                             m2, m1, v2, m0, v1, m1};
+    out = std::copy(std::begin(tris), std::end(tris), out);
   }
 }
 
@@ -250,6 +218,8 @@ void xray::rendering::geometry_factory::cylinder(
       index_ptr = write_index_fn(i, j, index_ptr);
     }
   }
+
+  compute_bounds(cylinder);
 }
 
 void xray::rendering::geometry_factory::box(const float      width,
@@ -379,6 +349,8 @@ void xray::rendering::geometry_factory::box(const float      width,
   i[33] = 20;
   i[34] = 22;
   i[35] = 23;
+
+  compute_bounds(mesh_data);
 }
 
 // void xray::rendering::geometry_factory::create_conical_shape(
@@ -556,6 +528,8 @@ void xray::rendering::geometry_factory::grid(const float      grid_width,
       quad_idx += 6; // next quad
     }
   }
+
+  compute_bounds(mesh_data);
 }
 
 void xray::rendering::geometry_factory::fullscreen_quad(
@@ -583,6 +557,8 @@ void xray::rendering::geometry_factory::fullscreen_quad(
 
   memcpy(raw_ptr(grid_geometry->indices), fsquad_indices,
          sizeof(fsquad_indices));
+
+  compute_bounds(grid_geometry);
 }
 
 // void xray::rendering::geometry_factory::create_spherical_shape(
@@ -769,6 +745,8 @@ void xray::rendering::geometry_factory::fullscreen_quad(
 //   }
 // }
 
+constexpr uint32_t xray::rendering::geometry_factory::geosphere_max_subdivisions;
+
 void xray::rendering::geometry_factory::geosphere(
     const float radius, const uint32_t max_subdivisions,
     geometry_data_t* mesh) {
@@ -777,7 +755,7 @@ void xray::rendering::geometry_factory::geosphere(
   assert(radius > 0.0f);
 
   const uint32_t subdivisions =
-      math::clamp(max_subdivisions, max_subdivisions, uint32_t{5});
+      std::min(max_subdivisions, geosphere_max_subdivisions);
 
   //
   // Approximate a sphere by tessellating an icosahedron.
@@ -792,51 +770,75 @@ void xray::rendering::geometry_factory::geosphere(
       math::float3{+zpos, +xpos, 0.0f}, math::float3{-zpos, +xpos, 0.0f},
       math::float3{+zpos, -xpos, 0.0f}, math::float3{-zpos, -xpos, 0.0f}};
 
+  //
+  //  Counter clockwise when seen from outside.
   constexpr uint32_t k[60] = {
-      1,  0, 4, 4, 0, 9,  4, 9, 5,  8, 4, 5, 1,  4,  8, 1, 8, 10, 10, 8,
-      3,  8, 5, 3, 3, 5,  2, 3, 2,  7, 3, 7, 10, 10, 7, 6, 6, 7,  11, 6,
-      11, 0, 6, 0, 1, 10, 6, 1, 11, 9, 0, 2, 9,  11, 5, 9, 2, 11, 7,  2,
+      1,  4, 0, 4, 9,  0, 4, 5,  9,  8, 5, 4, 1,  8, 4, 1, 10, 8, 10, 3,
+      8,  8, 3, 5, 3,  2, 5, 3,  7,  2, 3, 10, 7, 10, 6, 7, 6, 11, 7,  6,
+      0, 11, 6, 1, 0, 10, 1, 6, 11,  0, 9, 2, 11, 9, 5, 2, 9, 11, 2,  7,
   };
 
   //
-  //  TODO : Suboptimal code, rewrite when possible.
-  vector<vertex_pntt> vertices{12};
-  vector<uint32_t>    indices{begin(k), end(k)};
-
-  for (uint32_t i = 0; i < 12; ++i) {
-    vertices[i].position = pos[i];
+  //  Each level splits every face in 4 and adds one vertex per edge :
+  //  F = 20 * 4^L, V = 10 * 4^L + 2.
+  const size_t level_factor = size_t{1} << (2 * subdivisions);
+  const size_t vertex_count = 10 * level_factor + 2;
+  const size_t index_count  = 60 * level_factor;
+
+  vector<float3> positions;
+  positions.reserve(vertex_count);
+  positions.assign(begin(pos), end(pos));
+
+  vector<uint32_t> indices;
+  indices.reserve(index_count);
+  indices.assign(begin(k), end(k));
+
+  vector<uint32_t> subdivided;
+  subdivided.reserve(index_count);
+
+  for (uint32_t i = 0; i < subdivisions; ++i) {
+    subdivide_geometry(indices, &positions, &subdivided);
+    indices.swap(subdivided);
   }
 
-  for (uint32_t i = 0; i < subdivisions; ++i)
-    subdivide_geometry(&vertices, &indices);
-
-  //
-  // Project md_vertices onto sphere and scale.
-  for (uint32_t i = 0; i < static_cast<uint32_t>(vertices.size()); ++i) {
-    vertices[i].normal   = normalize(vertices[i].position);
-    vertices[i].position = radius * vertices[i].normal;
-
-    //
-    // Derive texture coordinates from spherical coordinates.
-    const float theta =
-        angle_from_xy(vertices[i].position.x, vertices[i].position.z);
-
-    const float phi = acosf(vertices[i].position.x / radius);
+  assert(positions.size() == vertex_count);
+  assert(indices.size() == index_count);
 
-    vertices[i].texcoords.x = theta / two_pi<float>;
-    vertices[i].texcoords.y = phi / pi<float>;
+  mesh->setup(vertex_count, index_count);
 
-    //
-    // Partial derivative of P with respect to theta
-    vertices[i].tangent.x = -radius * sinf(phi) * sinf(theta);
-    vertices[i].tangent.y = 0.0f;
-    vertices[i].tangent.z = +radius * sinf(phi) * cosf(theta);
-    vertices[i].tangent   = normalize(vertices[i].tangent);
-  }
+  //
+  // Scale the unit sphere and derive the other vertex attributes.
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, vertex_count, 4096},
+      [&positions, radius, mesh](const tbb::blocked_range<size_t>& rng) {
+        for (size_t i = rng.begin(); i < rng.end(); ++i) {
+          auto& vtx = mesh->geometry[i];
+
+          vtx.normal   = positions[i];
+          vtx.position = radius * vtx.normal;
+
+          //
+          // Derive texture coordinates from spherical coordinates.
+          const float theta =
+              angle_from_xy(vtx.position.x, vtx.position.z);
+
+          const float phi = acosf(vtx.position.x / radius);
+
+          vtx.texcoords.x = theta / two_pi<float>;
+          vtx.texcoords.y = phi / pi<float>;
+
+          //
+          // Partial derivative of P with respect to theta
+          vtx.tangent.x = -radius * sinf(phi) * sinf(theta);
+          vtx.tangent.y = 0.0f;
+          vtx.tangent.z = +radius * sinf(phi) * cosf(theta);
+          vtx.tangent   = normalize(vtx.tangent);
+        }
+      });
 
-  mesh->setup(vertices.size(), indices.size());
-  std::copy(begin(vertices), end(vertices), base::raw_ptr(mesh->geometry));
   std::copy(begin(indices), end(indices), base::raw_ptr(mesh->indices));
+
+  compute_bounds(mesh);
 }
 
 void xray::rendering::geometry_factory::tetrahedron(geometry_data_t* mesh) {
@@ -853,6 +855,7 @@ void xray::rendering::geometry_factory::tetrahedron(geometry_data_t* mesh) {
   memcpy(base::raw_ptr(mesh->indices), indices, sizeof(indices));
 
   compute_normals(mesh);
+  compute_bounds(mesh);
 }
 
 void xray::rendering::geometry_factory::hexahedron(geometry_data_t* mesh) {
@@ -890,6 +893,7 @@ void xray::rendering::geometry_factory::hexahedron(geometry_data_t* mesh) {
 
   memcpy(base::raw_ptr(mesh->indices), indices, sizeof(indices));
   compute_normals(mesh);
+  compute_bounds(mesh);
 }
 
 void xray::rendering::geometry_factory::octahedron(geometry_data_t* mesh) {
@@ -919,6 +923,7 @@ void xray::rendering::geometry_factory::octahedron(geometry_data_t* mesh) {
 
   memcpy(base::raw_ptr(mesh->indices), indices, sizeof(indices));
   compute_normals(mesh);
+  compute_bounds(mesh);
 }
 
 void xray::rendering::geometry_factory::dodecahedron(geometry_data_t* mesh) {
@@ -1005,6 +1010,7 @@ void xray::rendering::geometry_factory::dodecahedron(geometry_data_t* mesh) {
 
   memcpy(base::raw_ptr(mesh->indices), indices, sizeof(indices));
   compute_normals(mesh);
+  compute_bounds(mesh);
 }
 
 void xray::rendering::geometry_factory::icosahedron(geometry_data_t* mesh) {
@@ -1069,6 +1075,7 @@ void xray::rendering::geometry_factory::icosahedron(geometry_data_t* mesh) {
 
   memcpy(base::raw_ptr(mesh->indices), indices, sizeof(indices));
   compute_normals(mesh);
+  compute_bounds(mesh);
 }
 
 void xray::rendering::geometry_factory::torus(const float      outer_radius,
@@ -1132,6 +1139,8 @@ void xray::rendering::geometry_factory::torus(const float      outer_radius,
       }
     }
   }
+
+  compute_bounds(mesh);
 }
 
 //
@@ -1140,70 +1149,183 @@ static auto ai_vec_to_xray_vec(const aiVector3D& ai_vec) noexcept {
   return xray::math::float3{ai_vec.x, ai_vec.y, ai_vec.z};
 }
 
+static void mesh_load_vertex(const aiMesh* mesh, const uint32_t idx,
+                             vertex_pntt* dst) noexcept {
+  dst->position = ai_vec_to_xray_vec(mesh->mVertices[idx]);
+  dst->normal   = mesh->HasNormals() ? ai_vec_to_xray_vec(mesh->mNormals[idx])
+                                   : float3::stdc::zero;
+  dst->texcoords =
+      mesh->HasTextureCoords(0)
+          ? float2{mesh->mTextureCoords[0][idx].x,
+                   mesh->mTextureCoords[0][idx].y}
+          : float2{0.5f, 0.5f};
+  dst->tangent = mesh->HasTangentsAndBitangents()
+                     ? ai_vec_to_xray_vec(mesh->mTangents[idx])
+                     : float3::stdc::zero;
+}
+
+///
+/// Vertices converted per task, large meshes are split so that a model made
+/// of a single mesh is converted in parallel too.
+static constexpr uint32_t VERTEX_CONVERSION_GRAIN = 4096;
+
+static void mesh_load_vertices(const aiMesh* mesh, vertex_pntt* dst) {
+  tbb::parallel_for(
+      tbb::blocked_range<uint32_t>{0u, mesh->mNumVertices,
+                                   VERTEX_CONVERSION_GRAIN},
+      [mesh, dst](const tbb::blocked_range<uint32_t>& range) {
+        for (uint32_t idx = range.begin(); idx < range.end(); ++idx)
+          mesh_load_vertex(mesh, idx, dst + idx);
+      });
+}
+
+static void mesh_load_indices(const aiMesh* mesh, const uint32_t base_vertex,
+                              uint32_t* dst) noexcept {
+  for (uint32_t face_index = 0; face_index < mesh->mNumFaces; ++face_index) {
+    const aiFace& face = mesh->mFaces[face_index];
+    for (uint32_t i = 0; i < face.mNumIndices; ++i)
+      *dst++ = face.mIndices[i] + base_vertex;
+  }
+}
+
+///
+/// Placement of one imported mesh in the vertex and index buffers.
+struct ai_mesh_layout {
+  uint32_t base_vertex{0};
+  uint32_t index_offset{0};
+  uint32_t index_count{0};
+};
+
+///
+/// Counts the indices of every mesh (in parallel) and turns the counts into
+/// offsets with a prefix sum. Meshes without vertices get empty ranges.
+static void layout_ai_meshes(const aiScene*          scene,
+                             vector<ai_mesh_layout>* layout,
+                             size_t* num_vertices, size_t* num_indices) {
+  layout->assign(scene->mNumMeshes, ai_mesh_layout{});
+
+  tbb::parallel_for(uint32_t{0}, scene->mNumMeshes,
+                    [scene, layout](const uint32_t mesh_index) {
+                      const aiMesh* mesh = scene->mMeshes[mesh_index];
+                      if (!mesh->mVertices)
+                        return;
+
+                      uint32_t index_count{};
+                      for (uint32_t f = 0; f < mesh->mNumFaces; ++f)
+                        index_count += mesh->mFaces[f].mNumIndices;
+
+                      (*layout)[mesh_index].index_count = index_count;
+                    });
+
+  uint32_t base_vertex{};
+  uint32_t index_offset{};
+
+  for (uint32_t mesh_index = 0; mesh_index < scene->mNumMeshes; ++mesh_index) {
+    auto& mesh_layout        = (*layout)[mesh_index];
+    mesh_layout.base_vertex  = base_vertex;
+    mesh_layout.index_offset = index_offset;
+
+    if (scene->mMeshes[mesh_index]->mVertices)
+      base_vertex += scene->mMeshes[mesh_index]->mNumVertices;
+    index_offset += mesh_layout.index_count;
+  }
+
+  *num_vertices = base_vertex;
+  *num_indices  = index_offset;
+}
+
+//
+//  Computes the normals and/or tangents of the submeshes flagged as missing
+//  them.
+static void compute_missing_vectors(geometry_data_t*    mesh_data,
+                                    const vector<bool>& missing_normals,
+                                    const vector<bool>& missing_tangents) {
+  for (size_t sm_idx = 0; sm_idx < mesh_data->submeshes.size(); ++sm_idx) {
+    if (!missing_normals[sm_idx] && !missing_tangents[sm_idx])
+      continue;
+
+    const auto&           submesh = mesh_data->submeshes[sm_idx];
+    vertex_face_adjacency adjacency;
+    build_vertex_face_adjacency(
+        gsl::span<const uint32_t>{
+            raw_ptr(mesh_data->indices) + submesh.index_offset,
+            static_cast<ptrdiff_t>(submesh.index_count)},
+        submesh.vertex_count, submesh.base_vertex, &adjacency);
+
+    if (missing_normals[sm_idx])
+      compute_normals(mesh_data, submesh, normal_weighting::area, &adjacency);
+
+    if (missing_tangents[sm_idx])
+      compute_tangents(mesh_data, submesh, &adjacency);
+  }
+}
+
 static bool
 load_model_impl(const char* model_data_ptr, const size_t data_size,
                 const uint32_t                             load_flags,
                 const xray::rendering::mesh_import_options import_opts,
+                const char*                                asset_name,
                 xray::rendering::geometry_data_t*          mesh_data) {
 
-  struct ai_propstore_deleter {
-    void operator()(aiPropertyStore* prop_store) const noexcept {
-      if (prop_store)
-        aiReleasePropertyStore(prop_store);
+  struct ai_scene_deleter {
+    void operator()(const aiScene* scene) const noexcept {
+      if (scene)
+        aiReleaseImport(scene);
     }
   };
 
-  unique_pointer<aiPropertyStore, ai_propstore_deleter> import_props{
-      aiCreatePropertyStore()};
-
-  if (!import_props) {
-    XR_LOG_ERR("Failed to create Assimp property store object!");
-    return false;
-  }
-
-  {
-    aiSetImportPropertyInteger(raw_ptr(import_props),
-                               AI_CONFIG_IMPORT_TER_MAKE_UVS, 1);
+  //
+  //  Removing points and lines is the last property, left out when not
+  //  requested.
+  const mesh_import_property import_props[] = {
+      {AI_CONFIG_IMPORT_TER_MAKE_UVS, 1},
+      {AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_LINE | aiPrimitiveType_POINT}};
 
-    if (import_opts & mesh_import_options::remove_points_lines) {
-      aiSetImportPropertyInteger(raw_ptr(import_props), AI_CONFIG_PP_SBP_REMOVE,
-                                 aiPrimitiveType_LINE | aiPrimitiveType_POINT);
-    }
-  }
+  size_t props_count = XR_COUNTOF__(import_props) - 1;
+  if (import_opts & mesh_import_options::remove_points_lines)
+    props_count = XR_COUNTOF__(import_props);
 
-  auto imported_scene = aiImportFileFromMemoryWithProperties(
-      model_data_ptr, data_size, load_flags, nullptr, raw_ptr(import_props));
+  unique_pointer<const aiScene, ai_scene_deleter> scene{
+      import_scene_timed(model_data_ptr, data_size, load_flags,
+                         import_props, props_count, asset_name)};
 
-  if (!imported_scene) {
-    XR_LOG_ERR("Assimp import error : failed to load scene from model file !");
+  if (!scene)
     return false;
-  }
 
-  size_t num_vertices = 0;
-  size_t num_indices  = 0;
-  size_t num_faces    = 0;
+  const aiScene* imported_scene = raw_ptr(scene);
 
-  //
-  //  Count vertices and indices.
-  for (uint32_t mesh_index = 0; mesh_index < imported_scene->mNumMeshes;
-       ++mesh_index) {
+  timer_highp conversion_timer;
+  conversion_timer.start();
 
-    const aiMesh* curr_mesh = imported_scene->mMeshes[mesh_index];
-    num_vertices += curr_mesh->mNumVertices;
-    num_faces += curr_mesh->mNumFaces;
-
-    for (uint32_t face_index = 0; face_index < curr_mesh->mNumFaces;
-         ++face_index) {
-      const aiFace* curr_face = &curr_mesh->mFaces[face_index];
-      num_indices += curr_face->mNumIndices;
-    }
-  }
+  size_t                 num_vertices = 0;
+  size_t                 num_indices  = 0;
+  vector<ai_mesh_layout> layout;
+  layout_ai_meshes(imported_scene, &layout, &num_vertices, &num_indices);
 
   mesh_data->setup(num_vertices, num_indices);
 
-  uint32_t vertex_count   = 0;
-  uint32_t index_count    = 0;
-  uint32_t indices_offset = 0;
+  //
+  //  Meshes write to disjoint ranges of the output buffers, convert them all
+  //  in parallel.
+  tbb::parallel_for(
+      uint32_t{0}, imported_scene->mNumMeshes,
+      [imported_scene, &layout, mesh_data](const uint32_t mesh_index) {
+        const aiMesh* curr_mesh = imported_scene->mMeshes[mesh_index];
+
+        if (!curr_mesh->mVertices)
+          return;
+
+        const auto& mesh_layout = layout[mesh_index];
+        mesh_load_vertices(curr_mesh,
+                           raw_ptr(mesh_data->geometry) +
+                               mesh_layout.base_vertex);
+        mesh_load_indices(curr_mesh, mesh_layout.base_vertex,
+                          raw_ptr(mesh_data->indices) +
+                              mesh_layout.index_offset);
+      });
+
+  vector<bool> missing_normals;
+  vector<bool> missing_tangents;
 
   for (uint32_t mesh_index = 0; mesh_index < imported_scene->mNumMeshes;
        ++mesh_index) {
@@ -1212,95 +1334,115 @@ load_model_impl(const char* model_data_ptr, const size_t data_size,
     if (!curr_mesh->mVertices)
       continue;
 
-    //
-    // Collect vertices
-    for (uint32_t vertex_idx = 0; vertex_idx < curr_mesh->mNumVertices;
-         ++vertex_idx) {
-      const auto output_pos = vertex_idx + vertex_count;
+    geometry_submesh submesh;
+    submesh.base_vertex    = layout[mesh_index].base_vertex;
+    submesh.vertex_count   = curr_mesh->mNumVertices;
+    submesh.index_offset   = layout[mesh_index].index_offset;
+    submesh.index_count    = layout[mesh_index].index_count;
+    submesh.material_index = curr_mesh->mMaterialIndex;
+    mesh_data->submeshes.push_back(submesh);
+
+    const bool triangles_only =
+        curr_mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE;
+    missing_normals.push_back(triangles_only && !curr_mesh->HasNormals());
+    missing_tangents.push_back(triangles_only &&
+                               !curr_mesh->HasTangentsAndBitangents());
+  }
 
-      mesh_data->geometry[output_pos].position =
-          ai_vec_to_xray_vec(curr_mesh->mVertices[vertex_idx]);
-    }
+  //
+  //  Duplicate vertices are merged here rather than by Assimp
+  //  (aiProcess_JoinIdenticalVertices is one of the slowest import steps).
+  weld_vertices(mesh_data);
 
-    //
-    // collect normals
+  //
+  //  Normals are not generated by Assimp either (too slow on large models),
+  //  fill in the missing ones on the welded mesh.
+  compute_missing_vectors(mesh_data, missing_normals, missing_tangents);
+  compute_bounds(mesh_data);
 
-    {
-      struct msvc_fuck_off {
-        static auto get_normal_from_mesh(const aiVector3D* input,
-                                         const uint32_t    pos) noexcept {
-          return ai_vec_to_xray_vec(input[pos]);
-        }
+  conversion_timer.end();
+  XR_LOG_INFO("Import {} : conversion {:.3f} ms", asset_name,
+              conversion_timer.elapsed_millis());
+
+  return true;
+}
+
+static constexpr uint32_t GEOMETRY_DATA_CACHE_TAG = 1u << 31;
 
-        static auto get_null_normal(const aiVector3D* /*input*/,
-                                    const uint32_t /*pos*/) noexcept {
-          return float3::stdc::zero;
+//
+//  Same result as aiProcess_ConvertToLeftHanded : mirrors the z axis, flips
+//  the v texture coordinate and the winding order.
+static void convert_to_left_handed(geometry_data_t* mesh_data) {
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, mesh_data->vertex_count,
+                                 VERTEX_CONVERSION_GRAIN},
+      [mesh_data](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+          auto& vertex = mesh_data->geometry[i];
+          vertex.position.z  = -vertex.position.z;
+          vertex.normal.z    = -vertex.normal.z;
+          vertex.texcoords.y = 1.0f - vertex.texcoords.y;
         }
-      };
+      });
 
-      auto fn_get_normal = curr_mesh->HasNormals()
-                               ? &msvc_fuck_off::get_normal_from_mesh
-                               : &msvc_fuck_off::get_null_normal;
+  for (size_t i = 0; i + 2 < mesh_data->index_count; i += 3)
+    swap(mesh_data->indices[i + 1], mesh_data->indices[i + 2]);
+}
 
-      for (uint32_t idx = 0; idx < curr_mesh->mNumVertices; ++idx) {
-        const auto output_pos = idx + vertex_count;
-        mesh_data->geometry[output_pos].normal =
-            fn_get_normal(curr_mesh->mNormals, idx);
-      }
-    }
+//
+//  Imports OBJ and PLY files without Assimp, see import_native_model().
+//  src/benchmarks/model_import_bench.cc compares it with the Assimp import.
+static bool load_native_model(const void* model_data, const size_t data_size,
+                              const native_model_format fmt,
+                              const mesh_import_options import_opts,
+                              geometry_data_t*          mesh_data) {
+  native_import_info info;
+  if (!import_native_model(model_data, data_size, fmt, mesh_data, &info))
+    return false;
 
-    //
-    // collect texture coordinates.
-    {
-      struct msvc_fuckery {
-        static auto get_texcoord_from_mesh(const aiVector3D* const* texcoords,
-                                           const uint32_t pos) noexcept {
-          return float2{texcoords[0][pos].x, texcoords[0][pos].y};
-        }
+  if (import_opts & mesh_import_options::convert_left_handed)
+    convert_to_left_handed(mesh_data);
 
-        static auto
-        get_default_texcoords(const aiVector3D* const* /*texcoords*/,
-                              const uint32_t /*pos*/) noexcept {
-          return float2{0.5f, 0.5f};
-        }
-      };
+  //
+  //  Identical vertex tuples are shared by the parser already, no welding.
+  compute_missing_vectors(mesh_data, vector<bool>{!info.has_normals},
+                          vector<bool>{true});
+  compute_bounds(mesh_data);
+  return true;
+}
 
-      auto fn_get_texcoords = curr_mesh->HasTextureCoords(0)
-                                  ? &msvc_fuckery::get_texcoord_from_mesh
-                                  : &msvc_fuckery::get_default_texcoords;
+static mesh_import_profile
+import_profile_from_options(const mesh_import_options import_opts) noexcept {
+  if (import_opts & mesh_import_options::profile_fast)
+    return mesh_import_profile::fast;
 
-      for (uint32_t idx = 0; idx < curr_mesh->mNumVertices; ++idx) {
-        const auto output_pos = idx + vertex_count;
-        mesh_data->geometry[output_pos].texcoords =
-            fn_get_texcoords(curr_mesh->mTextureCoords, idx);
-      }
-    }
+  if (import_opts & mesh_import_options::profile_balanced)
+    return mesh_import_profile::balanced;
 
-    //
-    // collect tangent vectors
-    if (curr_mesh->HasTangentsAndBitangents()) {
-      for (uint32_t tan_idx = 0; tan_idx < curr_mesh->mNumVertices; ++tan_idx) {
-        mesh_data->geometry[tan_idx + vertex_count].tangent =
-            ai_vec_to_xray_vec(curr_mesh->mTangents[tan_idx]);
-      }
-    }
+  if (import_opts & mesh_import_options::profile_full)
+    return mesh_import_profile::full;
 
-    //
-    //  Collect indices defining primitives.
-    for (uint32_t face_index = 0; face_index < curr_mesh->mNumFaces;
-         ++face_index) {
-      const aiFace* curr_face = &curr_mesh->mFaces[face_index];
-
-      for (uint32_t i = 0; i < curr_face->mNumIndices; ++i) {
-        mesh_data->indices[index_count++] =
-            curr_face->mIndices[i] + indices_offset;
-      }
-    }
+  return default_mesh_import_profile();
+}
 
-    indices_offset += curr_mesh->mNumVertices;
-    vertex_count += curr_mesh->mNumVertices;
+static bool load_cached_model(const mesh_cache_data& cached,
+                              geometry_data_t*       mesh_data) {
+  if (cached.vertex_fmt != vertex_format::pntt ||
+      cached.vertex_size != sizeof(vertex_pntt) ||
+      cached.index_fmt != index_format::u32 || cached.strips) {
+    return false;
   }
 
+  mesh_data->setup(cached.vertex_count, cached.index_count);
+  memcpy(raw_ptr(mesh_data->geometry), cached.vertices,
+         size_t{cached.vertex_count} * sizeof(vertex_pntt));
+  memcpy(raw_ptr(mesh_data->indices), cached.indices,
+         size_t{cached.index_count} * sizeof(uint32_t));
+
+  mesh_data->submeshes.assign(begin(cached.submeshes), end(cached.submeshes));
+  mesh_data->bounding_box    = cached.bounding_box;
+  mesh_data->bounding_sphere = cached.bounding_sphere;
+
   return true;
 }
 
@@ -1311,44 +1453,91 @@ bool xray::rendering::geometry_factory::load_model(
   assert(mesh_data != nullptr);
   assert(file_path != nullptr);
 
-  constexpr uint32_t default_processing_opts =
-      aiProcess_CalcTangentSpace |         // calculate tangents and
-      aiProcess_JoinIdenticalVertices |    // join identical vertices/
-      aiProcess_ValidateDataStructure |    // perform a full validation of the
-      aiProcess_ImproveCacheLocality |     // improve the cache locality of
-      aiProcess_RemoveRedundantMaterials | // remove redundant materials
-      aiProcess_FindDegenerates |   // remove degenerated polygons from the
-      aiProcess_FindInvalidData |   // detect invalid model data, such as
-      aiProcess_GenUVCoords |       // convert spherical, cylindrical, box and
-      aiProcess_TransformUVCoords | // preprocess UV transformations
-      aiProcess_FindInstances |     // search for instanced meshes and remove
-      aiProcess_LimitBoneWeights |  // limit bone weights to 4 per vertex
-      aiProcess_OptimizeMeshes |    // join small meshes, if possible;
-      aiProcess_SplitByBoneCount |  // split meshes with too many bones.
-      0;
-
-  constexpr auto post_processing_opts =
-      default_processing_opts | aiProcess_GenSmoothNormals | // generate smooth
-      aiProcess_SplitLargeMeshes |                           // split large,
-      aiProcess_Triangulate | // triangulate polygons with
-      aiProcess_SortByPType | // make 'clean' meshes which consist of a
-      0;
-
+  //
+  //  Vertex welding and missing normals are done after import, see
+  //  load_model_impl().
+  const auto profile = import_profile_from_options(import_opts);
   const auto all_processing_opts =
-      post_processing_opts |
+      (mesh_import_profile_steps(profile) &
+       ~static_cast<uint32_t>(aiProcess_JoinIdenticalVertices |
+                              aiProcess_GenSmoothNormals)) |
       (import_opts & mesh_import_options::convert_left_handed
            ? aiProcess_ConvertToLeftHanded
            : 0);
 
+  //
+  //  Tagged so that the key never matches a file written by simple_mesh for
+  //  the same model (different import steps). The resolved profile is part
+  //  of the key.
+  constexpr auto profile_opts =
+      static_cast<uint32_t>(mesh_import_options::profile_fast |
+                            mesh_import_options::profile_balanced |
+                            mesh_import_options::profile_full);
+
+  const auto cache_opts =
+      GEOMETRY_DATA_CACHE_TAG |
+      (static_cast<uint32_t>(import_opts) & ~profile_opts) |
+      (static_cast<uint32_t>(mesh_import_options::profile_fast)
+       << static_cast<uint32_t>(profile));
+
+  mesh_cache_key cache_key;
+  string         cache_file;
+
+  if (make_mesh_cache_key(file_path, cache_opts, vertex_format::pntt,
+                          &cache_key)) {
+    cache_file = mesh_cache_path(cache_key);
+
+    mesh_cache_file cached;
+    if (!cache_file.empty() && cached.open(cache_file.c_str(), cache_key) &&
+        load_cached_model(cached.data(), mesh_data)) {
+      return true;
+    }
+  }
+
   try {
     platformstl::memory_mapped_file mesh_mmfile{file_path};
 
-    return load_model_impl(static_cast<const char*>(mesh_mmfile.memory()),
-                           mesh_mmfile.size(), all_processing_opts, import_opts,
-                           mesh_data);
+    //
+    //  OBJ and PLY are read by the native parsers, with Assimp as a fallback
+    //  for the files they reject.
+    const auto native_fmt = native_model_format_from_path(file_path);
+    const bool native_ok =
+        native_fmt != native_model_format::none &&
+        load_native_model(mesh_mmfile.memory(), mesh_mmfile.size(),
+                          native_fmt, import_opts, mesh_data);
+
+    if (native_fmt != native_model_format::none && !native_ok)
+      XR_LOG_INFO("Import {} : falling back to Assimp", file_path);
+
+    if (!native_ok &&
+        !load_model_impl(static_cast<const char*>(mesh_mmfile.memory()),
+                         mesh_mmfile.size(), all_processing_opts, import_opts,
+                         file_path, mesh_data)) {
+      return false;
+    }
   } catch (const std::exception&) {
     XR_LOG_ERR("Failed to import model file {}", file_path);
+    return false;
+  }
+
+  if (!cache_file.empty()) {
+    mesh_cache_data cached;
+    cached.vertex_fmt       = vertex_format::pntt;
+    cached.index_fmt        = index_format::u32;
+    cached.vertices         = raw_ptr(mesh_data->geometry);
+    cached.vertex_count     = static_cast<uint32_t>(mesh_data->vertex_count);
+    cached.vertex_size      = static_cast<uint32_t>(sizeof(vertex_pntt));
+    cached.indices          = raw_ptr(mesh_data->indices);
+    cached.index_count      = static_cast<uint32_t>(mesh_data->index_count);
+    cached.list_index_count = cached.index_count;
+    cached.submeshes        = gsl::span<const geometry_submesh>{
+        mesh_data->submeshes.data(),
+        static_cast<ptrdiff_t>(mesh_data->submeshes.size())};
+    cached.bounding_box    = mesh_data->bounding_box;
+    cached.bounding_sphere = mesh_data->bounding_sphere;
+
+    write_mesh_cache(cache_file.c_str(), cache_key, cached);
   }
 
-  return false;
+  return true;
 }
@@ -0,0 +1,1343 @@
+#include "xray/rendering/geometry/geometry_import_native.hpp"
+#include "xray/base/array_dimension.hpp"
+#include "xray/base/logger.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/scalar2.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::math;
+using namespace xray::rendering;
+
+///  Amount of text parsed by one task.
+static constexpr size_t PARSE_CHUNK_SIZE = size_t{1} << 20;
+
+static constexpr size_t CONVERSION_GRAIN = 4096;
+
+static const float2 DEFAULT_TEXCOORDS{0.5f, 0.5f};
+
+static bool equal_nocase(const char* s0, const char* s1) noexcept {
+  for (; *s0 && *s1; ++s0, ++s1) {
+    if (tolower(static_cast<unsigned char>(*s0)) !=
+        tolower(static_cast<unsigned char>(*s1)))
+      return false;
+  }
+
+  return *s0 == *s1;
+}
+
+native_model_format xray::rendering::native_model_format_from_path(
+    const char* path) noexcept {
+  assert(path != nullptr);
+
+  const char* ext = strrchr(path, '.');
+  if (!ext || strchr(ext, '/') || strchr(ext, '\\'))
+    return native_model_format::none;
+
+  if (equal_nocase(ext + 1, "obj"))
+    return native_model_format::obj;
+
+  if (equal_nocase(ext + 1, "ply"))
+    return native_model_format::ply;
+
+  return native_model_format::none;
+}
+
+//
+//  Text parsing helpers. Carriage returns count as blanks, so files with
+//  DOS line endings need no special handling.
+static bool is_blank(const char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool is_digit(const char c) noexcept { return c >= '0' && c <= '9'; }
+
+static const char* skip_blanks(const char* p, const char* end) noexcept {
+  while (p < end && is_blank(*p))
+    ++p;
+  return p;
+}
+
+static const char* line_end(const char* p, const char* end) noexcept {
+  const auto nl = static_cast<const char*>(memchr(p, '\n', end - p));
+  return nl ? nl : end;
+}
+
+//
+//  Decimal float parser, independent of the locale and a lot faster than
+//  strtof(). The significand is accumulated in an integer (up to 19
+//  digits) and scaled once, which is exact for the values exported by
+//  modelling tools (at most 9 significant digits).
+static const char* parse_float(const char* p, const char* end,
+                               float* out) noexcept {
+  static constexpr double POW10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  p = skip_blanks(p, end);
+
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  uint64_t significand = 0;
+  int32_t  exponent    = 0;
+  uint32_t digits      = 0;
+  bool     any_digit   = false;
+
+  for (; p < end && is_digit(*p); ++p) {
+    any_digit = true;
+    if (digits < 19) {
+      significand = significand * 10 + static_cast<uint64_t>(*p - '0');
+      digits += significand != 0;
+    } else {
+      ++exponent;
+    }
+  }
+
+  if (p < end && *p == '.') {
+    for (++p; p < end && is_digit(*p); ++p) {
+      any_digit = true;
+      if (digits < 19) {
+        significand = significand * 10 + static_cast<uint64_t>(*p - '0');
+        digits += significand != 0;
+        --exponent;
+      }
+    }
+  }
+
+  if (!any_digit)
+    return nullptr;
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char* q            = p + 1;
+    bool        negative_exp = false;
+
+    if (q < end && (*q == '-' || *q == '+')) {
+      negative_exp = *q == '-';
+      ++q;
+    }
+
+    if (q < end && is_digit(*q)) {
+      int32_t exp_value = 0;
+      for (; q < end && is_digit(*q); ++q) {
+        if (exp_value < 10000)
+          exp_value = exp_value * 10 + (*q - '0');
+      }
+
+      exponent += negative_exp ? -exp_value : exp_value;
+      p = q;
+    }
+  }
+
+  auto value = static_cast<double>(significand);
+  if (significand != 0 && exponent != 0) {
+    if (exponent > 0 && exponent <= 22)
+      value *= POW10[exponent];
+    else if (exponent < 0 && exponent >= -22)
+      value /= POW10[-exponent];
+    else
+      value *= std::pow(10.0, exponent);
+  }
+
+  *out = static_cast<float>(negative ? -value : value);
+  return p;
+}
+
+static const char* parse_int(const char* p, const char* end,
+                             int64_t* out) noexcept {
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  if (p == end || !is_digit(*p))
+    return nullptr;
+
+  int64_t value = 0;
+  for (; p < end && is_digit(*p); ++p) {
+    if (value > (int64_t{1} << 40))
+      return nullptr;
+    value = value * 10 + (*p - '0');
+  }
+
+  *out = negative ? -value : value;
+  return p;
+}
+
+//
+//  Reads up to count floats; the first required ones must be present.
+static bool parse_floats(const char* p, const char* end, const size_t count,
+                         const size_t required, float* out) noexcept {
+  for (size_t i = 0; i < count; ++i) {
+    const char* next = parse_float(p, end, out + i);
+    if (!next)
+      return i >= required;
+    p = next;
+  }
+
+  return true;
+}
+
+struct text_chunk {
+  const char* first;
+  const char* last;
+};
+
+//
+//  Splits the text into chunks of about PARSE_CHUNK_SIZE bytes, ending on
+//  line boundaries.
+static vector<text_chunk> split_lines(const char* text, const size_t size) {
+  vector<text_chunk> chunks;
+  chunks.reserve(size / PARSE_CHUNK_SIZE + 1);
+
+  const char* p   = text;
+  const char* end = text + size;
+
+  while (p < end) {
+    const char* last =
+        p + std::min(PARSE_CHUNK_SIZE, static_cast<size_t>(end - p));
+    if (last < end) {
+      last = line_end(last, end);
+      last = last < end ? last + 1 : end;
+    }
+
+    chunks.push_back({p, last});
+    p = last;
+  }
+
+  return chunks;
+}
+
+static void log_malformed_line(const char* format_name, const char* line,
+                               const char* end) {
+  const auto length =
+      std::min(static_cast<size_t>(line_end(line, end) - line), size_t{80});
+  XR_LOG_ERR("{} : malformed line \"{}\"", format_name,
+             string{line, length});
+}
+
+///
+/// Wavefront OBJ.
+
+//
+//  Flags of obj_corner : which indices are present and which ones are
+//  relative to the first element of their kind in the chunk (negative
+//  indices in the file, resolved once the chunks are merged).
+static constexpr uint32_t OBJ_HAS_VT      = 1u << 0;
+static constexpr uint32_t OBJ_HAS_VN      = 1u << 1;
+static constexpr uint32_t OBJ_RELATIVE_V  = 1u << 2;
+static constexpr uint32_t OBJ_RELATIVE_VT = 1u << 3;
+static constexpr uint32_t OBJ_RELATIVE_VN = 1u << 4;
+
+struct obj_corner {
+  int32_t  v;
+  int32_t  vt;
+  int32_t  vn;
+  uint32_t flags;
+};
+
+struct obj_chunk {
+  text_chunk         text;
+  vector<float3>     positions;
+  vector<float2>     texcoords;
+  vector<float3>     normals;
+  vector<obj_corner> corners; ///< Three per triangle.
+  const char*        error_line{nullptr};
+};
+
+static const char* obj_parse_index(const char* p, const char* end,
+                                   const size_t   chunk_count,
+                                   const uint32_t relative_flag,
+                                   int32_t* index, uint32_t* flags) noexcept {
+  int64_t value = 0;
+  p             = parse_int(p, end, &value);
+
+  if (!p || value == 0)
+    return nullptr;
+
+  if (value > 0) {
+    if (value > INT32_MAX)
+      return nullptr;
+    *index = static_cast<int32_t>(value - 1);
+  } else {
+    const auto local = static_cast<int64_t>(chunk_count) + value;
+    if (local < INT32_MIN)
+      return nullptr;
+    *index = static_cast<int32_t>(local);
+    *flags |= relative_flag;
+  }
+
+  return p;
+}
+
+static bool obj_parse_face(const char* p, const char* end, obj_chunk* chunk) {
+  obj_corner first{};
+  obj_corner prev{};
+  uint32_t   corner_count = 0;
+
+  for (;;) {
+    p = skip_blanks(p, end);
+    if (p == end || *p == '#')
+      break;
+
+    obj_corner corner{0, -1, -1, 0};
+
+    p = obj_parse_index(p, end, chunk->positions.size(), OBJ_RELATIVE_V,
+                        &corner.v, &corner.flags);
+    if (!p)
+      return false;
+
+    if (p < end && *p == '/') {
+      ++p;
+      if (p < end && *p != '/') {
+        p = obj_parse_index(p, end, chunk->texcoords.size(), OBJ_RELATIVE_VT,
+                            &corner.vt, &corner.flags);
+        if (!p)
+          return false;
+        corner.flags |= OBJ_HAS_VT;
+      }
+
+      if (p < end && *p == '/') {
+        p = obj_parse_index(p + 1, end, chunk->normals.size(),
+                            OBJ_RELATIVE_VN, &corner.vn, &corner.flags);
+        if (!p)
+          return false;
+        corner.flags |= OBJ_HAS_VN;
+      }
+    }
+
+    if (p < end && !is_blank(*p))
+      return false;
+
+    //
+    //  Triangle fan around the first corner.
+    if (corner_count == 0)
+      first = corner;
+
+    if (corner_count >= 2) {
+      chunk->corners.push_back(first);
+      chunk->corners.push_back(prev);
+      chunk->corners.push_back(corner);
+    }
+
+    prev = corner;
+    ++corner_count;
+  }
+
+  return true;
+}
+
+static void obj_parse_chunk(obj_chunk* chunk) {
+  const char* p   = chunk->text.first;
+  const char* end = chunk->text.last;
+
+  while (p < end) {
+    const char* eol = line_end(p, end);
+    const char* s   = skip_blanks(p, eol);
+    bool        ok  = true;
+
+    if (eol - s >= 2 && s[0] == 'v') {
+      if (is_blank(s[1])) {
+        float3 pos;
+        ok = parse_floats(s + 2, eol, 3, 3, &pos.x);
+        chunk->positions.push_back(pos);
+      } else if (s[1] == 't' && eol - s >= 3 && is_blank(s[2])) {
+        float2 uv{0.0f, 0.0f};
+        ok = parse_floats(s + 3, eol, 2, 1, &uv.x);
+        chunk->texcoords.push_back(uv);
+      } else if (s[1] == 'n' && eol - s >= 3 && is_blank(s[2])) {
+        float3 n;
+        ok = parse_floats(s + 3, eol, 3, 3, &n.x);
+        chunk->normals.push_back(n);
+      }
+    } else if (eol - s >= 2 && s[0] == 'f' && is_blank(s[1])) {
+      ok = obj_parse_face(s + 2, eol, chunk);
+    }
+
+    if (!ok) {
+      chunk->error_line = s;
+      return;
+    }
+
+    p = eol < end ? eol + 1 : end;
+  }
+}
+
+static uint64_t obj_corner_hash(const obj_corner& c) noexcept {
+  //
+  //  splitmix64 finalizer over the combined indices.
+  uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(c.v)) *
+                   0x9E3779B97F4A7C15ull ^
+               static_cast<uint64_t>(static_cast<uint32_t>(c.vt)) *
+                   0xC2B2AE3D27D4EB4Full ^
+               static_cast<uint64_t>(static_cast<uint32_t>(c.vn)) *
+                   0x165667B19E3779F9ull;
+
+  h ^= h >> 30;
+  h *= 0xBF58476D1CE4E5B9ull;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBull;
+  h ^= h >> 31;
+  return h;
+}
+
+//
+//  Assigns one vertex to each distinct (v, vt, vn) tuple, in the order the
+//  tuples are first used, and writes the vertex index of every corner.
+//  Open addressing table of vertex indices, the keys are the tuples
+//  themselves.
+static void obj_unique_corners(const vector<obj_chunk>& chunks,
+                               const size_t             corner_count,
+                               vector<obj_corner>*      unique_corners,
+                               uint32_t*                indices) {
+  static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+  size_t capacity = 1024;
+  while (capacity < corner_count / 2)
+    capacity *= 2;
+
+  vector<uint32_t> slots(capacity, EMPTY_SLOT);
+  unique_corners->clear();
+
+  const auto insert_slot = [](vector<uint32_t>* table, const uint64_t hash,
+                              const uint32_t value) {
+    const auto mask = table->size() - 1;
+    for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+      if ((*table)[slot] == EMPTY_SLOT) {
+        (*table)[slot] = value;
+        return;
+      }
+    }
+  };
+
+  size_t out_index = 0;
+  for (const auto& chunk : chunks) {
+    for (const auto& corner : chunk.corners) {
+      const auto hash = obj_corner_hash(corner);
+      auto       mask = slots.size() - 1;
+      auto       slot = hash & mask;
+      uint32_t   vertex_index = EMPTY_SLOT;
+
+      for (;; slot = (slot + 1) & mask) {
+        const auto candidate = slots[slot];
+        if (candidate == EMPTY_SLOT)
+          break;
+
+        const auto& other = (*unique_corners)[candidate];
+        if (other.v == corner.v && other.vt == corner.vt &&
+            other.vn == corner.vn) {
+          vertex_index = candidate;
+          break;
+        }
+      }
+
+      if (vertex_index == EMPTY_SLOT) {
+        vertex_index = static_cast<uint32_t>(unique_corners->size());
+        unique_corners->push_back(corner);
+        slots[slot] = vertex_index;
+
+        //
+        //  Keep the load factor under 1/2.
+        if (unique_corners->size() * 2 > slots.size()) {
+          slots.assign(slots.size() * 2, EMPTY_SLOT);
+          for (uint32_t i = 0; i < unique_corners->size(); ++i)
+            insert_slot(&slots, obj_corner_hash((*unique_corners)[i]), i);
+          mask = slots.size() - 1;
+        }
+      }
+
+      indices[out_index++] = vertex_index;
+    }
+  }
+}
+
+static bool import_obj(const char* text, const size_t size,
+                       geometry_data_t* mesh, native_import_info* info) {
+  const auto        ranges = split_lines(text, size);
+  vector<obj_chunk> chunks(ranges.size());
+
+  for (size_t i = 0; i < ranges.size(); ++i)
+    chunks[i].text = ranges[i];
+
+  tbb::parallel_for(size_t{0}, chunks.size(),
+                    [&chunks](const size_t i) { obj_parse_chunk(&chunks[i]); });
+
+  //
+  //  Every chunk numbers its elements from 0, compute where each chunk starts
+  //  in the file wide arrays.
+  struct chunk_bases {
+    size_t v;
+    size_t vt;
+    size_t vn;
+    size_t corner;
+  };
+
+  vector<chunk_bases> bases(chunks.size());
+  chunk_bases         totals{0, 0, 0, 0};
+
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    if (chunks[i].error_line) {
+      log_malformed_line("OBJ", chunks[i].error_line, chunks[i].text.last);
+      return false;
+    }
+
+    bases[i] = totals;
+    totals.v += chunks[i].positions.size();
+    totals.vt += chunks[i].texcoords.size();
+    totals.vn += chunks[i].normals.size();
+    totals.corner += chunks[i].corners.size();
+  }
+
+  if (totals.corner == 0) {
+    XR_LOG_ERR("OBJ : no faces");
+    return false;
+  }
+
+  if (totals.v > INT32_MAX || totals.vt > INT32_MAX || totals.vn > INT32_MAX ||
+      totals.corner > UINT32_MAX) {
+    XR_LOG_ERR("OBJ : too many elements");
+    return false;
+  }
+
+  vector<float3> positions(totals.v);
+  vector<float2> texcoords(totals.vt);
+  vector<float3> normals(totals.vn);
+  atomic<bool>   valid_indices{true};
+  atomic<bool>   all_normals{true};
+  atomic<bool>   all_texcoords{true};
+
+  //
+  //  Merge the attribute arrays and turn the corner indices into file wide
+  //  indices.
+  tbb::parallel_for(size_t{0}, chunks.size(), [&](const size_t i) {
+    auto&       chunk = chunks[i];
+    const auto& base  = bases[i];
+
+    copy(begin(chunk.positions), end(chunk.positions),
+         begin(positions) + base.v);
+    copy(begin(chunk.texcoords), end(chunk.texcoords),
+         begin(texcoords) + base.vt);
+    copy(begin(chunk.normals), end(chunk.normals), begin(normals) + base.vn);
+
+    const auto resolve = [](int32_t* index, const bool present,
+                            const bool relative, const size_t chunk_base,
+                            const size_t total) {
+      if (!present) {
+        *index = -1;
+        return true;
+      }
+
+      const auto value =
+          relative ? static_cast<int64_t>(chunk_base) + *index : *index;
+      if (value < 0 || value >= static_cast<int64_t>(total))
+        return false;
+
+      *index = static_cast<int32_t>(value);
+      return true;
+    };
+
+    bool chunk_valid     = true;
+    bool chunk_normals   = true;
+    bool chunk_texcoords = true;
+
+    for (auto& c : chunk.corners) {
+      chunk_valid &=
+          resolve(&c.v, true, (c.flags & OBJ_RELATIVE_V) != 0, base.v,
+                  totals.v) &&
+          resolve(&c.vt, (c.flags & OBJ_HAS_VT) != 0,
+                  (c.flags & OBJ_RELATIVE_VT) != 0, base.vt, totals.vt) &&
+          resolve(&c.vn, (c.flags & OBJ_HAS_VN) != 0,
+                  (c.flags & OBJ_RELATIVE_VN) != 0, base.vn, totals.vn);
+
+      chunk_texcoords &= (c.flags & OBJ_HAS_VT) != 0;
+      chunk_normals &= (c.flags & OBJ_HAS_VN) != 0;
+      c.flags = 0;
+    }
+
+    if (!chunk_valid)
+      valid_indices = false;
+    if (!chunk_normals)
+      all_normals = false;
+    if (!chunk_texcoords)
+      all_texcoords = false;
+
+    chunk.positions.clear();
+    chunk.positions.shrink_to_fit();
+    chunk.texcoords.clear();
+    chunk.texcoords.shrink_to_fit();
+    chunk.normals.clear();
+    chunk.normals.shrink_to_fit();
+  });
+
+  if (!valid_indices) {
+    XR_LOG_ERR("OBJ : face index out of range");
+    return false;
+  }
+
+  vector<obj_corner> unique_corners;
+  unique_corners.reserve(totals.v);
+  vector<uint32_t> indices(totals.corner);
+  obj_unique_corners(chunks, totals.corner, &unique_corners, indices.data());
+
+  mesh->setup(unique_corners.size(), totals.corner);
+  copy(begin(indices), end(indices), raw_ptr(mesh->indices));
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, unique_corners.size(), CONVERSION_GRAIN},
+      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+          const auto& c = unique_corners[i];
+          auto&       v = mesh->geometry[i];
+
+          v.position  = positions[c.v];
+          v.normal    = c.vn >= 0 ? normals[c.vn] : float3::stdc::zero;
+          v.tangent   = float3::stdc::zero;
+          v.texcoords = c.vt >= 0 ? texcoords[c.vt] : DEFAULT_TEXCOORDS;
+        }
+      });
+
+  info->has_normals   = all_normals;
+  info->has_texcoords = all_texcoords;
+  return true;
+}
+
+///
+/// PLY (Stanford polygon file).
+
+enum class ply_type : uint8_t {
+  none,
+  int8,
+  uint8,
+  int16,
+  uint16,
+  int32,
+  uint32,
+  float32,
+  float64
+};
+
+enum class ply_encoding : uint8_t { ascii, binary_le, binary_be };
+
+struct ply_property {
+  string   name;
+  ply_type type{ply_type::none};
+
+  ///< Type of the element count for list properties, none otherwise.
+  ply_type count_type{ply_type::none};
+};
+
+struct ply_element {
+  string               name;
+  size_t               count{0};
+  vector<ply_property> properties;
+};
+
+struct ply_vertex_layout {
+  int32_t position[3]{-1, -1, -1};
+  int32_t normal[3]{-1, -1, -1};
+  int32_t texcoord[2]{-1, -1};
+};
+
+static ply_type ply_type_from_name(const string& name) noexcept {
+  static constexpr struct {
+    const char* name;
+    ply_type    type;
+  } PLY_TYPE_NAMES[] = {
+      {"char", ply_type::int8},      {"int8", ply_type::int8},
+      {"uchar", ply_type::uint8},    {"uint8", ply_type::uint8},
+      {"short", ply_type::int16},    {"int16", ply_type::int16},
+      {"ushort", ply_type::uint16},  {"uint16", ply_type::uint16},
+      {"int", ply_type::int32},      {"int32", ply_type::int32},
+      {"uint", ply_type::uint32},    {"uint32", ply_type::uint32},
+      {"float", ply_type::float32},  {"float32", ply_type::float32},
+      {"double", ply_type::float64}, {"float64", ply_type::float64}};
+
+  for (const auto& entry : PLY_TYPE_NAMES) {
+    if (name == entry.name)
+      return entry.type;
+  }
+
+  return ply_type::none;
+}
+
+static size_t ply_type_size(const ply_type type) noexcept {
+  switch (type) {
+  case ply_type::int8:
+  case ply_type::uint8:
+    return 1;
+  case ply_type::int16:
+  case ply_type::uint16:
+    return 2;
+  case ply_type::int32:
+  case ply_type::uint32:
+  case ply_type::float32:
+    return 4;
+  case ply_type::float64:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+static bool ply_is_integer(const ply_type type) noexcept {
+  return type != ply_type::none && type != ply_type::float32 &&
+         type != ply_type::float64;
+}
+
+template <typename T>
+static T ply_load(const uint8_t* src, const bool swap_bytes) noexcept {
+  uint8_t bytes[sizeof(T)];
+  memcpy(bytes, src, sizeof(T));
+
+  if (swap_bytes)
+    reverse(begin(bytes), end(bytes));
+
+  T value;
+  memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+static double ply_read(const uint8_t* src, const ply_type type,
+                       const bool swap_bytes) noexcept {
+  switch (type) {
+  case ply_type::int8:
+    return ply_load<int8_t>(src, swap_bytes);
+  case ply_type::uint8:
+    return ply_load<uint8_t>(src, swap_bytes);
+  case ply_type::int16:
+    return ply_load<int16_t>(src, swap_bytes);
+  case ply_type::uint16:
+    return ply_load<uint16_t>(src, swap_bytes);
+  case ply_type::int32:
+    return ply_load<int32_t>(src, swap_bytes);
+  case ply_type::uint32:
+    return ply_load<uint32_t>(src, swap_bytes);
+  case ply_type::float32:
+    return ply_load<float>(src, swap_bytes);
+  case ply_type::float64:
+    return ply_load<double>(src, swap_bytes);
+  default:
+    return 0.0;
+  }
+}
+
+static bool host_is_little_endian() noexcept {
+  const uint16_t value = 1;
+  uint8_t        first_byte;
+  memcpy(&first_byte, &value, 1);
+  return first_byte == 1;
+}
+
+//
+//  Parses the header, returns the offset of the first byte of the body or 0
+//  on error.
+static size_t ply_parse_header(const char* data, const size_t size,
+                               ply_encoding*        encoding,
+                               vector<ply_element>* elements) {
+  static constexpr char END_HEADER[] = "end_header";
+
+  const char* end        = data + size;
+  const char* header_end = nullptr;
+
+  for (const char* p = data; p < end;) {
+    const char* eol = line_end(p, end);
+    const char* s   = skip_blanks(p, eol);
+
+    if (static_cast<size_t>(eol - s) >= sizeof(END_HEADER) - 1 &&
+        memcmp(s, END_HEADER, sizeof(END_HEADER) - 1) == 0) {
+      header_end = eol < end ? eol + 1 : end;
+      break;
+    }
+
+    p = eol < end ? eol + 1 : end;
+  }
+
+  if (!header_end) {
+    XR_LOG_ERR("PLY : missing end_header");
+    return 0;
+  }
+
+  istringstream header{string{data, header_end}};
+  string        line;
+  bool          format_found = false;
+
+  if (!getline(header, line) || line.compare(0, 3, "ply") != 0) {
+    XR_LOG_ERR("PLY : not a PLY file");
+    return 0;
+  }
+
+  while (getline(header, line)) {
+    istringstream tokens{line};
+    string        keyword;
+    tokens >> keyword;
+
+    if (keyword == "format") {
+      string name;
+      tokens >> name;
+
+      if (name == "ascii")
+        *encoding = ply_encoding::ascii;
+      else if (name == "binary_little_endian")
+        *encoding = ply_encoding::binary_le;
+      else if (name == "binary_big_endian")
+        *encoding = ply_encoding::binary_be;
+      else {
+        XR_LOG_ERR("PLY : unknown format {}", name);
+        return 0;
+      }
+
+      format_found = true;
+    } else if (keyword == "element") {
+      ply_element element;
+      if (!(tokens >> element.name >> element.count)) {
+        XR_LOG_ERR("PLY : malformed element \"{}\"", line);
+        return 0;
+      }
+
+      elements->push_back(move(element));
+    } else if (keyword == "property") {
+      if (elements->empty()) {
+        XR_LOG_ERR("PLY : property outside of an element");
+        return 0;
+      }
+
+      ply_property prop;
+      string       type_name;
+      tokens >> type_name;
+
+      if (type_name == "list") {
+        string count_type_name;
+        tokens >> count_type_name >> type_name;
+        prop.count_type = ply_type_from_name(count_type_name);
+
+        if (!ply_is_integer(prop.count_type)) {
+          XR_LOG_ERR("PLY : malformed property \"{}\"", line);
+          return 0;
+        }
+      }
+
+      prop.type = ply_type_from_name(type_name);
+      tokens >> prop.name;
+
+      if (prop.type == ply_type::none || prop.name.empty()) {
+        XR_LOG_ERR("PLY : malformed property \"{}\"", line);
+        return 0;
+      }
+
+      elements->back().properties.push_back(move(prop));
+    }
+  }
+
+  if (!format_found) {
+    XR_LOG_ERR("PLY : missing format");
+    return 0;
+  }
+
+  return static_cast<size_t>(header_end - data);
+}
+
+static bool ply_vertex_layout_from(const ply_element& element,
+                                   ply_vertex_layout* layout) {
+  static constexpr const char* U_NAMES[] = {"u", "s", "texture_u",
+                                            "texture_s"};
+  static constexpr const char* V_NAMES[] = {"v", "t", "texture_v",
+                                            "texture_t"};
+
+  for (size_t i = 0; i < element.properties.size(); ++i) {
+    const auto& prop  = element.properties[i];
+    const auto  index = static_cast<int32_t>(i);
+
+    if (prop.count_type != ply_type::none) {
+      XR_LOG_ERR("PLY : list property {} in vertex element", prop.name);
+      return false;
+    }
+
+    const auto name_is = [&prop](const char* const* names, const size_t n) {
+      return find_if(names, names + n, [&prop](const char* name) {
+               return prop.name == name;
+             }) != names + n;
+    };
+
+    if (prop.name == "x")
+      layout->position[0] = index;
+    else if (prop.name == "y")
+      layout->position[1] = index;
+    else if (prop.name == "z")
+      layout->position[2] = index;
+    else if (prop.name == "nx")
+      layout->normal[0] = index;
+    else if (prop.name == "ny")
+      layout->normal[1] = index;
+    else if (prop.name == "nz")
+      layout->normal[2] = index;
+    else if (name_is(U_NAMES, XR_COUNTOF__(U_NAMES)))
+      layout->texcoord[0] = index;
+    else if (name_is(V_NAMES, XR_COUNTOF__(V_NAMES)))
+      layout->texcoord[1] = index;
+  }
+
+  if (layout->position[0] < 0 || layout->position[1] < 0 ||
+      layout->position[2] < 0) {
+    XR_LOG_ERR("PLY : vertex element without x, y, z");
+    return false;
+  }
+
+  return true;
+}
+
+static bool ply_has_normals(const ply_vertex_layout& layout) noexcept {
+  return layout.normal[0] >= 0 && layout.normal[1] >= 0 &&
+         layout.normal[2] >= 0;
+}
+
+static bool ply_has_texcoords(const ply_vertex_layout& layout) noexcept {
+  return layout.texcoord[0] >= 0 && layout.texcoord[1] >= 0;
+}
+
+static void ply_make_vertex(const ply_vertex_layout& layout,
+                            const float* values, vertex_pntt* vertex) noexcept {
+  vertex->position = float3{values[layout.position[0]],
+                            values[layout.position[1]],
+                            values[layout.position[2]]};
+  vertex->normal   = ply_has_normals(layout)
+                       ? float3{values[layout.normal[0]],
+                                values[layout.normal[1]],
+                                values[layout.normal[2]]}
+                       : float3::stdc::zero;
+  vertex->tangent   = float3::stdc::zero;
+  vertex->texcoords = ply_has_texcoords(layout)
+                          ? float2{values[layout.texcoord[0]],
+                                   values[layout.texcoord[1]]}
+                          : DEFAULT_TEXCOORDS;
+}
+
+//
+//  Index of the vertex index list in a face element, -1 if missing.
+static int32_t ply_face_indices_property(const ply_element& element) {
+  for (size_t i = 0; i < element.properties.size(); ++i) {
+    const auto& prop = element.properties[i];
+    if ((prop.name == "vertex_indices" || prop.name == "vertex_index") &&
+        prop.count_type != ply_type::none && ply_is_integer(prop.type)) {
+      return static_cast<int32_t>(i);
+    }
+  }
+
+  return -1;
+}
+
+static void append_fan(const uint32_t* polygon, const size_t corner_count,
+                       vector<uint32_t>* triangles) {
+  for (size_t i = 2; i < corner_count; ++i) {
+    triangles->push_back(polygon[0]);
+    triangles->push_back(polygon[i - 1]);
+    triangles->push_back(polygon[i]);
+  }
+}
+
+static bool ply_valid_indices(const vector<uint32_t>& indices,
+                              const size_t            vertex_count) {
+  return all_of(begin(indices), end(indices),
+                [vertex_count](const uint32_t idx) {
+                  return idx < vertex_count;
+                });
+}
+
+static bool ply_read_binary(const uint8_t* body, const size_t body_size,
+                            const bool                 swap_bytes,
+                            const vector<ply_element>& elements,
+                            geometry_data_t*           mesh,
+                            vector<uint32_t>*          triangles,
+                            const ply_vertex_layout&   layout) {
+  const uint8_t* p   = body;
+  const uint8_t* end = body + body_size;
+
+  const auto truncated = [] {
+    XR_LOG_ERR("PLY : unexpected end of file");
+    return false;
+  };
+
+  for (size_t elem_idx = 0; elem_idx < elements.size(); ++elem_idx) {
+    const auto& element = elements[elem_idx];
+
+    if (element.name == "vertex") {
+      vector<size_t> offsets;
+      size_t         stride = 0;
+      for (const auto& prop : element.properties) {
+        offsets.push_back(stride);
+        stride += ply_type_size(prop.type);
+      }
+
+      if (static_cast<size_t>(end - p) / stride < element.count)
+        return truncated();
+
+      tbb::parallel_for(
+          tbb::blocked_range<size_t>{0, element.count, CONVERSION_GRAIN},
+          [&](const tbb::blocked_range<size_t>& range) {
+            vector<float> values(element.properties.size());
+
+            for (size_t i = range.begin(); i < range.end(); ++i) {
+              const uint8_t* src = p + i * stride;
+              for (size_t k = 0; k < values.size(); ++k) {
+                values[k] = static_cast<float>(ply_read(
+                    src + offsets[k], element.properties[k].type, swap_bytes));
+              }
+
+              ply_make_vertex(layout, values.data(), &mesh->geometry[i]);
+            }
+          });
+
+      p += element.count * stride;
+      continue;
+    }
+
+    const int32_t indices_prop =
+        element.name == "face" ? ply_face_indices_property(element) : -1;
+
+    if (element.name == "face" && indices_prop < 0) {
+      XR_LOG_ERR("PLY : face element without vertex_indices");
+      return false;
+    }
+
+    //
+    //  Fast path : faces made of the index list only, all of them triangles.
+    //  Every face then has the same size and the conversion can run in
+    //  parallel. Verified before use, mixed polygons go through the generic
+    //  loop below.
+    if (indices_prop >= 0 && element.properties.size() == 1) {
+      const auto& prop       = element.properties[0];
+      const auto  count_size = ply_type_size(prop.count_type);
+      const auto  index_size = ply_type_size(prop.type);
+      const auto  stride     = count_size + 3 * index_size;
+      const bool  last_element = elem_idx + 1 == elements.size();
+      const auto  remaining    = static_cast<size_t>(end - p);
+
+      if (remaining / stride >= element.count &&
+          (!last_element || remaining == element.count * stride)) {
+        atomic<bool> all_triangles{true};
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>{0, element.count, CONVERSION_GRAIN},
+            [&](const tbb::blocked_range<size_t>& range) {
+              for (size_t i = range.begin(); i < range.end(); ++i) {
+                if (ply_read(p + i * stride, prop.count_type, swap_bytes) !=
+                    3.0) {
+                  all_triangles = false;
+                  return;
+                }
+              }
+            });
+
+        if (all_triangles) {
+          const auto first_index = triangles->size();
+          triangles->resize(first_index + element.count * 3);
+
+          tbb::parallel_for(
+              tbb::blocked_range<size_t>{0, element.count, CONVERSION_GRAIN},
+              [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                  const uint8_t* src = p + i * stride + count_size;
+                  for (size_t k = 0; k < 3; ++k) {
+                    (*triangles)[first_index + i * 3 + k] =
+                        static_cast<uint32_t>(ply_read(
+                            src + k * index_size, prop.type, swap_bytes));
+                  }
+                }
+              });
+
+          p += element.count * stride;
+          continue;
+        }
+      }
+    }
+
+    //
+    //  Generic path : walk the element one property at a time.
+    vector<uint32_t> polygon;
+
+    for (size_t i = 0; i < element.count; ++i) {
+      for (size_t k = 0; k < element.properties.size(); ++k) {
+        const auto& prop      = element.properties[k];
+        const auto  type_size = ply_type_size(prop.type);
+
+        if (prop.count_type == ply_type::none) {
+          if (static_cast<size_t>(end - p) < type_size)
+            return truncated();
+          p += type_size;
+          continue;
+        }
+
+        const auto count_size = ply_type_size(prop.count_type);
+        if (static_cast<size_t>(end - p) < count_size)
+          return truncated();
+
+        const auto count = static_cast<size_t>(
+            ply_read(p, prop.count_type, swap_bytes));
+        p += count_size;
+
+        if (static_cast<size_t>(end - p) / type_size < count)
+          return truncated();
+
+        if (static_cast<int32_t>(k) == indices_prop) {
+          polygon.resize(count);
+          for (size_t c = 0; c < count; ++c) {
+            polygon[c] = static_cast<uint32_t>(
+                ply_read(p + c * type_size, prop.type, swap_bytes));
+          }
+          append_fan(polygon.data(), count, triangles);
+        }
+
+        p += count * type_size;
+      }
+    }
+  }
+
+  return true;
+}
+
+struct ply_text_chunk {
+  text_chunk       text;
+  size_t           first_line{0};
+  vector<uint32_t> triangles;
+  const char*      error_line{nullptr};
+};
+
+static bool ply_read_ascii(const char* body, const size_t body_size,
+                           const vector<ply_element>& elements,
+                           geometry_data_t*           mesh,
+                           vector<uint32_t>*          triangles,
+                           const ply_vertex_layout&   layout) {
+  //
+  //  One line per element instance. Count the lines of each chunk first so
+  //  that every chunk knows which element its lines belong to.
+  const auto             ranges = split_lines(body, body_size);
+  vector<ply_text_chunk> chunks(ranges.size());
+
+  tbb::parallel_for(size_t{0}, chunks.size(), [&](const size_t i) {
+    chunks[i].text = ranges[i];
+    chunks[i].first_line =
+        static_cast<size_t>(count(ranges[i].first, ranges[i].last, '\n'));
+  });
+
+  size_t line_count = 0;
+  for (auto& chunk : chunks) {
+    const auto chunk_lines = chunk.first_line;
+    chunk.first_line       = line_count;
+    line_count += chunk_lines;
+  }
+
+  vector<size_t> element_first_line;
+  size_t         total_lines = 0;
+  for (const auto& element : elements) {
+    element_first_line.push_back(total_lines);
+    total_lines += element.count;
+  }
+
+  if (line_count + 1 < total_lines) {
+    XR_LOG_ERR("PLY : unexpected end of file");
+    return false;
+  }
+
+  tbb::parallel_for(size_t{0}, chunks.size(), [&](const size_t chunk_idx) {
+    auto&            chunk = chunks[chunk_idx];
+    const char*      p     = chunk.text.first;
+    const char*      last  = chunk.text.last;
+    size_t           line  = chunk.first_line;
+    vector<float>    values;
+    vector<uint32_t> polygon;
+
+    for (; p < last && line < total_lines; ++line) {
+      const char* eol = line_end(p, last);
+
+      const auto elem_idx = static_cast<size_t>(
+          upper_bound(begin(element_first_line), end(element_first_line),
+                      line) -
+          begin(element_first_line) - 1);
+      const auto& element  = elements[elem_idx];
+      const auto  instance = line - element_first_line[elem_idx];
+
+      const bool    is_vertex    = element.name == "vertex";
+      const bool    is_face      = element.name == "face";
+      const int32_t indices_prop =
+          is_face ? ply_face_indices_property(element) : -1;
+
+      if (is_vertex || is_face) {
+        const char* s  = p;
+        bool        ok = true;
+
+        values.resize(element.properties.size());
+
+        for (size_t k = 0; ok && k < element.properties.size(); ++k) {
+          const auto& prop = element.properties[k];
+
+          if (prop.count_type == ply_type::none) {
+            s  = parse_float(s, eol, &values[k]);
+            ok = s != nullptr;
+            continue;
+          }
+
+          int64_t count = 0;
+          s             = parse_int(skip_blanks(s, eol), eol, &count);
+          ok            = s != nullptr && count >= 0;
+
+          polygon.clear();
+          for (int64_t c = 0; ok && c < count; ++c) {
+            int64_t index = 0;
+            s             = parse_int(skip_blanks(s, eol), eol, &index);
+            ok            = s != nullptr && index >= 0 && index <= UINT32_MAX;
+            polygon.push_back(static_cast<uint32_t>(index));
+          }
+
+          if (ok && static_cast<int32_t>(k) == indices_prop)
+            append_fan(polygon.data(), polygon.size(), &chunk.triangles);
+        }
+
+        if (!ok) {
+          chunk.error_line = p;
+          return;
+        }
+
+        if (is_vertex)
+          ply_make_vertex(layout, values.data(), &mesh->geometry[instance]);
+      }
+
+      p = eol < last ? eol + 1 : last;
+    }
+  });
+
+  size_t triangle_indices = 0;
+  for (const auto& chunk : chunks) {
+    if (chunk.error_line) {
+      log_malformed_line("PLY", chunk.error_line, chunk.text.last);
+      return false;
+    }
+
+    triangle_indices += chunk.triangles.size();
+  }
+
+  triangles->reserve(triangle_indices);
+  for (const auto& chunk : chunks)
+    triangles->insert(end(*triangles), begin(chunk.triangles),
+                      end(chunk.triangles));
+
+  return true;
+}
+
+static bool import_ply(const uint8_t* data, const size_t size,
+                       geometry_data_t* mesh, native_import_info* info) {
+  ply_encoding        encoding{ply_encoding::ascii};
+  vector<ply_element> elements;
+
+  const auto body_offset = ply_parse_header(
+      reinterpret_cast<const char*>(data), size, &encoding, &elements);
+  if (body_offset == 0)
+    return false;
+
+  const auto vertex_element =
+      find_if(begin(elements), end(elements),
+              [](const ply_element& e) { return e.name == "vertex"; });
+  const auto face_element =
+      find_if(begin(elements), end(elements),
+              [](const ply_element& e) { return e.name == "face"; });
+
+  if (vertex_element == end(elements) || face_element == end(elements)) {
+    XR_LOG_ERR("PLY : vertex or face element missing");
+    return false;
+  }
+
+  if (ply_face_indices_property(*face_element) < 0) {
+    XR_LOG_ERR("PLY : face element without vertex_indices");
+    return false;
+  }
+
+  if (vertex_element->count > UINT32_MAX) {
+    XR_LOG_ERR("PLY : too many vertices");
+    return false;
+  }
+
+  ply_vertex_layout layout;
+  if (!ply_vertex_layout_from(*vertex_element, &layout))
+    return false;
+
+  //
+  //  The face count is only an upper bound of the triangle count, the
+  //  index buffer is attached once all the faces are read.
+  mesh->setup(vertex_element->count, 0);
+
+  vector<uint32_t> triangles;
+  const bool       read_ok =
+      encoding == ply_encoding::ascii
+          ? ply_read_ascii(reinterpret_cast<const char*>(data) + body_offset,
+                           size - body_offset, elements, mesh, &triangles,
+                           layout)
+          : ply_read_binary(data + body_offset, size - body_offset,
+                            (encoding == ply_encoding::binary_le) !=
+                                host_is_little_endian(),
+                            elements, mesh, &triangles, layout);
+
+  if (!read_ok)
+    return false;
+
+  if (triangles.empty()) {
+    XR_LOG_ERR("PLY : no faces");
+    return false;
+  }
+
+  if (!ply_valid_indices(triangles, mesh->vertex_count)) {
+    XR_LOG_ERR("PLY : face index out of range");
+    return false;
+  }
+
+  mesh->index_count = triangles.size();
+  mesh->indices     = geometry_data_t::scoped_vector_array_t<uint32_t>{
+      new uint32_t[triangles.size()]};
+  copy(begin(triangles), end(triangles), raw_ptr(mesh->indices));
+
+  info->has_normals   = ply_has_normals(layout);
+  info->has_texcoords = ply_has_texcoords(layout);
+  return true;
+}
+
+bool xray::rendering::import_native_model(const void* data, const size_t size,
+                                          const native_model_format fmt,
+                                          geometry_data_t*          mesh,
+                                          native_import_info*       info) {
+  assert(data != nullptr);
+  assert(mesh != nullptr);
+  assert(info != nullptr);
+
+  bool imported = false;
+
+  if (fmt == native_model_format::obj)
+    imported = import_obj(static_cast<const char*>(data), size, mesh, info);
+  else if (fmt == native_model_format::ply)
+    imported = import_ply(static_cast<const uint8_t*>(data), size, mesh, info);
+
+  if (!imported)
+    return false;
+
+  geometry_submesh submesh;
+  submesh.base_vertex  = 0;
+  submesh.vertex_count = static_cast<uint32_t>(mesh->vertex_count);
+  submesh.index_offset = 0;
+  submesh.index_count  = static_cast<uint32_t>(mesh->index_count);
+  mesh->submeshes.push_back(submesh);
+
+  return true;
+}
@@ -0,0 +1,357 @@
+#include "xray/rendering/geometry/geometry_meshlet.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/aabb3.hpp"
+#include "xray/math/bounds_batch.hpp"
+#include "xray/math/frustum_culling.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/rendering/geometry/geometry_adjacency.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::math;
+using namespace xray::rendering;
+
+static constexpr uint32_t NO_TRIANGLE = 0xFFFFFFFFu;
+static constexpr uint8_t  NOT_IN_MESHLET = 0xFF;
+
+//
+//  Meshlet being filled. local_index maps a (zero based) vertex of the
+//  submesh to its slot in the meshlet, NOT_IN_MESHLET when absent.
+struct meshlet_builder {
+  meshlet_builder(const size_t vertex_count, const uint32_t max_verts,
+                  const uint32_t max_tris)
+      : local_index(vertex_count, NOT_IN_MESHLET)
+      , max_vertices{max_verts}
+      , max_triangles{max_tris} {
+    vertices.reserve(max_verts);
+    triangles.reserve(max_tris * 3);
+  }
+
+  uint32_t new_vertices(const uint32_t* tri) const noexcept {
+    return (local_index[tri[0]] == NOT_IN_MESHLET) +
+           (local_index[tri[1]] == NOT_IN_MESHLET) +
+           (local_index[tri[2]] == NOT_IN_MESHLET);
+  }
+
+  bool fits(const uint32_t* tri) const noexcept {
+    return triangles.size() / 3 < max_triangles &&
+           vertices.size() + new_vertices(tri) <= max_vertices;
+  }
+
+  void add(const uint32_t* tri) {
+    for (uint32_t c = 0; c < 3; ++c) {
+      auto& slot = local_index[tri[c]];
+      if (slot == NOT_IN_MESHLET) {
+        slot = static_cast<uint8_t>(vertices.size());
+        vertices.push_back(tri[c]);
+      }
+
+      triangles.push_back(slot);
+    }
+  }
+
+  void flush(const uint32_t base_vertex, meshlet_data* out) {
+    if (triangles.empty())
+      return;
+
+    meshlet m;
+    m.vertex_offset   = static_cast<uint32_t>(out->vertices.size());
+    m.triangle_offset = static_cast<uint32_t>(out->triangles.size() / 3);
+    m.vertex_count    = static_cast<uint32_t>(vertices.size());
+    m.triangle_count  = static_cast<uint32_t>(triangles.size() / 3);
+    out->meshlets.push_back(m);
+
+    for (const auto v : vertices) {
+      out->vertices.push_back(v + base_vertex);
+      local_index[v] = NOT_IN_MESHLET;
+    }
+
+    out->triangles.insert(end(out->triangles), begin(triangles),
+                          end(triangles));
+
+    vertices.clear();
+    triangles.clear();
+  }
+
+  vector<uint8_t>  local_index;
+  vector<uint32_t> vertices;
+  vector<uint8_t>  triangles;
+  uint32_t         max_vertices;
+  uint32_t         max_triangles;
+};
+
+//
+//  Greedily grows meshlets over the triangles of a submesh. The next
+//  triangle is the not yet emitted neighbour of a vertex of the meshlet
+//  that adds the fewest new vertices, which keeps meshlets round.
+//  When the meshlet has no such neighbour, or the best one does not fit,
+//  the meshlet is closed and the next one starts from that triangle, or
+//  from the first triangle not emitted yet.
+static void build_submesh_meshlets(gsl::span<const uint32_t> indices,
+                                   const size_t              vertex_count,
+                                   const uint32_t            base_vertex,
+                                   const uint32_t            max_vertices,
+                                   const uint32_t            max_triangles,
+                                   meshlet_data*             out) {
+  const auto tri_count = static_cast<uint32_t>(indices.size() / 3);
+
+  vector<uint32_t> tris(static_cast<size_t>(indices.size()));
+  for (size_t i = 0; i < tris.size(); ++i)
+    tris[i] = indices[static_cast<ptrdiff_t>(i)] - base_vertex;
+
+  vertex_face_adjacency adj;
+  build_vertex_face_adjacency(
+      gsl::span<const uint32_t>{tris.data(),
+                                static_cast<ptrdiff_t>(tris.size())},
+      vertex_count, 0, &adj);
+
+  vector<uint8_t> emitted(tri_count, 0);
+  meshlet_builder builder{vertex_count, max_vertices, max_triangles};
+
+  const auto best_neighbour = [&](const uint32_t* verts, const size_t count) {
+    uint32_t best       = NO_TRIANGLE;
+    uint32_t best_score = 4;
+
+    for (size_t i = 0; i < count && best_score > 0; ++i) {
+      for (const auto f : adj.faces_of(verts[i])) {
+        if (emitted[f])
+          continue;
+
+        const auto score = builder.new_vertices(&tris[f * 3]);
+        if (score < best_score) {
+          best       = f;
+          best_score = score;
+        }
+      }
+    }
+
+    return best;
+  };
+
+  uint32_t cursor = 0;
+
+  for (uint32_t emitted_count = 0; emitted_count < tri_count;
+       ++emitted_count) {
+    uint32_t next = NO_TRIANGLE;
+
+    if (!builder.vertices.empty())
+      next = best_neighbour(builder.vertices.data(), builder.vertices.size());
+
+    if (next == NO_TRIANGLE) {
+      while (emitted[cursor])
+        ++cursor;
+      next = cursor;
+    }
+
+    if (!builder.fits(&tris[next * 3])) {
+      builder.flush(base_vertex, out);
+
+      //
+      //  Start the new meshlet from the first pending triangle rather than
+      //  from a neighbour of the old one, which sits on its rim.
+      while (emitted[cursor])
+        ++cursor;
+      next = cursor;
+    }
+
+    builder.add(&tris[next * 3]);
+    emitted[next] = 1;
+  }
+
+  builder.flush(base_vertex, out);
+}
+
+//
+//  Bounding sphere and normal cone of a meshlet (cone as in Kapoulkine,
+//  meshoptimizer).
+static void compute_meshlet_bounds(const meshlet& m, const meshlet_data& data,
+                                   const vertex_pntt* vertices,
+                                   sphere3f* sphere, meshlet_cone* cone) {
+  float3 positions[256];
+  assert(m.vertex_count <= 256);
+
+  for (uint32_t i = 0; i < m.vertex_count; ++i)
+    positions[i] = vertices[data.vertices[m.vertex_offset + i]].position;
+
+  const auto box = compute_aabb(positions, sizeof(float3), m.vertex_count);
+  *sphere = compute_bounding_sphere(positions, sizeof(float3), m.vertex_count,
+                                    box);
+
+  const auto tris = &data.triangles[m.triangle_offset * 3];
+  const auto tri_normal = [&positions, tris](const uint32_t t) {
+    const auto& p0 = positions[tris[t * 3 + 0]];
+    const auto& p1 = positions[tris[t * 3 + 1]];
+    const auto& p2 = positions[tris[t * 3 + 2]];
+    return cross(p1 - p0, p2 - p0);
+  };
+
+  float3 axis_sum = float3::stdc::zero;
+  for (uint32_t t = 0; t < m.triangle_count; ++t) {
+    const auto n   = tri_normal(t);
+    const auto len = length(n);
+    if (len > 0.0f)
+      axis_sum += n / len;
+  }
+
+  cone->apex   = sphere->center;
+  cone->axis   = float3::stdc::zero;
+  cone->cutoff = 1.0f;
+
+  const auto axis_len = length(axis_sum);
+  if (axis_len <= 0.0f)
+    return;
+
+  const auto axis = axis_sum / axis_len;
+
+  //
+  //  Smallest cosine between the axis and a triangle normal, and the
+  //  distance to move the apex back along the axis so that the cone
+  //  contains every triangle plane.
+  float min_dot = 1.0f;
+  float max_t   = 0.0f;
+
+  for (uint32_t t = 0; t < m.triangle_count; ++t) {
+    const auto n   = tri_normal(t);
+    const auto len = length(n);
+    if (len <= 0.0f)
+      continue;
+
+    const auto unit_n = n / len;
+    const auto dp     = dot(unit_n, axis);
+    min_dot           = std::min(min_dot, dp);
+
+    if (dp > 0.0f) {
+      const auto dc = dot(positions[tris[t * 3]] - sphere->center, unit_n);
+      max_t         = std::max(max_t, -dc / dp);
+    }
+  }
+
+  //
+  //  Normals spread over more than about 84 degrees : the cone would
+  //  almost never cull anything.
+  if (min_dot <= 0.1f)
+    return;
+
+  cone->apex   = sphere->center - axis * max_t;
+  cone->axis   = axis;
+  cone->cutoff = std::sqrt(1.0f - min_dot * min_dot);
+}
+
+void xray::rendering::build_meshlets(const geometry_data_t& mesh,
+                                     meshlet_data*          out,
+                                     const uint32_t         max_vertices,
+                                     const uint32_t         max_triangles) {
+  assert(out != nullptr);
+  assert(max_vertices >= 3 && max_vertices <= 255);
+  assert(max_triangles >= 1);
+
+  out->meshlets.clear();
+  out->spheres.clear();
+  out->cones.clear();
+  out->vertices.clear();
+  out->triangles.clear();
+  out->submesh_offsets.assign(1, 0);
+
+  const auto index_count =
+      mesh.lods.empty() ? mesh.index_count : mesh.lods[0].index_count;
+
+  const auto build_range = [&](const uint32_t index_offset,
+                               const uint32_t range_indices,
+                               const uint32_t base_vertex,
+                               const size_t   vertex_count) {
+    assert(index_offset + range_indices <= index_count);
+    build_submesh_meshlets(
+        gsl::span<const uint32_t>{raw_ptr(mesh.indices) + index_offset,
+                                  static_cast<ptrdiff_t>(range_indices)},
+        vertex_count, base_vertex, max_vertices, max_triangles, out);
+    out->submesh_offsets.push_back(
+        static_cast<uint32_t>(out->meshlets.size()));
+  };
+
+  if (mesh.submeshes.empty()) {
+    build_range(0, static_cast<uint32_t>(index_count), 0, mesh.vertex_count);
+  } else {
+    for (const auto& sm : mesh.submeshes)
+      build_range(sm.index_offset, sm.index_count, sm.base_vertex,
+                  sm.vertex_count);
+  }
+
+  const auto meshlet_count = out->meshlets.size();
+  out->spheres.resize(meshlet_count);
+  out->cones.resize(meshlet_count);
+
+  tbb::parallel_for(tbb::blocked_range<size_t>{0, meshlet_count, 64},
+                    [out, &mesh](const tbb::blocked_range<size_t>& rng) {
+                      for (size_t i = rng.begin(); i < rng.end(); ++i) {
+                        compute_meshlet_bounds(
+                            out->meshlets[i], *out, raw_ptr(mesh.geometry),
+                            &out->spheres[i], &out->cones[i]);
+                      }
+                    });
+}
+
+size_t xray::rendering::meshlet_culler::cull(const meshlet_data& data,
+                                             const frustum3f&    frustum,
+                                             const float3&       eye_pos) {
+  const auto meshlet_count = data.meshlets.size();
+
+  _visibility_mask.resize(visibility_mask_words(meshlet_count));
+  cull_spheres(frustum,
+               gsl::span<const sphere3f>{data.spheres.data(),
+                                         static_cast<ptrdiff_t>(meshlet_count)},
+               gsl::span<uint32_t>{
+                   _visibility_mask.data(),
+                   static_cast<ptrdiff_t>(_visibility_mask.size())});
+
+  //
+  //  Compact the visible meshlets and prefix sum their index counts, so that
+  //  every meshlet knows where its triangles go in the output.
+  _visible.clear();
+  _offsets.clear();
+
+  uint32_t index_count = 0;
+  const gsl::span<const uint32_t> mask{
+      _visibility_mask.data(), static_cast<ptrdiff_t>(_visibility_mask.size())};
+
+  for (size_t i = 0; i < meshlet_count; ++i) {
+    if (!is_visible(mask, i))
+      continue;
+
+    const auto& cone = data.cones[i];
+    if (cone.cutoff < 1.0f &&
+        dot(normalize(cone.apex - eye_pos), cone.axis) >= cone.cutoff)
+      continue;
+
+    _visible.push_back(static_cast<uint32_t>(i));
+    _offsets.push_back(index_count);
+    index_count += data.meshlets[i].triangle_count * 3;
+  }
+
+  _index_count = index_count;
+  if (_indices.size() < index_count)
+    _indices.resize(index_count);
+
+  const auto dst = _indices.data();
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, _visible.size(), 32},
+      [this, &data, dst](const tbb::blocked_range<size_t>& rng) {
+        for (size_t i = rng.begin(); i < rng.end(); ++i) {
+          const auto& m    = data.meshlets[_visible[i]];
+          const auto  tris = &data.triangles[m.triangle_offset * 3];
+          const auto  verts = &data.vertices[m.vertex_offset];
+          auto        out   = dst + _offsets[i];
+
+          for (uint32_t k = 0; k < m.triangle_count * 3; ++k)
+            out[k] = verts[tris[k]];
+        }
+      });
+
+  return _index_count;
+}
@@ -0,0 +1,251 @@
+#include "xray/rendering/geometry/geometry_normals.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/constants.hpp"
+#include "xray/math/math_std.hpp"
+#include "xray/math/scalar2.hpp"
+#include "xray/math/scalar2_math.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <span.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::math;
+using namespace xray::rendering;
+
+//
+//  Vertices [base_vertex, base_vertex + vertex_count) of a mesh and the
+//  triangles referencing them.
+struct mesh_range {
+  vertex_pntt*              vertices;
+  size_t                    vertex_count;
+  gsl::span<const uint32_t> indices;
+  uint32_t                  base_vertex;
+
+  size_t face_count() const noexcept {
+    return static_cast<size_t>(indices.size()) / 3;
+  }
+
+  const vertex_pntt& corner(const size_t face, const uint32_t c) const
+      noexcept {
+    return vertices[indices[static_cast<ptrdiff_t>(face * 3 + c)] -
+                    base_vertex];
+  }
+};
+
+static constexpr size_t NORMALS_GRAIN_SIZE = 4096;
+
+static mesh_range whole_mesh(geometry_data_t* mesh) noexcept {
+  return {raw_ptr(mesh->geometry), mesh->vertex_count,
+          gsl::span<const uint32_t>{raw_ptr(mesh->indices),
+                                    static_cast<ptrdiff_t>(mesh->index_count)},
+          0};
+}
+
+static mesh_range submesh_range(geometry_data_t*        mesh,
+                                const geometry_submesh& sm) noexcept {
+  assert(sm.base_vertex + sm.vertex_count <= mesh->vertex_count);
+  assert(sm.index_offset + sm.index_count <= mesh->index_count);
+
+  return {raw_ptr(mesh->geometry) + sm.base_vertex, sm.vertex_count,
+          gsl::span<const uint32_t>{raw_ptr(mesh->indices) + sm.index_offset,
+                                    static_cast<ptrdiff_t>(sm.index_count)},
+          sm.base_vertex};
+}
+
+//
+//  Uses the caller's adjacency if there is one, otherwise builds it into
+//  storage.
+static const vertex_face_adjacency*
+get_adjacency(const mesh_range& rng, const vertex_face_adjacency* adjacency,
+              vertex_face_adjacency* storage) {
+  if (adjacency) {
+    assert(adjacency->vertex_count() == rng.vertex_count);
+    return adjacency;
+  }
+
+  build_vertex_face_adjacency(rng.indices, rng.vertex_count, rng.base_vertex,
+                              storage);
+  return storage;
+}
+
+//
+//  Angle of the corner of the face at vertex v.
+static float corner_angle(const mesh_range& rng, const size_t face,
+                          const uint32_t v) noexcept {
+  uint32_t c = 0;
+  while (c < 2 &&
+         rng.indices[static_cast<ptrdiff_t>(face * 3 + c)] - rng.base_vertex !=
+             v) {
+    ++c;
+  }
+
+  const auto& p  = rng.corner(face, c).position;
+  const auto  e0 = rng.corner(face, (c + 1) % 3).position - p;
+  const auto  e1 = rng.corner(face, (c + 2) % 3).position - p;
+
+  const auto len_product = length(e0) * length(e1);
+  if (is_zero(len_product))
+    return 0.0f;
+
+  return std::acos(clamp(dot(e0, e1) / len_product, -1.0f, 1.0f));
+}
+
+static void compute_normals_impl(const mesh_range&            rng,
+                                 const normal_weighting       weighting,
+                                 const vertex_face_adjacency* adjacency) {
+  if (rng.vertex_count == 0)
+    return;
+
+  vertex_face_adjacency adj_storage;
+  const auto adj = get_adjacency(rng, adjacency, &adj_storage);
+
+  //
+  //  Face normals first; the length of the cross product is twice the area
+  //  of the face.
+  const auto     face_count = rng.face_count();
+  vector<float3> face_normals(face_count);
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, face_count, NORMALS_GRAIN_SIZE},
+      [&rng, &face_normals, weighting](const tbb::blocked_range<size_t>& r) {
+        for (size_t f = r.begin(); f < r.end(); ++f) {
+          const auto& p0 = rng.corner(f, 0).position;
+          const auto& p1 = rng.corner(f, 1).position;
+          const auto& p2 = rng.corner(f, 2).position;
+
+          const auto n    = cross(p1 - p0, p2 - p0);
+          face_normals[f] = weighting == normal_weighting::area ? n
+                                                                 : normalize(n);
+        }
+      });
+
+  //
+  //  Then every vertex gathers the normals of its faces.
+  tbb::parallel_for(
+      tbb::blocked_range<uint32_t>{0, static_cast<uint32_t>(rng.vertex_count),
+                                   NORMALS_GRAIN_SIZE},
+      [&rng, &face_normals, adj,
+       weighting](const tbb::blocked_range<uint32_t>& r) {
+        for (uint32_t v = r.begin(); v < r.end(); ++v) {
+          float3 n{float3::stdc::zero};
+
+          for (const auto f : adj->faces_of(v)) {
+            if (weighting == normal_weighting::angle)
+              n += corner_angle(rng, f, v) * face_normals[f];
+            else
+              n += face_normals[f];
+          }
+
+          rng.vertices[v].normal = normalize(n);
+        }
+      });
+}
+
+//
+//  Returns a unit vector orthogonal to n.
+static float3 any_orthogonal(const float3& n) noexcept {
+  const auto axis = std::abs(n.x) < 0.9f ? float3::stdc::unit_x
+                                         : float3::stdc::unit_y;
+  return normalize(cross(n, axis));
+}
+
+static void compute_tangents_impl(const mesh_range&            rng,
+                                  const vertex_face_adjacency* adjacency) {
+  if (rng.vertex_count == 0)
+    return;
+
+  vertex_face_adjacency adj_storage;
+  const auto adj = get_adjacency(rng, adjacency, &adj_storage);
+
+  //
+  //  Solve for the direction of increasing u on each face :
+  //  e0 = du0 * T + dv0 * B, e1 = du1 * T + dv1 * B. Faces with degenerate
+  //  texture mappings contribute nothing. The unit tangent of each face is
+  //  weighted by the face area.
+  const auto     face_count = rng.face_count();
+  vector<float3> face_tangents(face_count);
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>{0, face_count, NORMALS_GRAIN_SIZE},
+      [&rng, &face_tangents](const tbb::blocked_range<size_t>& r) {
+        for (size_t f = r.begin(); f < r.end(); ++f) {
+          const auto& v0 = rng.corner(f, 0);
+          const auto& v1 = rng.corner(f, 1);
+          const auto& v2 = rng.corner(f, 2);
+
+          const auto e0   = v1.position - v0.position;
+          const auto e1   = v2.position - v0.position;
+          const auto duv0 = v1.texcoords - v0.texcoords;
+          const auto duv1 = v2.texcoords - v0.texcoords;
+
+          const auto det = duv0.x * duv1.y - duv1.x * duv0.y;
+          if (is_zero(det)) {
+            face_tangents[f] = float3::stdc::zero;
+            continue;
+          }
+
+          const auto t = (e0 * duv1.y - e1 * duv0.y) / det;
+          face_tangents[f] = normalize(t) * length(cross(e0, e1));
+        }
+      });
+
+  tbb::parallel_for(
+      tbb::blocked_range<uint32_t>{0, static_cast<uint32_t>(rng.vertex_count),
+                                   NORMALS_GRAIN_SIZE},
+      [&rng, &face_tangents, adj](const tbb::blocked_range<uint32_t>& r) {
+        for (uint32_t v = r.begin(); v < r.end(); ++v) {
+          float3 t{float3::stdc::zero};
+
+          for (const auto f : adj->faces_of(v))
+            t += face_tangents[f];
+
+          //
+          //  Gram-Schmidt against the normal.
+          const auto& n = rng.vertices[v].normal;
+          t             = normalize(t - dot(n, t) * n);
+
+          rng.vertices[v].tangent = is_zero_length(t) ? any_orthogonal(n) : t;
+        }
+      });
+}
+
+void xray::rendering::compute_normals(geometry_data_t*             mesh,
+                                      const normal_weighting       weighting,
+                                      const vertex_face_adjacency* adjacency) {
+  assert(mesh != nullptr);
+  assert((mesh->index_count % 3) == 0);
+  compute_normals_impl(whole_mesh(mesh), weighting, adjacency);
+}
+
+void xray::rendering::compute_normals(geometry_data_t*             mesh,
+                                      const geometry_submesh&      submesh,
+                                      const normal_weighting       weighting,
+                                      const vertex_face_adjacency* adjacency) {
+  assert(mesh != nullptr);
+  assert((submesh.index_count % 3) == 0);
+  compute_normals_impl(submesh_range(mesh, submesh), weighting, adjacency);
+}
+
+void xray::rendering::compute_tangents(geometry_data_t*             mesh,
+                                       const vertex_face_adjacency* adjacency) {
+  assert(mesh != nullptr);
+  assert((mesh->index_count % 3) == 0);
+  compute_tangents_impl(whole_mesh(mesh), adjacency);
+}
+
+void xray::rendering::compute_tangents(geometry_data_t*             mesh,
+                                       const geometry_submesh&      submesh,
+                                       const vertex_face_adjacency* adjacency) {
+  assert(mesh != nullptr);
+  assert((submesh.index_count % 3) == 0);
+  compute_tangents_impl(submesh_range(mesh, submesh), adjacency);
+}
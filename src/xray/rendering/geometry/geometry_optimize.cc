@@ -0,0 +1,472 @@
+#include "xray/rendering/geometry/geometry_optimize.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/rendering/geometry/geometry_adjacency.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::math;
+using namespace xray::rendering;
+
+//
+//  FIFO cache simulation. A vertex is in the cache if it was (re)loaded
+//  less than cache_size loads ago; resetting the cache just advances the
+//  clock past every stamp.
+class fifo_cache_sim {
+public:
+  fifo_cache_sim(const size_t vertex_count, const uint32_t cache_size)
+      : _stamps(vertex_count, 0u)
+      , _cache_size{cache_size}
+      , _time{cache_size + 1} {}
+
+  uint32_t add_triangle(const uint32_t* tri, const uint32_t base_vertex) {
+    uint32_t misses{};
+
+    for (uint32_t i = 0; i < 3; ++i) {
+      const auto v = tri[i] - base_vertex;
+      if (_time - _stamps[v] > _cache_size) {
+        _stamps[v] = _time++;
+        ++misses;
+      }
+    }
+
+    return misses;
+  }
+
+  void reset() noexcept { _time += _cache_size + 1; }
+
+private:
+  vector<uint32_t> _stamps;
+  uint32_t         _cache_size;
+  uint32_t         _time;
+};
+
+vertex_cache_stats
+xray::rendering::analyze_vertex_cache(gsl::span<const uint32_t> indices,
+                                      const size_t              vertex_count,
+                                      const uint32_t            base_vertex,
+                                      const uint32_t            cache_size) {
+  assert((indices.size() % 3) == 0);
+
+  vertex_cache_stats stats;
+  stats.triangles = static_cast<uint32_t>(indices.size() / 3);
+
+  if (stats.triangles == 0)
+    return stats;
+
+  fifo_cache_sim  cache{vertex_count, cache_size};
+  vector<uint8_t> referenced(vertex_count, 0);
+
+  for (uint32_t t = 0; t < stats.triangles; ++t) {
+    stats.vertices_transformed +=
+        cache.add_triangle(indices.data() + t * 3, base_vertex);
+  }
+
+  for (const auto idx : indices) {
+    referenced[idx - base_vertex] = 1;
+  }
+
+  stats.vertices = static_cast<uint32_t>(
+      std::count(begin(referenced), end(referenced), uint8_t{1}));
+
+  stats.acmr = static_cast<float>(stats.vertices_transformed) /
+               static_cast<float>(stats.triangles);
+  stats.atvr = static_cast<float>(stats.vertices_transformed) /
+               static_cast<float>(stats.vertices);
+
+  return stats;
+}
+
+vertex_cache_stats
+xray::rendering::analyze_vertex_cache(const geometry_data_t& mesh,
+                                      const uint32_t         cache_size) {
+  return analyze_vertex_cache(
+      gsl::span<const uint32_t>{raw_ptr(mesh.indices),
+                                static_cast<ptrdiff_t>(mesh.index_count)},
+      mesh.vertex_count, 0, cache_size);
+}
+
+//
+//  Forsyth's scoring : vertices recently used score higher (the 3 most
+//  recent ones get a fixed score so that strips are not favoured over fans),
+//  and vertices with few remaining triangles get a boost so that they are
+//  finished off instead of being left as isolated triangles.
+static constexpr uint32_t FORSYTH_CACHE_SIZE  = 32;
+static constexpr uint32_t FORSYTH_MAX_VALENCE = 32;
+
+struct forsyth_score_tables {
+  float cache[FORSYTH_CACHE_SIZE];
+  float valence[FORSYTH_MAX_VALENCE + 1];
+
+  forsyth_score_tables() noexcept {
+    constexpr float CACHE_DECAY_POWER   = 1.5f;
+    constexpr float LAST_TRI_SCORE      = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; ++i) {
+      cache[i] = i < 3 ? LAST_TRI_SCORE
+                       : std::pow(1.0f - static_cast<float>(i - 3) /
+                                             (FORSYTH_CACHE_SIZE - 3),
+                                  CACHE_DECAY_POWER);
+    }
+
+    valence[0] = 0.0f;
+    for (uint32_t i = 1; i <= FORSYTH_MAX_VALENCE; ++i) {
+      valence[i] = VALENCE_BOOST_SCALE *
+                   std::pow(static_cast<float>(i), -VALENCE_BOOST_POWER);
+    }
+  }
+
+  float score(const int32_t cache_pos, const uint32_t live_tris) const
+      noexcept {
+    if (live_tris == 0)
+      return -1.0f;
+
+    return (cache_pos >= 0 ? cache[cache_pos] : 0.0f) +
+           valence[std::min(live_tris, FORSYTH_MAX_VALENCE)];
+  }
+};
+
+void xray::rendering::optimize_vertex_cache(gsl::span<uint32_t> indices,
+                                            const size_t        vertex_count,
+                                            const uint32_t      base_vertex) {
+  assert((indices.size() % 3) == 0);
+
+  const auto face_count = static_cast<uint32_t>(indices.size() / 3);
+  if (face_count == 0)
+    return;
+
+  static const forsyth_score_tables tables;
+
+  //
+  //  The adjacency lists double as the lists of live (not yet emitted)
+  //  triangles of each vertex : emitted triangles are swapped past the end
+  //  of the live part.
+  vertex_face_adjacency adj;
+  build_vertex_face_adjacency(indices, vertex_count, base_vertex, &adj);
+
+  vector<uint32_t> live(vertex_count);
+  vector<int32_t>  cache_pos(vertex_count, -1);
+  vector<float>    vertex_score(vertex_count);
+
+  //
+  //  Output triangle (+ 1) whose cache update last added the vertex.
+  vector<uint32_t> added_at(vertex_count, 0);
+
+  for (size_t v = 0; v < vertex_count; ++v) {
+    live[v]         = adj.offsets[v + 1] - adj.offsets[v];
+    vertex_score[v] = tables.score(-1, live[v]);
+  }
+
+  vector<float>   tri_score(face_count);
+  vector<uint8_t> emitted(face_count, 0);
+
+  const auto tri_vertex = [&indices, base_vertex](const uint32_t t,
+                                                  const uint32_t c) {
+    return indices[static_cast<ptrdiff_t>(t * 3 + c)] - base_vertex;
+  };
+
+  uint32_t best_tri = 0;
+  for (uint32_t t = 0; t < face_count; ++t) {
+    tri_score[t] = vertex_score[tri_vertex(t, 0)] +
+                   vertex_score[tri_vertex(t, 1)] +
+                   vertex_score[tri_vertex(t, 2)];
+
+    if (tri_score[t] > tri_score[best_tri])
+      best_tri = t;
+  }
+
+  constexpr auto   NO_TRIANGLE = numeric_limits<uint32_t>::max();
+  vector<uint32_t> output(static_cast<size_t>(indices.size()));
+  uint32_t         cache[FORSYTH_CACHE_SIZE + 3];
+  uint32_t         cache_count{};
+  uint32_t         input_cursor{};
+
+  for (uint32_t out_tri = 0; out_tri < face_count; ++out_tri) {
+    if (best_tri == NO_TRIANGLE) {
+      //
+      //  Dead end, nothing in the cache has triangles left. Restart from the
+      //  first triangle not emitted yet.
+      while (emitted[input_cursor])
+        ++input_cursor;
+      best_tri = input_cursor;
+    }
+
+    uint32_t tri[3];
+    for (uint32_t c = 0; c < 3; ++c) {
+      tri[c]                  = tri_vertex(best_tri, c);
+      output[out_tri * 3 + c] = tri[c] + base_vertex;
+    }
+
+    emitted[best_tri] = 1;
+
+    //
+    //  Remove the triangle from the live lists of its vertices.
+    for (const auto v : tri) {
+      const auto first = adj.faces.begin() + adj.offsets[v];
+      const auto last  = first + live[v];
+      const auto pos   = std::find(first, last, best_tri);
+
+      if (pos != last) {
+        std::iter_swap(pos, last - 1);
+        --live[v];
+      }
+    }
+
+    //
+    //  New cache : the triangle's vertices in front, followed by the
+    //  previous contents. Entries pushed past the end fall out.
+    uint32_t new_cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t new_count{};
+
+    for (const auto v : tri) {
+      if (added_at[v] != out_tri + 1) {
+        added_at[v]            = out_tri + 1;
+        new_cache[new_count++] = v;
+      }
+    }
+
+    for (uint32_t i = 0; i < cache_count; ++i) {
+      const auto v = cache[i];
+      if (added_at[v] != out_tri + 1) {
+        added_at[v]            = out_tri + 1;
+        new_cache[new_count++] = v;
+      }
+    }
+
+    //
+    //  Rescore the vertices that moved and their live triangles, tracking
+    //  the best triangle among those touching the cache.
+    best_tri         = NO_TRIANGLE;
+    float best_score = -1.0f;
+
+    for (uint32_t i = 0; i < new_count; ++i) {
+      const auto v   = new_cache[i];
+      const auto pos = i < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+      cache_pos[v]         = pos;
+      const auto new_score = tables.score(pos, live[v]);
+      const auto delta     = new_score - vertex_score[v];
+      vertex_score[v]      = new_score;
+
+      for (uint32_t k = 0; k < live[v]; ++k) {
+        const auto t = adj.faces[adj.offsets[v] + k];
+        tri_score[t] += delta;
+
+        if (pos >= 0 && tri_score[t] > best_score) {
+          best_score = tri_score[t];
+          best_tri   = t;
+        }
+      }
+    }
+
+    cache_count = std::min(new_count, FORSYTH_CACHE_SIZE);
+    std::copy(new_cache, new_cache + cache_count, cache);
+  }
+
+  std::copy(begin(output), end(output), indices.begin());
+}
+
+void xray::rendering::optimize_overdraw(gsl::span<uint32_t> indices,
+                                        const vertex_pntt*  vertices,
+                                        const size_t        vertex_count,
+                                        const uint32_t      base_vertex,
+                                        const float         threshold) {
+  assert((indices.size() % 3) == 0);
+  assert(vertices != nullptr || vertex_count == 0);
+
+  const auto face_count = static_cast<uint32_t>(indices.size() / 3);
+  if (face_count == 0)
+    return;
+
+  //
+  //  Hard boundaries : triangles where the cache had to be refilled
+  //  completely, the ordering before and after them is independent.
+  fifo_cache_sim   cache{vertex_count, default_vertex_cache_size};
+  vector<uint32_t> hard_clusters;
+
+  for (uint32_t t = 0; t < face_count; ++t) {
+    if (cache.add_triangle(indices.data() + t * 3, base_vertex) == 3 ||
+        t == 0)
+      hard_clusters.push_back(t);
+  }
+
+  hard_clusters.push_back(face_count);
+
+  //
+  //  Soft boundaries : split hard clusters where the ACMR of the part
+  //  since the last split is already within threshold of the ACMR of the
+  //  whole cluster.
+  vector<uint32_t> clusters;
+
+  for (size_t h = 0; h + 1 < hard_clusters.size(); ++h) {
+    const auto first = hard_clusters[h];
+    const auto last  = hard_clusters[h + 1];
+
+    cache.reset();
+    uint32_t cluster_misses{};
+    for (uint32_t t = first; t < last; ++t)
+      cluster_misses += cache.add_triangle(indices.data() + t * 3, base_vertex);
+
+    const float cluster_threshold = threshold *
+                                    static_cast<float>(cluster_misses) /
+                                    static_cast<float>(last - first);
+
+    cache.reset();
+    uint32_t start{first};
+    uint32_t misses{};
+    clusters.push_back(first);
+
+    for (uint32_t t = first; t + 1 < last; ++t) {
+      misses += cache.add_triangle(indices.data() + t * 3, base_vertex);
+
+      if (static_cast<float>(misses) / static_cast<float>(t + 1 - start) <=
+          cluster_threshold) {
+        clusters.push_back(t + 1);
+        cache.reset();
+        start  = t + 1;
+        misses = 0;
+      }
+    }
+  }
+
+  clusters.push_back(face_count);
+  const auto cluster_count = clusters.size() - 1;
+
+  //
+  //  Sort the clusters by how much they face away from the centroid of the
+  //  mesh : outward facing clusters are drawn first and occlude the rest.
+  const auto position = [&indices, vertices, base_vertex](const uint32_t t,
+                                                          const uint32_t c) {
+    return vertices[indices[static_cast<ptrdiff_t>(t * 3 + c)] - base_vertex]
+        .position;
+  };
+
+  float3 mesh_centroid{float3::stdc::zero};
+  float  mesh_area{};
+
+  vector<float3> cluster_centroid(cluster_count, float3::stdc::zero);
+  vector<float3> cluster_normal(cluster_count, float3::stdc::zero);
+
+  for (size_t c = 0; c < cluster_count; ++c) {
+    float cluster_area{};
+
+    for (uint32_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+      const auto p0 = position(t, 0);
+      const auto p1 = position(t, 1);
+      const auto p2 = position(t, 2);
+
+      const auto n    = cross(p1 - p0, p2 - p0);
+      const auto area = length(n);
+      const auto ctr  = (p0 + p1 + p2) * (area / 3.0f);
+
+      cluster_centroid[c] += ctr;
+      cluster_normal[c] += n;
+      cluster_area += area;
+    }
+
+    mesh_centroid += cluster_centroid[c];
+    mesh_area += cluster_area;
+
+    if (cluster_area > 0.0f)
+      cluster_centroid[c] = cluster_centroid[c] / cluster_area;
+  }
+
+  if (mesh_area > 0.0f)
+    mesh_centroid = mesh_centroid / mesh_area;
+
+  vector<float>    sort_key(cluster_count);
+  vector<uint32_t> cluster_order(cluster_count);
+
+  for (size_t c = 0; c < cluster_count; ++c) {
+    sort_key[c] = dot(cluster_centroid[c] - mesh_centroid,
+                      normalize(cluster_normal[c]));
+    cluster_order[c] = static_cast<uint32_t>(c);
+  }
+
+  std::stable_sort(begin(cluster_order), end(cluster_order),
+                   [&sort_key](const uint32_t a, const uint32_t b) {
+                     return sort_key[a] > sort_key[b];
+                   });
+
+  vector<uint32_t> output;
+  output.reserve(static_cast<size_t>(indices.size()));
+
+  for (const auto c : cluster_order) {
+    output.insert(end(output), indices.begin() + clusters[c] * 3,
+                  indices.begin() + clusters[c + 1] * 3);
+  }
+
+  std::copy(begin(output), end(output), indices.begin());
+}
+
+void xray::rendering::optimize_vertex_fetch(gsl::span<uint32_t> indices,
+                                            vertex_pntt*        vertices,
+                                            const size_t        vertex_count,
+                                            const uint32_t      base_vertex) {
+  constexpr auto   UNMAPPED = numeric_limits<uint32_t>::max();
+  vector<uint32_t> remap(vertex_count, UNMAPPED);
+  uint32_t         next_vertex{};
+
+  for (auto& idx : indices) {
+    auto& new_idx = remap[idx - base_vertex];
+    if (new_idx == UNMAPPED)
+      new_idx = next_vertex++;
+
+    idx = new_idx + base_vertex;
+  }
+
+  for (auto& new_idx : remap) {
+    if (new_idx == UNMAPPED)
+      new_idx = next_vertex++;
+  }
+
+  vector<vertex_pntt> reordered(vertex_count);
+  for (size_t v = 0; v < vertex_count; ++v) {
+    reordered[remap[v]] = vertices[v];
+  }
+
+  std::copy(begin(reordered), end(reordered), vertices);
+}
+
+void xray::rendering::optimize_geometry(geometry_data_t* mesh,
+                                        const float      overdraw_threshold) {
+  assert(mesh != nullptr);
+  assert((mesh->index_count % 3) == 0);
+
+  vector<geometry_submesh> ranges{mesh->submeshes};
+
+  if (ranges.empty()) {
+    geometry_submesh whole;
+    whole.vertex_count = static_cast<uint32_t>(mesh->vertex_count);
+    whole.index_count  = static_cast<uint32_t>(mesh->index_count);
+    ranges.push_back(whole);
+  }
+
+  tbb::parallel_for(size_t{0}, ranges.size(), [&ranges, mesh,
+                                                overdraw_threshold](
+                                                   const size_t r) {
+    const auto& sm = ranges[r];
+    assert((sm.index_count % 3) == 0);
+
+    const auto vertices = raw_ptr(mesh->geometry) + sm.base_vertex;
+    const auto indices  =
+        gsl::span<uint32_t>{raw_ptr(mesh->indices) + sm.index_offset,
+                            static_cast<ptrdiff_t>(sm.index_count)};
+
+    optimize_vertex_cache(indices, sm.vertex_count, sm.base_vertex);
+    optimize_overdraw(indices, vertices, sm.vertex_count, sm.base_vertex,
+                      overdraw_threshold);
+    optimize_vertex_fetch(indices, vertices, sm.vertex_count, sm.base_vertex);
+  });
+}
@@ -0,0 +1,425 @@
+#include "xray/rendering/geometry/geometry_simplify.hpp"
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/rendering/geometry/geometry_adjacency.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/geometry/geometry_optimize.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::math;
+using namespace xray::rendering;
+
+//
+//  Symmetric 4x4 matrix accumulating squared distances to a set of planes,
+//  each weighted by the area of the triangle it came from. Dividing by the
+//  total weight gives the mean squared distance.
+struct quadric {
+  float a2{}, b2{}, c2{}, ab{}, ac{}, bc{}, ad{}, bd{}, cd{}, d2{};
+  float w{};
+
+  static quadric from_plane(const float3& n, const float d,
+                            const float weight) noexcept {
+    quadric q;
+    q.a2 = n.x * n.x * weight;
+    q.b2 = n.y * n.y * weight;
+    q.c2 = n.z * n.z * weight;
+    q.ab = n.x * n.y * weight;
+    q.ac = n.x * n.z * weight;
+    q.bc = n.y * n.z * weight;
+    q.ad = n.x * d * weight;
+    q.bd = n.y * d * weight;
+    q.cd = n.z * d * weight;
+    q.d2 = d * d * weight;
+    q.w  = weight;
+    return q;
+  }
+
+  quadric& operator+=(const quadric& q) noexcept {
+    a2 += q.a2;
+    b2 += q.b2;
+    c2 += q.c2;
+    ab += q.ab;
+    ac += q.ac;
+    bc += q.bc;
+    ad += q.ad;
+    bd += q.bd;
+    cd += q.cd;
+    d2 += q.d2;
+    w += q.w;
+    return *this;
+  }
+
+  float squared_error(const float3& p) const noexcept {
+    const float e = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z +
+                    2.0f * (ab * p.x * p.y + ac * p.x * p.z + bc * p.y * p.z) +
+                    2.0f * (ad * p.x + bd * p.y + cd * p.z) + d2;
+
+    return w > 0.0f ? std::max(e / w, 0.0f) : 0.0f;
+  }
+};
+
+struct collapse_candidate {
+  float    cost;
+  uint32_t from;
+  uint32_t to;
+};
+
+static bool same_position(const float3& a, const float3& b) noexcept {
+  return memcmp(&a, &b, sizeof(float3)) == 0;
+}
+
+//
+//  Maps every vertex to the lowest numbered vertex with the same position
+//  and returns the number of vertices sharing each position.
+static void build_position_remap(const vertex_pntt*  vertices,
+                                 const size_t        vertex_count,
+                                 vector<uint32_t>*   remap,
+                                 vector<uint32_t>*   wedge_count) {
+  vector<uint32_t> order(vertex_count);
+  for (uint32_t v = 0; v < vertex_count; ++v)
+    order[v] = v;
+
+  std::sort(begin(order), end(order),
+            [vertices](const uint32_t a, const uint32_t b) {
+              const auto& pa = vertices[a].position;
+              const auto& pb = vertices[b].position;
+              const auto  c  = memcmp(&pa, &pb, sizeof(float3));
+              return c < 0 || (c == 0 && a < b);
+            });
+
+  remap->resize(vertex_count);
+  wedge_count->assign(vertex_count, 0);
+
+  for (size_t i = 0; i < vertex_count;) {
+    size_t j = i + 1;
+    while (j < vertex_count && same_position(vertices[order[i]].position,
+                                             vertices[order[j]].position))
+      ++j;
+
+    for (size_t k = i; k < j; ++k) {
+      (*remap)[order[k]]       = order[i];
+      (*wedge_count)[order[k]] = static_cast<uint32_t>(j - i);
+    }
+
+    i = j;
+  }
+}
+
+//
+//  Vertices that must not be collapsed : seam vertices (more than one
+//  vertex at the same position) and vertices on an open border (an edge
+//  with no opposite edge, compared by position).
+static vector<uint8_t> find_locked_vertices(const vector<uint32_t>& indices,
+                                            const vector<uint32_t>& remap,
+                                            const vector<uint32_t>& wedges) {
+  const auto       vertex_count = remap.size();
+  vector<uint8_t>  locked(vertex_count, 0);
+  vector<uint64_t> half_edges;
+  half_edges.reserve(indices.size());
+
+  const auto edge_key = [](const uint32_t a, const uint32_t b) {
+    return (uint64_t{a} << 32) | b;
+  };
+
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    for (uint32_t c = 0; c < 3; ++c) {
+      const auto a = remap[indices[t + c]];
+      const auto b = remap[indices[t + (c + 1) % 3]];
+      half_edges.push_back(edge_key(a, b));
+    }
+  }
+
+  std::sort(begin(half_edges), end(half_edges));
+
+  vector<uint8_t> border(vertex_count, 0);
+  for (const auto e : half_edges) {
+    const auto a = static_cast<uint32_t>(e >> 32);
+    const auto b = static_cast<uint32_t>(e & 0xFFFFFFFFu);
+
+    if (!std::binary_search(begin(half_edges), end(half_edges),
+                            edge_key(b, a))) {
+      border[a] = border[b] = 1;
+    }
+  }
+
+  for (size_t v = 0; v < vertex_count; ++v) {
+    locked[v] = wedges[v] > 1 || border[remap[v]];
+  }
+
+  return locked;
+}
+
+static float3 triangle_normal(const float3& p0, const float3& p1,
+                              const float3& p2) noexcept {
+  return cross(p1 - p0, p2 - p0);
+}
+
+//
+//  Rejects collapses of 'from' onto 'to' that would flip (or turn by more
+//  than about 75 degrees) any of the triangles around 'from' that survive.
+static bool collapse_flips(const vector<uint32_t>&      indices,
+                           const vertex_face_adjacency& adj,
+                           const vertex_pntt* vertices, const uint32_t from,
+                           const uint32_t to) noexcept {
+  const auto& p_to = vertices[to].position;
+
+  for (const auto f : adj.faces_of(from)) {
+    const uint32_t tri[] = {indices[f * 3 + 0], indices[f * 3 + 1],
+                            indices[f * 3 + 2]};
+
+    if (tri[0] == to || tri[1] == to || tri[2] == to)
+      continue;
+
+    float3 p[3];
+    float3 q[3];
+    for (uint32_t c = 0; c < 3; ++c) {
+      p[c] = vertices[tri[c]].position;
+      q[c] = tri[c] == from ? p_to : p[c];
+    }
+
+    const auto n0 = triangle_normal(p[0], p[1], p[2]);
+    const auto n1 = triangle_normal(q[0], q[1], q[2]);
+
+    if (dot(n0, n1) <= 0.25f * length(n0) * length(n1))
+      return true;
+  }
+
+  return false;
+}
+
+size_t xray::rendering::simplify(gsl::span<const uint32_t> input,
+                                 const vertex_pntt*        vertices,
+                                 const size_t              vertex_count,
+                                 const uint32_t            base_vertex,
+                                 const size_t   target_index_count,
+                                 const float    target_error,
+                                 uint32_t*      destination,
+                                 float*         result_error) {
+  assert((input.size() % 3) == 0);
+  assert(destination != nullptr);
+
+  vector<uint32_t> indices;
+  indices.reserve(static_cast<size_t>(input.size()));
+
+  for (const auto idx : input) {
+    assert(idx - base_vertex < vertex_count);
+    indices.push_back(idx - base_vertex);
+  }
+
+  vector<uint32_t> remap;
+  vector<uint32_t> wedges;
+  build_position_remap(vertices, vertex_count, &remap, &wedges);
+
+  const auto locked = find_locked_vertices(indices, remap, wedges);
+
+  //
+  //  Quadrics live on the position representative, so all the wedges of a
+  //  position see the same surface.
+  vector<quadric> quadrics(vertex_count);
+
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    const auto& p0 = vertices[indices[t + 0]].position;
+    const auto& p1 = vertices[indices[t + 1]].position;
+    const auto& p2 = vertices[indices[t + 2]].position;
+
+    const auto n    = triangle_normal(p0, p1, p2);
+    const auto area = length(n);
+    if (area <= 0.0f)
+      continue;
+
+    const auto unit_n = n / area;
+    const auto q      = quadric::from_plane(unit_n, -dot(unit_n, p0), area);
+
+    for (uint32_t c = 0; c < 3; ++c)
+      quadrics[remap[indices[t + c]]] += q;
+  }
+
+  const float max_cost = target_error < std::sqrt(numeric_limits<float>::max())
+                             ? target_error * target_error
+                             : numeric_limits<float>::max();
+
+  vector<uint32_t>           collapse(vertex_count);
+  vector<uint8_t>            pass_locked(vertex_count);
+  vector<collapse_candidate> candidates;
+  vertex_face_adjacency      adj;
+  float                      max_error{};
+
+  while (indices.size() > target_index_count) {
+    //
+    //  Cost of moving each endpoint of each edge onto the other one.
+    candidates.clear();
+
+    for (size_t t = 0; t < indices.size(); t += 3) {
+      for (uint32_t c = 0; c < 3; ++c) {
+        const auto a = indices[t + c];
+        const auto b = indices[t + (c + 1) % 3];
+
+        if (!locked[a])
+          candidates.push_back(
+              {quadrics[remap[a]].squared_error(vertices[b].position), a, b});
+
+        if (!locked[b])
+          candidates.push_back(
+              {quadrics[remap[b]].squared_error(vertices[a].position), b, a});
+      }
+    }
+
+    if (candidates.empty())
+      break;
+
+    std::sort(begin(candidates), end(candidates),
+              [](const collapse_candidate& x, const collapse_candidate& y) {
+                return x.cost < y.cost ||
+                       (x.cost == y.cost &&
+                        (x.from < y.from ||
+                         (x.from == y.from && x.to < y.to)));
+              });
+
+    build_vertex_face_adjacency(
+        gsl::span<const uint32_t>{indices.data(),
+                                  static_cast<ptrdiff_t>(indices.size())},
+        vertex_count, 0, &adj);
+
+    for (uint32_t v = 0; v < vertex_count; ++v)
+      collapse[v] = v;
+
+    std::fill(begin(pass_locked), end(pass_locked), uint8_t{0});
+
+    //
+    //  Collapse the cheapest edges first. A collapse locks every vertex of
+    //  the triangles around it for the rest of the pass, so the flip test
+    //  of later collapses only sees positions that will not change.
+    size_t   triangles_left = indices.size() / 3;
+    uint32_t collapses{};
+
+    for (const auto& cand : candidates) {
+      if (cand.cost > max_cost || triangles_left * 3 <= target_index_count)
+        break;
+
+      if (pass_locked[cand.from] || pass_locked[cand.to])
+        continue;
+
+      if (collapse_flips(indices, adj, vertices, cand.from, cand.to))
+        continue;
+
+      collapse[cand.from] = cand.to;
+      quadrics[remap[cand.to]] += quadrics[remap[cand.from]];
+      max_error = std::max(max_error, cand.cost);
+      ++collapses;
+
+      for (const auto f : adj.faces_of(cand.from)) {
+        bool degenerates = false;
+
+        for (uint32_t c = 0; c < 3; ++c) {
+          const auto v   = indices[f * 3 + c];
+          pass_locked[v] = 1;
+          degenerates    = degenerates || v == cand.to;
+        }
+
+        triangles_left -= degenerates ? 1 : 0;
+      }
+    }
+
+    if (collapses == 0)
+      break;
+
+    //
+    //  Apply the collapses and drop the triangles that degenerated.
+    size_t out = 0;
+    for (size_t t = 0; t < indices.size(); t += 3) {
+      const auto a = collapse[indices[t + 0]];
+      const auto b = collapse[indices[t + 1]];
+      const auto c = collapse[indices[t + 2]];
+
+      if (a == b || b == c || a == c)
+        continue;
+
+      indices[out++] = a;
+      indices[out++] = b;
+      indices[out++] = c;
+    }
+
+    indices.resize(out);
+  }
+
+  for (size_t i = 0; i < indices.size(); ++i)
+    destination[i] = indices[i] + base_vertex;
+
+  if (result_error)
+    *result_error = std::sqrt(max_error);
+
+  return indices.size();
+}
+
+void xray::rendering::generate_lods(geometry_data_t*       mesh,
+                                    gsl::span<const float> triangle_ratios,
+                                    const float            target_error) {
+  assert(mesh != nullptr);
+
+  const auto base_index_count =
+      mesh->lods.empty() ? mesh->index_count : mesh->lods[0].index_count;
+  assert((base_index_count % 3) == 0);
+
+  const auto base_indices = gsl::span<const uint32_t>{
+      raw_ptr(mesh->indices), static_cast<ptrdiff_t>(base_index_count)};
+
+  const auto            level_count = static_cast<size_t>(triangle_ratios.size());
+  vector<vector<uint32_t>> levels(level_count);
+  vector<float>            errors(level_count);
+
+  tbb::parallel_for(size_t{0}, level_count, [&](const size_t lvl) {
+    const auto ratio = std::min(std::max(triangle_ratios[lvl], 0.0f), 1.0f);
+    const auto target =
+        static_cast<size_t>(static_cast<float>(base_index_count / 3) * ratio) *
+        3;
+
+    auto& level = levels[lvl];
+    level.resize(base_index_count);
+    level.resize(simplify(base_indices, raw_ptr(mesh->geometry),
+                          mesh->vertex_count, 0, target, target_error,
+                          level.data(), &errors[lvl]));
+
+    optimize_vertex_cache(
+        gsl::span<uint32_t>{level.data(), static_cast<ptrdiff_t>(level.size())},
+        mesh->vertex_count);
+  });
+
+  size_t total_indices = base_index_count;
+  for (const auto& level : levels)
+    total_indices += level.size();
+
+  geometry_data_t::scoped_vector_array_t<uint32_t> indices{
+      new uint32_t[total_indices]};
+
+  std::copy(base_indices.begin(), base_indices.end(), raw_ptr(indices));
+
+  mesh->lods.clear();
+  geometry_lod lod0;
+  lod0.index_count = static_cast<uint32_t>(base_index_count);
+  mesh->lods.push_back(lod0);
+
+  size_t offset = base_index_count;
+  for (size_t lvl = 0; lvl < level_count; ++lvl) {
+    std::copy(begin(levels[lvl]), end(levels[lvl]), raw_ptr(indices) + offset);
+
+    geometry_lod lod;
+    lod.index_offset = static_cast<uint32_t>(offset);
+    lod.index_count  = static_cast<uint32_t>(levels[lvl].size());
+    lod.error        = errors[lvl];
+    mesh->lods.push_back(lod);
+
+    offset += levels[lvl].size();
+  }
+
+  mesh->indices     = std::move(indices);
+  mesh->index_count = total_indices;
+}
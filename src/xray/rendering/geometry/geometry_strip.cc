@@ -0,0 +1,145 @@
+#include "xray/rendering/geometry/geometry_strip.hpp"
+#include "xray/rendering/geometry/geometry_adjacency.hpp"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+using namespace xray::rendering;
+
+static constexpr uint32_t NO_TRIANGLE = 0xFFFFFFFFu;
+
+//
+//  Returns the position (0 - 2) of the directed edge (a, b) in triangle
+//  tri, or 3 when the triangle does not contain it.
+static uint32_t find_directed_edge(const uint32_t* tri, const uint32_t a,
+                                   const uint32_t b) noexcept {
+  for (uint32_t c = 0; c < 3; ++c) {
+    if (tri[c] == a && tri[(c + 1) % 3] == b)
+      return c;
+  }
+
+  return 3;
+}
+
+size_t xray::rendering::stripify(gsl::span<const uint32_t> indices,
+                                 const size_t              vertex_count,
+                                 const uint32_t            base_vertex,
+                                 const uint32_t            restart_index,
+                                 std::vector<uint32_t>*    strip) {
+  assert((indices.size() % 3) == 0);
+  assert(strip != nullptr);
+
+  strip->clear();
+
+  const auto tri_count = static_cast<uint32_t>(indices.size() / 3);
+  const auto tris      = indices.data();
+
+  vertex_face_adjacency adj;
+  build_vertex_face_adjacency(indices, vertex_count, base_vertex, &adj);
+
+  vector<uint8_t> emitted(tri_count, 0);
+
+  //
+  //  The not yet emitted triangle containing the directed edge (a, b),
+  //  and the position of the edge in it.
+  const auto triangle_with_edge = [&](const uint32_t a, const uint32_t b,
+                                      uint32_t* edge) {
+    for (const auto f : adj.faces_of(a - base_vertex)) {
+      if (emitted[f])
+        continue;
+
+      *edge = find_directed_edge(tris + f * 3, a, b);
+      if (*edge < 3)
+        return f;
+    }
+
+    return NO_TRIANGLE;
+  };
+
+  for (uint32_t first = 0; first < tri_count; ++first) {
+    if (emitted[first])
+      continue;
+
+    //
+    //  Start the strip on the rotation of the triangle whose last edge
+    //  (reversed, as the second triangle of a strip is odd) continues it.
+    const auto t     = tris + first * 3;
+    uint32_t   start = 0;
+    emitted[first]   = 1;
+
+    for (uint32_t r = 0; r < 3; ++r) {
+      uint32_t edge;
+      if (triangle_with_edge(t[(r + 2) % 3], t[(r + 1) % 3], &edge) !=
+          NO_TRIANGLE) {
+        start = r;
+        break;
+      }
+    }
+
+    if (!strip->empty())
+      strip->push_back(restart_index);
+
+    const auto strip_begin = strip->size();
+    strip->push_back(t[start]);
+    strip->push_back(t[(start + 1) % 3]);
+    strip->push_back(t[(start + 2) % 3]);
+
+    for (size_t k = 1;; ++k) {
+      //
+      //  Triangle k is (s[k], s[k + 1], z) when k is even and
+      //  (s[k + 1], s[k], z) when k is odd.
+      const auto s0 = (*strip)[strip_begin + k];
+      const auto s1 = (*strip)[strip_begin + k + 1];
+      const auto a  = (k & 1) ? s1 : s0;
+      const auto b  = (k & 1) ? s0 : s1;
+
+      uint32_t   edge;
+      const auto next = triangle_with_edge(a, b, &edge);
+      if (next == NO_TRIANGLE)
+        break;
+
+      emitted[next] = 1;
+      strip->push_back(tris[next * 3 + (edge + 2) % 3]);
+    }
+  }
+
+  return strip->size();
+}
+
+size_t xray::rendering::unstripify(gsl::span<const uint32_t> strip,
+                                   const uint32_t            restart_index,
+                                   std::vector<uint32_t>*    indices) {
+  assert(indices != nullptr);
+  indices->clear();
+
+  ptrdiff_t strip_begin = 0;
+  for (ptrdiff_t i = 0; i < strip.size(); ++i) {
+    if (strip[i] == restart_index) {
+      strip_begin = i + 1;
+      continue;
+    }
+
+    const auto k = i - strip_begin - 2;
+    if (k < 0)
+      continue;
+
+    const auto a = strip[i - 2];
+    const auto b = strip[i - 1];
+    const auto c = strip[i];
+
+    if (a == b || b == c || a == c)
+      continue;
+
+    if (k & 1) {
+      indices->push_back(b);
+      indices->push_back(a);
+    } else {
+      indices->push_back(a);
+      indices->push_back(b);
+    }
+
+    indices->push_back(c);
+  }
+
+  return indices->size();
+}
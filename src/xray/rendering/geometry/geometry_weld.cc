@@ -0,0 +1,263 @@
+#include "xray/rendering/geometry/geometry_weld.hpp"
+//
+//  unique_pointer.hpp uses std::pointer_traits without including <memory>.
+#include <memory>
+#include "xray/base/unique_pointer.hpp"
+#include "xray/math/scalar2.hpp"
+#include "xray/math/scalar3.hpp"
+#include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <vector>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::math;
+using namespace xray::rendering;
+
+static constexpr size_t WELD_GRAIN_SIZE = 4096;
+
+struct weld_cell_entry {
+  uint64_t hash;
+  uint32_t vertex;
+};
+
+struct weld_cell {
+  int64_t x;
+  int64_t y;
+  int64_t z;
+};
+
+static uint64_t weld_cell_hash(const int64_t x, const int64_t y,
+                               const int64_t z) noexcept {
+  //
+  //  splitmix64 finalizer over the combined coordinates.
+  uint64_t h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull ^
+               static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full ^
+               static_cast<uint64_t>(z) * 0x165667B19E3779F9ull;
+
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+  return h ^ (h >> 31);
+}
+
+static bool within(const float a, const float b, const float eps) noexcept {
+  return std::abs(a - b) <= eps;
+}
+
+static bool within(const float3& a, const float3& b, const float eps) noexcept {
+  return within(a.x, b.x, eps) && within(a.y, b.y, eps) &&
+         within(a.z, b.z, eps);
+}
+
+static bool vertices_match(const vertex_pntt& a, const vertex_pntt& b,
+                           const weld_options& opts) noexcept {
+  return within(a.position, b.position, opts.position_epsilon) &&
+         (!(opts.attributes & weld_attribute::normal) ||
+          within(a.normal, b.normal, opts.normal_epsilon)) &&
+         (!(opts.attributes & weld_attribute::texcoord) ||
+          (within(a.texcoords.x, b.texcoords.x, opts.texcoord_epsilon) &&
+           within(a.texcoords.y, b.texcoords.y, opts.texcoord_epsilon))) &&
+         (!(opts.attributes & weld_attribute::tangent) ||
+          within(a.tangent, b.tangent, opts.tangent_epsilon));
+}
+
+//
+//  Welds count vertices. On return remap maps each vertex to its index in
+//  the welded array and sources holds the vertex each welded vertex is
+//  copied from.
+static void weld_range(const vertex_pntt* vertices, const uint32_t count,
+                       const weld_options& opts, vector<uint32_t>* remap,
+                       vector<uint32_t>* sources) {
+  const float cell_size =
+      opts.position_epsilon > 0.0f ? 4.0f * opts.position_epsilon : 1.0e-4f;
+  const float inv_cell = 1.0f / cell_size;
+
+  const auto cell_of = [inv_cell](const float3& p) {
+    return weld_cell{static_cast<int64_t>(std::floor(p.x * inv_cell)),
+                     static_cast<int64_t>(std::floor(p.y * inv_cell)),
+                     static_cast<int64_t>(std::floor(p.z * inv_cell))};
+  };
+
+  //
+  //  Bucket the vertices : sorting by (hash, vertex) puts each cell's
+  //  vertices next to each other, lowest index first.
+  vector<weld_cell_entry> entries(count);
+
+  tbb::parallel_for(tbb::blocked_range<uint32_t>{0, count, WELD_GRAIN_SIZE},
+                    [&](const tbb::blocked_range<uint32_t>& r) {
+                      for (uint32_t v = r.begin(); v < r.end(); ++v) {
+                        const auto c = cell_of(vertices[v].position);
+                        entries[v]   = {weld_cell_hash(c.x, c.y, c.z), v};
+                      }
+                    });
+
+  tbb::parallel_sort(entries.begin(), entries.end(),
+                     [](const weld_cell_entry& a, const weld_cell_entry& b) {
+                       return a.hash < b.hash ||
+                              (a.hash == b.hash && a.vertex < b.vertex);
+                     });
+
+  //
+  //  Directory over the top bits of the hash, so that finding a cell is a
+  //  table lookup plus a short scan rather than a binary search over all
+  //  the entries.
+  uint32_t dir_bits{1};
+  while ((size_t{1} << dir_bits) < count)
+    ++dir_bits;
+
+  const auto       dir_shift = 64 - dir_bits;
+  vector<uint32_t> directory((size_t{1} << dir_bits) + 1);
+
+  {
+    size_t e = 0;
+    for (size_t b = 0; b < directory.size(); ++b) {
+      while (e < count && (entries[e].hash >> dir_shift) < b)
+        ++e;
+      directory[b] = static_cast<uint32_t>(e);
+    }
+  }
+
+  //
+  //  Each vertex finds the lowest numbered vertex it matches, searching its
+  //  own cell and the neighbours it is within epsilon of.
+  vector<uint32_t> rep(count);
+
+  tbb::parallel_for(
+      tbb::blocked_range<uint32_t>{0, count, WELD_GRAIN_SIZE},
+      [&](const tbb::blocked_range<uint32_t>& r) {
+        for (uint32_t v = r.begin(); v < r.end(); ++v) {
+          const auto& p   = vertices[v].position;
+          const auto  c   = cell_of(p);
+          const auto  eps = opts.position_epsilon;
+
+          const auto range_lo = [cell_size, eps](const float x,
+                                                 const int64_t cx) {
+            return x - eps < static_cast<float>(cx) * cell_size ? -1 : 0;
+          };
+          const auto range_hi = [cell_size, eps](const float x,
+                                                 const int64_t cx) {
+            return x + eps >= static_cast<float>(cx + 1) * cell_size ? 1 : 0;
+          };
+
+          uint32_t best = v;
+
+          for (int dx = range_lo(p.x, c.x); dx <= range_hi(p.x, c.x); ++dx) {
+            for (int dy = range_lo(p.y, c.y); dy <= range_hi(p.y, c.y); ++dy) {
+              for (int dz = range_lo(p.z, c.z); dz <= range_hi(p.z, c.z);
+                   ++dz) {
+                const auto h = weld_cell_hash(c.x + dx, c.y + dy, c.z + dz);
+
+                const auto bucket = h >> dir_shift;
+                auto       e      = directory[bucket];
+                const auto last   = directory[bucket + 1];
+
+                while (e < last && entries[e].hash < h)
+                  ++e;
+
+                for (; e < last && entries[e].hash == h &&
+                       entries[e].vertex < best;
+                     ++e) {
+                  if (vertices_match(vertices[entries[e].vertex], vertices[v],
+                                     opts)) {
+                    best = entries[e].vertex;
+                    break;
+                  }
+                }
+              }
+            }
+          }
+
+          rep[v] = best;
+        }
+      });
+
+  //
+  //  rep[v] <= v, so walking in order resolves chains (v matches u which
+  //  matches w) to the first vertex of the chain.
+  remap->resize(count);
+  sources->clear();
+
+  for (uint32_t v = 0; v < count; ++v) {
+    if (rep[v] == v) {
+      (*remap)[v] = static_cast<uint32_t>(sources->size());
+      sources->push_back(v);
+    } else {
+      (*remap)[v] = (*remap)[rep[v]];
+    }
+  }
+}
+
+size_t xray::rendering::weld_vertices(geometry_data_t*    mesh,
+                                      const weld_options& opts) {
+  assert(mesh != nullptr);
+
+  vector<geometry_submesh*> ranges;
+  geometry_submesh          whole;
+
+  if (mesh->submeshes.empty()) {
+    whole.vertex_count = static_cast<uint32_t>(mesh->vertex_count);
+    whole.index_count  = static_cast<uint32_t>(mesh->index_count);
+    ranges.push_back(&whole);
+  } else {
+    for (auto& sm : mesh->submeshes)
+      ranges.push_back(&sm);
+  }
+
+  vector<vector<uint32_t>> remaps(ranges.size());
+  vector<vector<uint32_t>> sources(ranges.size());
+  size_t                   welded_count{};
+
+  for (size_t r = 0; r < ranges.size(); ++r) {
+    const auto sm = ranges[r];
+    assert(sm->base_vertex + sm->vertex_count <= mesh->vertex_count);
+
+    weld_range(raw_ptr(mesh->geometry) + sm->base_vertex, sm->vertex_count,
+               opts, &remaps[r], &sources[r]);
+    welded_count += sources[r].size();
+  }
+
+  if (welded_count == mesh->vertex_count)
+    return welded_count;
+
+  geometry_data_t::scoped_vector_array_t<vertex_pntt> welded{
+      new vertex_pntt[welded_count]};
+
+  uint32_t new_base{};
+
+  for (size_t r = 0; r < ranges.size(); ++r) {
+    const auto  sm       = ranges[r];
+    const auto  old_base = sm->base_vertex;
+    const auto& remap    = remaps[r];
+    const auto& src      = sources[r];
+
+    for (size_t i = 0; i < src.size(); ++i)
+      welded[new_base + i] = mesh->geometry[old_base + src[i]];
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>{sm->index_offset,
+                                   sm->index_offset + sm->index_count,
+                                   WELD_GRAIN_SIZE},
+        [&remap, old_base, new_base,
+         mesh](const tbb::blocked_range<size_t>& rng) {
+          for (size_t i = rng.begin(); i < rng.end(); ++i) {
+            assert(mesh->indices[i] - old_base < remap.size());
+            mesh->indices[i] = new_base + remap[mesh->indices[i] - old_base];
+          }
+        });
+
+    sm->base_vertex  = new_base;
+    sm->vertex_count = static_cast<uint32_t>(src.size());
+    new_base += sm->vertex_count;
+  }
+
+  mesh->geometry     = std::move(welded);
+  mesh->vertex_count = welded_count;
+
+  return welded_count;
+}
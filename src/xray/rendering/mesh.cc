@@ -11,18 +11,28 @@
 #include "xray/math/scalar3.hpp"
 #include "xray/math/scalar3_math.hpp"
 #include "xray/math/scalar3_math.hpp"
+#include "xray/rendering/geometry/geometry_bounds.hpp"
 #include "xray/rendering/geometry/geometry_data.hpp"
+#include "xray/rendering/geometry/geometry_strip.hpp"
+#include "xray/rendering/mesh_cache.hpp"
+#include "xray/rendering/mesh_import_profile.hpp"
 #include "xray/rendering/opengl/scoped_state.hpp"
 #include "xray/rendering/vertex_format/vertex_pn.hpp"
 #include "xray/rendering/vertex_format/vertex_pnt.hpp"
+#include "xray/rendering/vertex_format/vertex_packing.hpp"
+#include "xray/rendering/vertex_format/vertex_pnt_packed.hpp"
 #include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt_packed.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/cimport.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <limits>
+#include <numeric>
 #include <platformstl/filesystem/memory_mapped_file.hpp>
 #include <span.h>
 #include <tbb/tbb.h>
@@ -33,10 +43,6 @@ using namespace xray::base;
 using namespace xray::math;
 using namespace xray::rendering;
 
-struct malloc_deleter {
-  void operator()(void* ptr) const noexcept { free(ptr); }
-};
-
 struct vertex_load_option {
   enum { load_normals = 1u, load_texcoord = 1u << 1, load_tangents = 1u << 2 };
 };
@@ -98,6 +104,14 @@ auto get_vertex_format_description(const xray::rendering::vertex_format fmt) {
     return describe_vertex_format<vertex_format::pntt>();
     break;
 
+  case vertex_format::pnt_packed:
+    return describe_vertex_format<vertex_format::pnt_packed>();
+    break;
+
+  case vertex_format::pntt_packed:
+    return describe_vertex_format<vertex_format::pntt_packed>();
+    break;
+
   default:
     assert(false && "Unsupported vertex format!");
     break;
@@ -106,197 +120,316 @@ auto get_vertex_format_description(const xray::rendering::vertex_format fmt) {
   return vertex_format_info{};
 }
 
-template <typename In, typename Out>
-struct loader_func {
-  static Out load(const In* input, const uint32_t idx) noexcept {
-    return vector_cast<Out>(input[idx]);
-  }
-
-  static Out load_null(const In*, const uint32_t) noexcept {
-    return Out::stdc::zero;
-  }
-};
-
-template <typename InputVertexType, typename OutputVertexType>
-static void mesh_load_vertex_data(const InputVertexType* input_vertices,
-                                  const uint32_t         num_input_vertices,
-                                  const uint32_t         output_stride,
-                                  const uint32_t         output_base_vertex,
-                                  OutputVertexType*      output_vertices) {
-  using loader_func_type = loader_func<InputVertexType, OutputVertexType>;
-  auto load_fn =
-      input_vertices ? &loader_func_type::load : &loader_func_type::load_null;
-
-  for (uint32_t idx = 0; idx < num_input_vertices; ++idx) {
-    auto out_vert = reinterpret_cast<OutputVertexType*>(
-        reinterpret_cast<uint8_t*>(output_vertices) +
-        (idx + output_base_vertex) * output_stride);
-
-    *out_vert = load_fn(input_vertices, idx);
-  }
+template <typename OutputVectorType>
+inline OutputVectorType ai_attribute(const aiVector3D* attributes,
+                                     const uint32_t    idx) noexcept {
+  return attributes ? vector_cast<OutputVectorType>(attributes[idx])
+                    : OutputVectorType::stdc::zero;
 }
 
-static void mesh_load_pos(float3* where, const uint32_t stride,
-                          const aiMesh* mesh, const uint32_t base_vertex) {
-  mesh_load_vertex_data(mesh->mVertices, mesh->mNumVertices, stride,
-                        base_vertex, where);
+static void mesh_load_vertex(const aiMesh* mesh, const uint32_t idx,
+                             vertex_pn* dst) noexcept {
+  dst->position = ai_attribute<float3>(mesh->mVertices, idx);
+  dst->normal   = ai_attribute<float3>(mesh->mNormals, idx);
 }
 
-static void mesh_load_normal(float3* where, const uint32_t stride,
-                             const aiMesh* mesh, const uint32_t base_vertex) {
-  mesh_load_vertex_data(mesh->mNormals, mesh->mNumVertices, stride, base_vertex,
-                        where);
+static void mesh_load_vertex(const aiMesh* mesh, const uint32_t idx,
+                             vertex_pnt* dst) noexcept {
+  dst->position = ai_attribute<float3>(mesh->mVertices, idx);
+  dst->normal   = ai_attribute<float3>(mesh->mNormals, idx);
+  dst->texcoord = ai_attribute<float2>(mesh->mTextureCoords[0], idx);
 }
 
-static void mesh_load_texcoord(float2* where, const uint32_t stride,
-                               const aiMesh* mesh, const uint32_t base_vertex) {
-  mesh_load_vertex_data(mesh->mTextureCoords[0], mesh->mNumVertices, stride,
-                        base_vertex, where);
+static void mesh_load_vertex(const aiMesh* mesh, const uint32_t idx,
+                             vertex_pntt* dst) noexcept {
+  dst->position  = ai_attribute<float3>(mesh->mVertices, idx);
+  dst->normal    = ai_attribute<float3>(mesh->mNormals, idx);
+  dst->texcoords = ai_attribute<float2>(mesh->mTextureCoords[0], idx);
+  dst->tangent   = ai_attribute<float3>(mesh->mTangents, idx);
 }
 
-static void mesh_load_tangent(float3* where, const uint32_t stride,
-                              const aiMesh* mesh, const uint32_t base_vertex) {
-  mesh_load_vertex_data(mesh->mTangents, mesh->mNumVertices, stride,
-                        base_vertex, where);
+///
+/// Vertices converted per task, large meshes are split so that a model made
+/// of a single mesh is converted in parallel too.
+static constexpr uint32_t VERTEX_CONVERSION_GRAIN = 4096;
+
+template <typename VertexType>
+static void mesh_load_vertices(const aiMesh* mesh, VertexType* dst) {
+  tbb::parallel_for(
+      tbb::blocked_range<uint32_t>{0u, mesh->mNumVertices,
+                                   VERTEX_CONVERSION_GRAIN},
+      [mesh, dst](const tbb::blocked_range<uint32_t>& range) {
+        for (uint32_t idx = range.begin(); idx < range.end(); ++idx)
+          mesh_load_vertex(mesh, idx, dst + idx);
+      });
 }
 
-static void mesh_load_vertex_pn(void* output, const aiMesh* mesh,
-                                const uint32_t base_vertex) {
-  auto           dst    = static_cast<vertex_pn*>(output);
-  constexpr auto stride = static_cast<uint32_t>(sizeof(vertex_pn));
-  mesh_load_pos(&dst->position, stride, mesh, base_vertex);
-  mesh_load_normal(&dst->normal, stride, mesh, base_vertex);
+static void mesh_load_indices(const aiMesh* mesh, const uint32_t base_vertex,
+                              uint32_t* dst) noexcept {
+  for (uint32_t face_index = 0; face_index < mesh->mNumFaces; ++face_index) {
+    const aiFace& face = mesh->mFaces[face_index];
+    for (uint32_t i = 0; i < face.mNumIndices; ++i)
+      *dst++ = face.mIndices[i] + base_vertex;
+  }
 }
 
-static void mesh_load_vertex_pnt(void* where, const aiMesh* mesh,
-                                 const uint32_t base_vertex) {
-  auto           dst    = static_cast<vertex_pnt*>(where);
-  constexpr auto stride = static_cast<uint32_t>(sizeof(vertex_pnt));
+///
+/// Placement of one imported mesh in the vertex and index buffers.
+struct ai_mesh_layout {
+  uint32_t base_vertex{0};
+  uint32_t index_offset{0};
+  uint32_t index_count{0};
+};
 
-  mesh_load_pos(&dst->position, stride, mesh, base_vertex);
-  mesh_load_normal(&dst->normal, stride, mesh, base_vertex);
-  mesh_load_texcoord(&dst->texcoord, stride, mesh, base_vertex);
-}
+///
+/// Counts the indices of every mesh (in parallel) and turns the counts into
+/// offsets with a prefix sum. Meshes without vertices get empty ranges.
+static void layout_ai_meshes(const aiScene*          scene,
+                             vector<ai_mesh_layout>* layout,
+                             size_t* num_vertices, size_t* num_indices) {
+  layout->assign(scene->mNumMeshes, ai_mesh_layout{});
 
-void mesh_load_vertex_pntt(void* where, const aiMesh* mesh,
-                           const uint32_t base_vertex) {
-  auto           dst    = static_cast<vertex_pntt*>(where);
-  constexpr auto stride = static_cast<uint32_t>(sizeof(vertex_pntt));
+  tbb::parallel_for(uint32_t{0}, scene->mNumMeshes,
+                    [scene, layout](const uint32_t mesh_index) {
+                      const aiMesh* mesh = scene->mMeshes[mesh_index];
+                      if (!mesh->mVertices)
+                        return;
 
-  mesh_load_pos(&dst->position, stride, mesh, base_vertex);
-  mesh_load_normal(&dst->normal, stride, mesh, base_vertex);
-  mesh_load_texcoord(&dst->texcoords, stride, mesh, base_vertex);
-  mesh_load_tangent(&dst->tangent, stride, mesh, base_vertex);
-}
+                      uint32_t index_count{};
+                      for (uint32_t f = 0; f < mesh->mNumFaces; ++f)
+                        index_count += mesh->mFaces[f].mNumIndices;
+
+                      (*layout)[mesh_index].index_count = index_count;
+                    });
+
+  uint32_t base_vertex{};
+  uint32_t index_offset{};
+
+  for (uint32_t mesh_index = 0; mesh_index < scene->mNumMeshes; ++mesh_index) {
+    auto& mesh_layout        = (*layout)[mesh_index];
+    mesh_layout.base_vertex  = base_vertex;
+    mesh_layout.index_offset = index_offset;
 
-template <typename IndexType>
-void mesh_load_face_indices(void* output, const uint32_t output_offset,
-                            const uint32_t input_offset, const aiFace* face) {
-  auto dst = static_cast<IndexType*>(output) + output_offset;
-  for (uint32_t i = 0; i < face->mNumIndices; ++i) {
-    dst[i] = static_cast<IndexType>(face->mIndices[i] + input_offset);
+    if (scene->mMeshes[mesh_index]->mVertices)
+      base_vertex += scene->mMeshes[mesh_index]->mNumVertices;
+    index_offset += mesh_layout.index_count;
   }
-}
 
-bool xray::rendering::simple_mesh::load_model_impl(
-    const char* model_data, const size_t data_size,
-    const uint32_t mesh_process_opts, const uint32_t mesh_import_opts) {
+  *num_vertices = base_vertex;
+  *num_indices  = index_offset;
+}
 
-  struct ai_propstore_deleter {
-    void operator()(aiPropertyStore* prop_store) const noexcept {
-      if (prop_store)
-        aiReleasePropertyStore(prop_store);
-    }
-  };
+static void pack_geometry(const vertex_format                fmt,
+                          gsl::span<const vertex_pntt> vertices,
+                          const vertex_quantization&   quantization,
+                          void*                        dest) {
+  switch (fmt) {
+  case vertex_format::pnt_packed:
+    pack_vertices(vertices, quantization,
+                  static_cast<vertex_pnt_packed*>(dest));
+    break;
 
-  unique_pointer<aiPropertyStore, ai_propstore_deleter> import_props{
-      aiCreatePropertyStore()};
+  case vertex_format::pntt_packed:
+    pack_vertices(vertices, quantization,
+                  static_cast<vertex_pntt_packed*>(dest));
+    break;
 
-  if (!import_props) {
-    XR_LOG_ERR("Failed to create Assimp property store object!");
-    return false;
+  default:
+    assert(false && "Not a packed vertex format!");
+    break;
   }
+}
 
-  {
-    aiSetImportPropertyInteger(raw_ptr(import_props),
-                               AI_CONFIG_IMPORT_TER_MAKE_UVS, 1);
+//
+//  Picks the index type, builds strips when asked for (and shorter than the
+//  list) and fills the final contents of the index buffer.
+static void build_index_buffer(gsl::span<const uint32_t> indices,
+                               const size_t              vertex_count,
+                               const bool                try_strips,
+                               vector<geometry_submesh>* submeshes,
+                               vector<uint8_t>*          buffer,
+                               mesh_cache_data*          contents) {
+  const auto list_index_count = static_cast<size_t>(indices.size());
+
+  //
+  //  16 bit indices whenever the vertices fit, the largest value of the
+  //  index type is reserved for primitive restart.
+  contents->index_fmt = vertex_count <= numeric_limits<uint16_t>::max()
+                            ? index_format::u16
+                            : index_format::u32;
+
+  const uint32_t restart_index = contents->index_fmt == index_format::u16
+                                     ? numeric_limits<uint16_t>::max()
+                                     : numeric_limits<uint32_t>::max();
+
+  //
+  //  Strips are built per submesh, so that submeshes keep their own
+  //  (contiguous) index range, and only kept when they are shorter than
+  //  the list.
+  vector<uint32_t>         strips;
+  vector<geometry_submesh> strip_submeshes{*submeshes};
+
+  const auto triangles_only =
+      (list_index_count % 3) == 0 &&
+      std::all_of(begin(*submeshes), end(*submeshes),
+                  [](const geometry_submesh& sm) {
+                    return (sm.index_count % 3) == 0;
+                  });
+
+  if (try_strips && triangles_only) {
+    vector<uint32_t> submesh_strip;
+
+    const auto stripify_range = [&](const uint32_t offset,
+                                    const uint32_t count,
+                                    const uint32_t base_vertex,
+                                    const size_t   range_vertices) {
+      stripify(indices.subspan(offset, count), range_vertices, base_vertex,
+               restart_index, &submesh_strip);
+      strips.insert(end(strips), begin(submesh_strip), end(submesh_strip));
+    };
 
-    if (mesh_import_opts & mesh_load_option::remove_points_lines) {
-      aiSetImportPropertyInteger(raw_ptr(import_props), AI_CONFIG_PP_SBP_REMOVE,
-                                 aiPrimitiveType_LINE | aiPrimitiveType_POINT);
+    if (strip_submeshes.empty()) {
+      stripify_range(0, static_cast<uint32_t>(indices.size()), 0,
+                     vertex_count);
+    } else {
+      for (auto& sm : strip_submeshes) {
+        const auto strip_offset = static_cast<uint32_t>(strips.size());
+        stripify_range(sm.index_offset, sm.index_count, sm.base_vertex,
+                       sm.vertex_count);
+        sm.index_offset = strip_offset;
+        sm.index_count  = static_cast<uint32_t>(strips.size()) - strip_offset;
+
+        //
+        //  Submeshes drawn back to back must not join into one strip.
+        if (&sm != &strip_submeshes.back())
+          strips.push_back(restart_index);
+      }
     }
   }
 
-  auto imported_scene = aiImportFileFromMemoryWithProperties(
-      model_data, data_size, mesh_process_opts, nullptr, raw_ptr(import_props));
+  contents->strips = !strips.empty() && strips.size() < list_index_count;
 
-  if (!imported_scene) {
-    XR_LOG_ERR("Assimp import error : failed to load scene from model file !");
-    return false;
+  if (contents->strips) {
+    indices    = gsl::span<const uint32_t>{strips.data(),
+                                        static_cast<ptrdiff_t>(strips.size())};
+    *submeshes = std::move(strip_submeshes);
   }
 
-  size_t num_vertices = 0;
-  size_t num_indices  = 0;
-  size_t num_faces    = 0;
+  const auto   buffer_index_count = static_cast<size_t>(indices.size());
+  const size_t index_bytes        = contents->index_fmt == index_format::u16
+                                 ? sizeof(uint16_t)
+                                 : sizeof(uint32_t);
 
-  //
-  //  Count vertices and indices.
-  for (uint32_t mesh_index = 0; mesh_index < imported_scene->mNumMeshes;
-       ++mesh_index) {
+  buffer->resize(buffer_index_count * index_bytes);
 
-    const aiMesh* curr_mesh = imported_scene->mMeshes[mesh_index];
-    num_vertices += curr_mesh->mNumVertices;
-    num_faces += curr_mesh->mNumFaces;
+  if (contents->index_fmt == index_format::u16) {
+    std::transform(
+        begin(indices), end(indices),
+        reinterpret_cast<uint16_t*>(buffer->data()),
+        [](const uint32_t idx) { return static_cast<uint16_t>(idx); });
+  } else if (!indices.empty()) {
+    memcpy(buffer->data(), indices.data(), buffer->size());
+  }
 
-    for (uint32_t face_index = 0; face_index < curr_mesh->mNumFaces;
-         ++face_index) {
-      const aiFace* curr_face = &curr_mesh->mFaces[face_index];
-      num_indices += curr_face->mNumIndices;
+  contents->indices          = buffer->data();
+  contents->index_count      = static_cast<uint32_t>(buffer_index_count);
+  contents->list_index_count = static_cast<uint32_t>(list_index_count);
+}
+
+bool xray::rendering::simple_mesh_data::import_model(
+    const char* model_data, const size_t data_size,
+    const uint32_t mesh_process_opts, const vertex_format fmt,
+    const uint32_t mesh_import_opts, const char* asset_name) {
+
+  struct ai_scene_deleter {
+    void operator()(const aiScene* scene) const noexcept {
+      if (scene)
+        aiReleaseImport(scene);
     }
-  }
+  };
 
-  _indexcount = num_indices;
+  //
+  //  Removing points and lines is the last property, left out when not
+  //  requested.
+  const mesh_import_property import_props[] = {
+      {AI_CONFIG_IMPORT_TER_MAKE_UVS, 1},
+      {AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_LINE | aiPrimitiveType_POINT}};
 
-  auto buffer_alloc_fn = [ num_vertices, fmt = _vertexformat ]()->void* {
-    switch (fmt) {
-    case vertex_format::pn:
-      return malloc(num_vertices * sizeof(vertex_pn));
-      break;
+  size_t props_count = XR_COUNTOF__(import_props) - 1;
+  if (mesh_import_opts & mesh_load_option::remove_points_lines)
+    props_count = XR_COUNTOF__(import_props);
 
-    case vertex_format::pnt:
-      return malloc(num_vertices * sizeof(vertex_pnt));
-      break;
+  unique_pointer<const aiScene, ai_scene_deleter> scene{
+      import_scene_timed(model_data, data_size, mesh_process_opts,
+                         import_props, props_count, asset_name)};
 
-    case vertex_format::pntt:
-      return malloc(num_vertices * sizeof(vertex_pntt));
-      break;
+  if (!scene)
+    return false;
 
-    default:
-      assert(false && "Unsupported vertex format!");
-      break;
-    };
+  const aiScene* imported_scene = raw_ptr(scene);
 
-    return nullptr;
-  };
+  timer_highp conversion_timer;
+  conversion_timer.start();
 
-  unique_pointer<void, malloc_deleter> imported_geometry{buffer_alloc_fn()};
-  if (num_indices > 65535)
-    _indexformat = index_format::u32;
+  size_t                 num_vertices = 0;
+  size_t                 num_indices  = 0;
+  vector<ai_mesh_layout> layout;
+  layout_ai_meshes(imported_scene, &layout, &num_vertices, &num_indices);
 
-  constexpr size_t INDEX_ELEMENT_SIZE[] = {sizeof(uint16_t), sizeof(uint32_t)};
-  const auto       index_buffer_bytes_size =
-      num_indices * INDEX_ELEMENT_SIZE[_indexformat == index_format::u32];
+  //
+  //  Packed formats are loaded as pntt and packed once the bounding box of
+  //  the model is known.
+  const auto load_format =
+      is_packed_format(fmt) ? vertex_format::pntt : fmt;
+  const auto fmt_desc = get_vertex_format_description(load_format);
 
-  unique_pointer<void, malloc_deleter> indices_buff{
-      malloc(index_buffer_bytes_size)};
+  vector<uint8_t> imported_geometry(num_vertices * fmt_desc.element_size);
 
-  uint32_t base_vertex{};
-  uint32_t input_base_index{};
-  uint32_t output_base_index{};
+  //
+  //  Indices are collected as 32 bits and narrowed (and possibly turned into
+  //  strips) once all meshes are loaded.
+  vector<uint32_t> indices(num_indices);
 
-  auto load_index_func = _indexformat == index_format::u32
-                             ? &mesh_load_face_indices<uint32_t>
-                             : &mesh_load_face_indices<uint16_t>;
+  //
+  //  Meshes write to disjoint ranges of the output buffers, convert them all
+  //  in parallel.
+  tbb::parallel_for(
+      uint32_t{0}, imported_scene->mNumMeshes,
+      [imported_scene, &layout, &indices, fmt = load_format,
+       vertices = imported_geometry.data() ](const uint32_t mesh_index) {
+        const aiMesh* curr_mesh   = imported_scene->mMeshes[mesh_index];
+        const auto&   mesh_layout = layout[mesh_index];
+
+        if (!curr_mesh->mVertices)
+          return;
+
+        switch (fmt) {
+        case vertex_format::pn:
+          mesh_load_vertices(curr_mesh,
+                             reinterpret_cast<vertex_pn*>(vertices) +
+                                 mesh_layout.base_vertex);
+          break;
+
+        case vertex_format::pnt:
+          mesh_load_vertices(curr_mesh,
+                             reinterpret_cast<vertex_pnt*>(vertices) +
+                                 mesh_layout.base_vertex);
+          break;
+
+        case vertex_format::pntt:
+          mesh_load_vertices(curr_mesh,
+                             reinterpret_cast<vertex_pntt*>(vertices) +
+                                 mesh_layout.base_vertex);
+          break;
+
+        default:
+          assert(false && "Unsupported vertex format!");
+          break;
+        }
+
+        mesh_load_indices(curr_mesh, mesh_layout.base_vertex,
+                          indices.data() + mesh_layout.index_offset);
+      });
 
   for (uint32_t mesh_index = 0; mesh_index < imported_scene->mNumMeshes;
        ++mesh_index) {
@@ -305,167 +438,395 @@ bool xray::rendering::simple_mesh::load_model_impl(
     if (!curr_mesh->mVertices)
       continue;
 
-    switch (_vertexformat) {
-    case vertex_format::pn:
-      mesh_load_vertex_pn(raw_ptr(imported_geometry), curr_mesh, base_vertex);
-      break;
+    geometry_submesh submesh;
+    submesh.base_vertex    = layout[mesh_index].base_vertex;
+    submesh.vertex_count   = curr_mesh->mNumVertices;
+    submesh.index_offset   = layout[mesh_index].index_offset;
+    submesh.index_count    = layout[mesh_index].index_count;
+    submesh.material_index = curr_mesh->mMaterialIndex;
+    _submeshes.push_back(submesh);
+  }
+
+  //
+  //  Position is the first component of every vertex format.
+  {
+    const auto vertices = imported_geometry.data();
+
+    for (auto& sm : _submeshes) {
+      const auto first = reinterpret_cast<const float3*>(
+          vertices + sm.base_vertex * fmt_desc.element_size);
+      sm.bounding_box =
+          compute_aabb(first, fmt_desc.element_size, sm.vertex_count);
+      sm.bounding_sphere = compute_bounding_sphere(
+          first, fmt_desc.element_size, sm.vertex_count, sm.bounding_box);
+    }
 
-    case vertex_format::pnt:
-      mesh_load_vertex_pnt(raw_ptr(imported_geometry), curr_mesh, base_vertex);
-      break;
+    const auto first = reinterpret_cast<const float3*>(vertices);
+    _contents.bounding_box =
+        compute_aabb(first, fmt_desc.element_size, num_vertices);
+    _contents.bounding_sphere =
+        compute_bounding_sphere(first, fmt_desc.element_size, num_vertices,
+                                _contents.bounding_box);
+  }
 
-    case vertex_format::pntt:
-      mesh_load_vertex_pntt(raw_ptr(imported_geometry), curr_mesh, base_vertex);
-      break;
+  const auto buffer_desc = get_vertex_format_description(fmt);
 
-    default:
-      assert(false && "Unsupported vertex format!");
-      break;
-    }
+  if (is_packed_format(fmt)) {
+    _contents.quantization = make_vertex_quantization(_contents.bounding_box);
 
-    //
-    //  Collect indices defining primitives.
-    for (uint32_t face_index = 0; face_index < curr_mesh->mNumFaces;
-         ++face_index) {
-      const aiFace* curr_face = &curr_mesh->mFaces[face_index];
+    vector<uint8_t> packed_geometry(num_vertices * buffer_desc.element_size);
 
-      for (uint32_t i = 0; i < curr_face->mNumIndices; ++i) {
-        load_index_func(raw_ptr(indices_buff), output_base_index,
-                        input_base_index, curr_face);
-      }
+    const auto source =
+        reinterpret_cast<const vertex_pntt*>(imported_geometry.data());
 
-      output_base_index += curr_face->mNumIndices;
-    }
+    pack_geometry(fmt,
+                  gsl::span<const vertex_pntt>{
+                      source, static_cast<ptrdiff_t>(num_vertices)},
+                  _contents.quantization, packed_geometry.data());
 
-    input_base_index += curr_mesh->mNumVertices;
-    base_vertex += curr_mesh->mNumVertices;
+    imported_geometry.swap(packed_geometry);
   }
 
-  const auto fmt_desc = [fmt = _vertexformat]() {
-    switch (fmt) {
-    case vertex_format::pn:
-      return describe_vertex_format<vertex_format::pn>();
-      break;
+  _vertices = std::move(imported_geometry);
 
-    case vertex_format::pnt:
-      return describe_vertex_format<vertex_format::pnt>();
-      break;
+  build_index_buffer(
+      gsl::span<const uint32_t>{indices.data(),
+                                static_cast<ptrdiff_t>(indices.size())},
+      num_vertices, (mesh_import_opts & mesh_load_option::use_strips) != 0,
+      &_submeshes, &_indices, &_contents);
 
-    case vertex_format::pntt:
-      return describe_vertex_format<vertex_format::pntt>();
-      break;
+  _contents.vertex_fmt   = fmt;
+  _contents.vertices     = _vertices.data();
+  _contents.vertex_count = static_cast<uint32_t>(num_vertices);
+  _contents.vertex_size  = static_cast<uint32_t>(buffer_desc.element_size);
+  _contents.submeshes    = gsl::span<const geometry_submesh>{
+      _submeshes.data(), static_cast<ptrdiff_t>(_submeshes.size())};
 
-    default:
-      assert(false && "Unsupported vertex format!");
-      break;
-    }
+  conversion_timer.end();
+  XR_LOG_INFO("Import {} : conversion {:.3f} ms", asset_name,
+              conversion_timer.elapsed_millis());
 
-    return vertex_format_info{};
-  }
-  ();
+  return true;
+}
 
-  _vertexbuffer =
-      [ buffdata = raw_ptr(imported_geometry), num_vertices, &fmt_desc ]() {
-    GLuint vbuff{};
-    gl::CreateBuffers(1, &vbuff);
-    gl::NamedBufferStorage(vbuff, num_vertices * fmt_desc.element_size,
-                           buffdata, 0);
+static constexpr uint32_t PROFILE_LOAD_OPTIONS =
+    mesh_load_option::profile_fast | mesh_load_option::profile_balanced |
+    mesh_load_option::profile_full;
 
-    return vbuff;
-  }
-  ();
+static mesh_import_profile
+import_profile_from_options(const uint32_t load_options) noexcept {
+  if (load_options & mesh_load_option::profile_fast)
+    return mesh_import_profile::fast;
 
-  _indexbuffer =
-      [ buffdata = raw_ptr(indices_buff), index_buffer_bytes_size ]() {
-    GLuint ibuff{};
-    gl::CreateBuffers(1, &ibuff);
-    gl::NamedBufferStorage(ibuff, index_buffer_bytes_size, buffdata, 0);
+  if (load_options & mesh_load_option::profile_balanced)
+    return mesh_import_profile::balanced;
 
-    return ibuff;
-  }
-  ();
+  if (load_options & mesh_load_option::profile_full)
+    return mesh_import_profile::full;
 
-  //  _vertexarray = [
-  //    vb = raw_handle(_vertexbuffer), ib = raw_handle(_indexbuffer), &fmt_desc
-  //  ]() {
-  //    GLuint vao{};
-  //    gl::CreateVertexArrays(1, &vao);
-  //    gl::BindVertexArray(vao);
-  //    gl::BindBuffer(gl::ELEMENT_ARRAY_BUFFER, ib);
-  //    gl::VertexArrayVertexBuffer(vao, 0, vb, 0, fmt_desc.element_size);
-
-  //    for (uint32_t idx = 0; idx < fmt_desc.components; ++idx) {
-  //      const auto& component_desc = fmt_desc.description[idx];
-  //      gl::EnableVertexArrayAttrib(vao, idx);
-  //      gl::VertexArrayAttribFormat(vao, idx, component_desc.component_count,
-  //                                  component_desc.component_type, gl::FALSE_,
-  //                                  component_desc.component_offset);
-  //      gl::VertexArrayAttribBinding(vao, idx, 0);
-  //    }
-
-  //    gl::BindVertexArray(0);
-  //    gl::BindBuffer(gl::ELEMENT_ARRAY_BUFFER, 0);
-  //    return vao;
-  //  }
-  //  ();
+  return default_mesh_import_profile();
+}
 
-  create_vertexarray();
-  return true;
+static uint32_t
+profile_load_option(const mesh_import_profile profile) noexcept {
+  const uint32_t profile_options[] = {mesh_load_option::profile_fast,
+                                      mesh_load_option::profile_balanced,
+                                      mesh_load_option::profile_full};
+  return profile_options[static_cast<size_t>(profile)];
 }
 
-xray::rendering::simple_mesh::simple_mesh(const vertex_format fmt,
-                                          const char*         mesh_file,
-                                          const uint32_t      load_options)
-    : _vertexformat{fmt} {
+bool xray::rendering::simple_mesh_data::from_file(
+    const vertex_format fmt, const char* mesh_file,
+    const uint32_t load_options, simple_mesh_data* mesh_data) {
+  assert(mesh_file != nullptr);
+  assert(mesh_data != nullptr);
+
+  *mesh_data = simple_mesh_data{};
 
-  constexpr uint32_t default_processing_opts =
-      aiProcess_CalcTangentSpace |         // calculate tangents and
-      aiProcess_JoinIdenticalVertices |    // join identical vertices/
-      aiProcess_ValidateDataStructure |    // perform a full validation of the
-      aiProcess_ImproveCacheLocality |     // improve the cache locality of
-      aiProcess_RemoveRedundantMaterials | // remove redundant materials
-      aiProcess_FindDegenerates |   // remove degenerated polygons from the
-      aiProcess_FindInvalidData |   // detect invalid model data, such as
-      aiProcess_GenUVCoords |       // convert spherical, cylindrical, box and
-      aiProcess_TransformUVCoords | // preprocess UV transformations
-      aiProcess_FindInstances |     // search for instanced meshes and remove
-      aiProcess_LimitBoneWeights |  // limit bone weights to 4 per vertex
-      aiProcess_OptimizeMeshes |    // join small meshes, if possible;
-      aiProcess_SplitByBoneCount |  // split meshes with too many bones.
-      0;
-
-  constexpr auto post_processing_opts =
-      default_processing_opts | aiProcess_GenSmoothNormals | // generate smooth
-      aiProcess_SplitLargeMeshes |                           // split large,
-      aiProcess_Triangulate | // triangulate polygons with
-      aiProcess_SortByPType | // make 'clean' meshes which consist of a
-      0;
+  //
+  //  Everything that changes the imported geometry is part of the key, the
+  //  processing options follow from the load options.
+  const auto profile = import_profile_from_options(load_options);
+  const auto import_opts =
+      (load_options & ~PROFILE_LOAD_OPTIONS) | profile_load_option(profile);
+
+  mesh_cache_key cache_key;
+  string         cache_file;
+
+  if (!(import_opts & mesh_load_option::no_cache) &&
+      make_mesh_cache_key(mesh_file, import_opts, fmt, &cache_key)) {
+    cache_file = mesh_cache_path(cache_key);
+
+    if (!cache_file.empty() &&
+        mesh_data->_cached.open(cache_file.c_str(), cache_key)) {
+      mesh_data->_contents = mesh_data->_cached.data();
+      return true;
+    }
+  }
 
   const auto all_processing_opts =
-      post_processing_opts |
-      (load_options & mesh_load_option::convert_left_handed
+      mesh_import_profile_steps(profile) |
+      (import_opts & mesh_load_option::convert_left_handed
            ? aiProcess_ConvertToLeftHanded
            : 0);
 
   try {
     platformstl::memory_mapped_file mesh_mmfile{mesh_file};
-    _valid =
-        load_model_impl(static_cast<const char*>(mesh_mmfile.memory()),
-                        mesh_mmfile.size(), all_processing_opts, load_options);
+
+    if (!mesh_data->import_model(
+            static_cast<const char*>(mesh_mmfile.memory()), mesh_mmfile.size(),
+            all_processing_opts, fmt, import_opts, mesh_file)) {
+      return false;
+    }
   } catch (const std::exception&) {
     XR_LOG_ERR("Failed to import model file {}", mesh_file);
+    return false;
   }
+
+  //
+  //  Not fatal, the model is imported again next time.
+  if (!cache_file.empty())
+    write_mesh_cache(cache_file.c_str(), cache_key, mesh_data->_contents);
+
+  return true;
+}
+
+xray::rendering::simple_mesh::simple_mesh(const vertex_format fmt,
+                                          const char*         mesh_file,
+                                          const uint32_t      load_options)
+    : _vertexformat{fmt} {
+  simple_mesh_data mesh_data;
+  if (simple_mesh_data::from_file(fmt, mesh_file, load_options, &mesh_data))
+    upload(mesh_data);
 }
 
-void xray::rendering::simple_mesh::draw() {
+void xray::rendering::simple_mesh::upload(const simple_mesh_data& mesh_data) {
+  const auto& contents = mesh_data.contents();
+
+  _vertexformat = contents.vertex_fmt;
+  assert(contents.vertex_size ==
+         get_vertex_format_description(_vertexformat).element_size);
+
+  const size_t index_bytes = contents.index_fmt == index_format::u16
+                                 ? sizeof(uint16_t)
+                                 : sizeof(uint32_t);
+
+  const auto make_buffer = [](const void* data, const size_t bytes) {
+    GLuint buff{};
+    gl::CreateBuffers(1, &buff);
+    gl::NamedBufferStorage(buff, static_cast<GLsizeiptr>(bytes), data, 0);
+    return buff;
+  };
+
+  _vertexbuffer = make_buffer(
+      contents.vertices, size_t{contents.vertex_count} * contents.vertex_size);
+  _indexbuffer =
+      make_buffer(contents.indices, size_t{contents.index_count} * index_bytes);
+
+  _indexformat     = contents.index_fmt;
+  _strips          = contents.strips;
+  _aabb            = contents.bounding_box;
+  _bounding_sphere = contents.bounding_sphere;
+  _quantization    = contents.quantization;
+  _lods            = mesh_data.lods();
+  _indexcount = _lods.empty() ? contents.index_count : _lods[0].index_count;
+  _submeshes.assign(begin(contents.submeshes), end(contents.submeshes));
+  build_material_batches();
+
+  _indexstats.format         = _indexformat;
+  _indexstats.strips         = _strips;
+  _indexstats.index_count    = contents.index_count;
+  _indexstats.buffer_bytes   = size_t{contents.index_count} * index_bytes;
+  _indexstats.list_u32_bytes =
+      size_t{contents.list_index_count} * sizeof(uint32_t);
+
+  create_vertexarray();
+  _valid = true;
+}
+
+void xray::rendering::simple_mesh::draw() { draw(0); }
+
+void xray::rendering::simple_mesh::draw(const size_t lod) {
   assert(valid());
+  assert(lod < lod_count());
 
   scoped_vertex_array_binding vao_binding{raw_handle(_vertexarray)};
   XR_UNUSED_ARG(vao_binding);
 
   const GLuint element_type[] = {gl::UNSIGNED_SHORT, gl::UNSIGNED_INT};
-  gl::DrawElements(gl::TRIANGLES, _indexcount,
-                   element_type[_indexformat == index_format::u32], nullptr);
+  const size_t index_size[]   = {sizeof(uint16_t), sizeof(uint32_t)};
+  const auto   is_u32         = _indexformat == index_format::u32;
+
+  if (_strips) {
+    scoped_capability restart{gl::PRIMITIVE_RESTART_FIXED_INDEX, true};
+    XR_UNUSED_ARG(restart);
+
+    gl::DrawElements(gl::TRIANGLE_STRIP, _indexcount, element_type[is_u32],
+                     nullptr);
+    return;
+  }
+
+  if (_lods.empty()) {
+    gl::DrawElements(gl::TRIANGLES, _indexcount, element_type[is_u32],
+                     nullptr);
+    return;
+  }
+
+  const auto& lvl = _lods[lod];
+  gl::DrawElements(gl::TRIANGLES, static_cast<GLsizei>(lvl.index_count),
+                   element_type[is_u32],
+                   reinterpret_cast<const void*>(
+                       static_cast<uintptr_t>(lvl.index_offset) *
+                       index_size[is_u32]));
+}
+
+size_t xray::rendering::simple_mesh::select_lod(const float max_error) const
+    noexcept {
+  size_t selected{};
+
+  for (size_t i = 1; i < _lods.size(); ++i) {
+    if (_lods[i].error <= max_error)
+      selected = i;
+  }
+
+  return selected;
+}
+
+const void* xray::rendering::simple_mesh::index_buffer_offset(
+    const uint32_t first_index) const noexcept {
+  const size_t index_size = _indexformat == index_format::u32
+                                ? sizeof(uint32_t)
+                                : sizeof(uint16_t);
+
+  return reinterpret_cast<const void*>(static_cast<uintptr_t>(first_index) *
+                                       index_size);
+}
+
+void xray::rendering::simple_mesh::build_material_batches() {
+  _material_batches.clear();
+  _batch_counts.clear();
+  _batch_offsets.clear();
+
+  vector<uint32_t> order(_submeshes.size());
+  iota(begin(order), end(order), 0u);
+  stable_sort(begin(order), end(order),
+              [this](const uint32_t lhs, const uint32_t rhs) {
+                return _submeshes[lhs].material_index <
+                       _submeshes[rhs].material_index;
+              });
+
+  //
+  //  Strips of consecutive submeshes are separated by one restart index,
+  //  which is kept when merging them.
+  const uint32_t separator = _strips ? 1 : 0;
+
+  const auto add_range = [this](const uint32_t first, const uint32_t last) {
+    _batch_counts.push_back(static_cast<GLsizei>(last - first));
+    _batch_offsets.push_back(index_buffer_offset(first));
+  };
+
+  for (size_t i = 0; i < order.size();) {
+    mesh_material_batch batch;
+    batch.material_index = _submeshes[order[i]].material_index;
+    batch.first_range    = static_cast<uint32_t>(_batch_counts.size());
+
+    const auto& first_sm    = _submeshes[order[i]];
+    uint32_t    range_first = first_sm.index_offset;
+    uint32_t    range_last  = first_sm.index_offset + first_sm.index_count;
+
+    for (++i; i < order.size() &&
+              _submeshes[order[i]].material_index == batch.material_index;
+         ++i) {
+      const auto& sm = _submeshes[order[i]];
+
+      if (sm.index_offset != range_last + separator) {
+        add_range(range_first, range_last);
+        range_first = sm.index_offset;
+      }
+
+      range_last = sm.index_offset + sm.index_count;
+    }
+
+    add_range(range_first, range_last);
+    batch.range_count =
+        static_cast<uint32_t>(_batch_counts.size()) - batch.first_range;
+    _material_batches.push_back(batch);
+  }
+}
+
+void xray::rendering::simple_mesh::draw_ranges(const GLsizei*     counts,
+                                               const void* const* offsets,
+                                               const size_t range_count) {
+  if (range_count == 0)
+    return;
+
+  scoped_vertex_array_binding vao_binding{raw_handle(_vertexarray)};
+  XR_UNUSED_ARG(vao_binding);
+
+  const GLenum element_type = _indexformat == index_format::u32
+                                  ? gl::UNSIGNED_INT
+                                  : gl::UNSIGNED_SHORT;
+
+  if (_strips) {
+    scoped_capability restart{gl::PRIMITIVE_RESTART_FIXED_INDEX, true};
+    XR_UNUSED_ARG(restart);
+
+    gl::MultiDrawElements(gl::TRIANGLE_STRIP, counts, element_type, offsets,
+                          static_cast<GLsizei>(range_count));
+    return;
+  }
+
+  gl::MultiDrawElements(gl::TRIANGLES, counts, element_type, offsets,
+                        static_cast<GLsizei>(range_count));
+}
+
+void xray::rendering::simple_mesh::draw_submesh(const size_t submesh) {
+  assert(valid());
+  assert(submesh < _submeshes.size());
+
+  const auto&   sm     = _submeshes[submesh];
+  const GLsizei count  = static_cast<GLsizei>(sm.index_count);
+  const void*   offset = index_buffer_offset(sm.index_offset);
+
+  draw_ranges(&count, &offset, 1);
+}
+
+void xray::rendering::simple_mesh::draw_submeshes(
+    const gsl::span<const uint32_t> submesh_indices) {
+  assert(valid());
+
+  vector<GLsizei>     counts;
+  vector<const void*> offsets;
+  counts.reserve(static_cast<size_t>(submesh_indices.size()));
+  offsets.reserve(static_cast<size_t>(submesh_indices.size()));
+
+  for (const auto sm_idx : submesh_indices) {
+    assert(sm_idx < _submeshes.size());
+    const auto& sm = _submeshes[sm_idx];
+
+    counts.push_back(static_cast<GLsizei>(sm.index_count));
+    offsets.push_back(index_buffer_offset(sm.index_offset));
+  }
+
+  draw_ranges(counts.data(), offsets.data(), counts.size());
+}
+
+void xray::rendering::simple_mesh::draw_material(
+    const uint32_t material_index) {
+  assert(valid());
+
+  const auto batch = lower_bound(
+      begin(_material_batches), end(_material_batches), material_index,
+      [](const mesh_material_batch& b, const uint32_t mtl) {
+        return b.material_index < mtl;
+      });
+
+  if (batch == end(_material_batches) ||
+      batch->material_index != material_index)
+    return;
+
+  draw_ranges(_batch_counts.data() + batch->first_range,
+              _batch_offsets.data() + batch->first_range, batch->range_count);
 }
 
 template <typename OutputFormatType, typename InputFormatType>
@@ -505,64 +866,89 @@ void copy_geometry(void* dest, const geometry_data_t& geometry) {
     *out++ = format_cast<OutputFormatType>(vs_in);
 }
 
-xray::rendering::simple_mesh::simple_mesh(const vertex_format    fmt,
-                                          const geometry_data_t& geometry)
-    : _vertexformat{fmt}
-    , _indexformat{index_format::u32}
-    , _indexcount{static_cast<uint32_t>(geometry.index_count)} {
-
-  const auto fmt_desc = get_vertex_format_description(_vertexformat);
-  unique_pointer<void, malloc_deleter> vbuff_data;
-  void*      buffer_init_data{nullptr};
-  GLsizeiptr buffer_bytes{};
-
-  if (fmt != vertex_format::pntt) {
-    buffer_bytes =
-        static_cast<GLsizeiptr>(geometry.vertex_count * fmt_desc.element_size);
-    vbuff_data = unique_pointer<void, malloc_deleter>(malloc(buffer_bytes));
-
-    buffer_init_data = raw_ptr(vbuff_data);
-
-    switch (fmt) {
-    case vertex_format::pn:
-      copy_geometry<vertex_pn>(buffer_init_data, geometry);
-      break;
-
-    case vertex_format::pnt:
-      copy_geometry<vertex_pnt>(buffer_init_data, geometry);
-      break;
-
-    default:
-      assert(false && "Unsupported vertex format !");
-      break;
-    }
+bool xray::rendering::simple_mesh_data::from_geometry(
+    const vertex_format fmt, const geometry_data_t& geometry,
+    const uint32_t load_options, simple_mesh_data* mesh_data) {
+  assert(mesh_data != nullptr);
+
+  *mesh_data     = simple_mesh_data{};
+  auto& contents = mesh_data->_contents;
 
-  } else {
-    buffer_bytes =
-        static_cast<GLsizeiptr>(geometry.vertex_count * sizeof(vertex_pntt));
-    buffer_init_data = raw_ptr(geometry.geometry);
+  contents.bounding_box    = geometry.bounding_box;
+  contents.bounding_sphere = geometry.bounding_sphere;
+
+  if (contents.bounding_box.is_empty() && geometry.vertex_count != 0) {
+    compute_vertex_bounds(raw_ptr(geometry.geometry), geometry.vertex_count,
+                          &contents.bounding_box, &contents.bounding_sphere);
   }
 
-  _vertexbuffer = [buffer_bytes, buffer_init_data]() {
-    GLuint vbuff{};
-    gl::CreateBuffers(1, &vbuff);
-    gl::NamedBufferStorage(vbuff, buffer_bytes, buffer_init_data, 0);
-    return vbuff;
-  }();
+  const auto fmt_desc = get_vertex_format_description(fmt);
+  mesh_data->_vertices.resize(geometry.vertex_count * fmt_desc.element_size);
+  void* buffer_init_data = mesh_data->_vertices.data();
 
-  _indexbuffer = [
-    data     = raw_ptr(geometry.indices),
-    bytesize = geometry.index_count * sizeof(uint32_t)
-  ]() {
-    GLuint vbuff{};
-    gl::CreateBuffers(1, &vbuff);
-    gl::NamedBufferStorage(vbuff, static_cast<GLsizeiptr>(bytesize), data, 0);
-    return vbuff;
+  switch (fmt) {
+  case vertex_format::pn:
+    copy_geometry<vertex_pn>(buffer_init_data, geometry);
+    break;
+
+  case vertex_format::pnt:
+    copy_geometry<vertex_pnt>(buffer_init_data, geometry);
+    break;
+
+  case vertex_format::pntt:
+    if (geometry.vertex_count != 0) {
+      memcpy(buffer_init_data, raw_ptr(geometry.geometry),
+             geometry.vertex_count * sizeof(vertex_pntt));
+    }
+    break;
+
+  case vertex_format::pnt_packed:
+  case vertex_format::pntt_packed:
+    contents.quantization = make_vertex_quantization(contents.bounding_box);
+    pack_geometry(fmt,
+                  gsl::span<const vertex_pntt>{
+                      raw_ptr(geometry.geometry),
+                      static_cast<ptrdiff_t>(geometry.vertex_count)},
+                  contents.quantization, buffer_init_data);
+    break;
+
+  default:
+    assert(false && "Unsupported vertex format !");
+    return false;
+    break;
   }
-  ();
 
-  create_vertexarray();
-  _valid = true;
+  mesh_data->_submeshes = geometry.submeshes;
+  mesh_data->_lods      = geometry.lods;
+
+  build_index_buffer(
+      gsl::span<const uint32_t>{raw_ptr(geometry.indices),
+                                static_cast<ptrdiff_t>(geometry.index_count)},
+      geometry.vertex_count,
+      (load_options & mesh_load_option::use_strips) != 0 &&
+          mesh_data->_lods.empty(),
+      &mesh_data->_submeshes, &mesh_data->_indices, &contents);
+
+  contents.vertex_fmt   = fmt;
+  contents.vertices     = mesh_data->_vertices.data();
+  contents.vertex_count = static_cast<uint32_t>(geometry.vertex_count);
+  contents.vertex_size  = static_cast<uint32_t>(fmt_desc.element_size);
+  contents.submeshes    = gsl::span<const geometry_submesh>{
+      mesh_data->_submeshes.data(),
+      static_cast<ptrdiff_t>(mesh_data->_submeshes.size())};
+
+  return true;
+}
+
+xray::rendering::simple_mesh::simple_mesh(const vertex_format    fmt,
+                                          const geometry_data_t& geometry,
+                                          const uint32_t load_options)
+    : _vertexformat{fmt} {
+  simple_mesh_data mesh_data;
+  if (simple_mesh_data::from_geometry(fmt, geometry, load_options,
+                                      &mesh_data)) {
+    upload(mesh_data);
+  }
 }
 
 static constexpr GLuint COMPONENT_TYPES[] = {
@@ -573,7 +959,9 @@ static constexpr GLuint COMPONENT_TYPES[] = {
     gl::INT,            ///< 32 bits int, signed
     gl::UNSIGNED_INT,   ///< 32 bits int, unsigned
     gl::FLOAT,          ///< 32 bits, simple precision floating point
-    gl::DOUBLE          ///< 64 bits, double precision floating point
+    gl::DOUBLE,         ///< 64 bits, double precision floating point
+    gl::HALF_FLOAT,     ///< 16 bits, half precision floating point
+    gl::INT_2_10_10_10_REV ///< 3 x 10 bits + 2 bits int, signed
 };
 
 struct helpers {
@@ -601,7 +989,8 @@ void xray::rendering::simple_mesh::create_vertexarray() {
       gl::VertexArrayAttribFormat(
           vao, idx, static_cast<GLint>(component_desc.component_count),
           helpers::map_component_type(component_desc.component_type),
-          gl::FALSE_, component_desc.component_offset);
+          component_desc.normalized ? gl::TRUE_ : gl::FALSE_,
+          component_desc.component_offset);
       gl::VertexArrayAttribBinding(vao, idx, 0);
     }
 
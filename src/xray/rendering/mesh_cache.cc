@@ -0,0 +1,242 @@
+#include "xray/rendering/mesh_cache.hpp"
+#include "xray/base/app_config.hpp"
+#include "xray/base/array_dimension.hpp"
+#include "xray/base/file_io.hpp"
+#include "xray/base/fnv_hash.hpp"
+#include "xray/base/logger.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <type_traits>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::math;
+using namespace xray::rendering;
+
+static constexpr uint32_t MESH_CACHE_MAGIC   = 0x434d5258; // "XRMC"
+static constexpr uint32_t MESH_CACHE_VERSION = 2;
+
+///
+/// Streams start on this boundary (relative to the start of the file, which
+/// is mapped at a page boundary).
+static constexpr uint64_t MESH_CACHE_STREAM_ALIGNMENT = 16;
+
+//
+//  On disk layout : header, then the vertex, index and submesh streams,
+//  each aligned to MESH_CACHE_STREAM_ALIGNMENT. Files are only read back
+//  by the build that wrote them (the version is bumped on layout changes),
+//  so structures are stored as is.
+struct mesh_cache_header {
+  uint32_t            magic;
+  uint32_t            version;
+  mesh_cache_key      key;
+  uint32_t            vertex_format;
+  uint32_t            index_format;
+  uint32_t            strips;
+  uint32_t            vertex_count;
+  uint32_t            vertex_size;
+  uint32_t            index_count;
+  uint32_t            list_index_count;
+  uint32_t            submesh_count;
+  uint32_t            submesh_size;
+  aabb3f              bounding_box;
+  sphere3f            bounding_sphere;
+  vertex_quantization quantization;
+  uint64_t            vertex_offset;
+  uint64_t            index_offset;
+  uint64_t            submesh_offset;
+  uint64_t            file_size;
+};
+
+static_assert(std::is_trivially_copyable<geometry_submesh>::value,
+              "Submeshes are written as is!");
+
+static uint64_t align_stream(const uint64_t offset) noexcept {
+  return (offset + MESH_CACHE_STREAM_ALIGNMENT - 1) &
+         ~(MESH_CACHE_STREAM_ALIGNMENT - 1);
+}
+
+static size_t index_size(const index_format fmt) noexcept {
+  return fmt == index_format::u16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+static bool keys_equal(const mesh_cache_key& a,
+                       const mesh_cache_key& b) noexcept {
+  return a.source_size == b.source_size && a.source_mtime == b.source_mtime &&
+         a.source_path_hash == b.source_path_hash &&
+         a.import_options == b.import_options &&
+         a.vertex_format == b.vertex_format;
+}
+
+bool xray::rendering::make_mesh_cache_key(const char*         source_path,
+                                          const uint32_t      import_options,
+                                          const vertex_format fmt,
+                                          mesh_cache_key*     key) {
+  assert(source_path != nullptr);
+  assert(key != nullptr);
+
+  struct stat source_info;
+  if (stat(source_path, &source_info) != 0)
+    return false;
+
+  key->source_size      = static_cast<uint64_t>(source_info.st_size);
+  key->source_mtime     = static_cast<int64_t>(source_info.st_mtime);
+  key->source_path_hash = FNV::fnv1a(source_path);
+  key->import_options   = import_options;
+  key->vertex_format    = static_cast<uint32_t>(fmt);
+  key->reserved         = 0;
+
+  return true;
+}
+
+std::string xray::rendering::mesh_cache_path(const mesh_cache_key& key) {
+  const auto cfg = app_config::instance();
+  if (!cfg)
+    return {};
+
+  //
+  //  Format and options are part of the name, so that the same model
+  //  imported in different ways gets one file per variant.
+  char file_name[64];
+  snprintf(file_name, sizeof(file_name), "%08x_%02x_%08x.xmesh",
+           key.source_path_hash, key.vertex_format, key.import_options);
+
+  return cfg->cache_path(file_name);
+}
+
+bool xray::rendering::write_mesh_cache(const char*            cache_file,
+                                       const mesh_cache_key&  key,
+                                       const mesh_cache_data& data) {
+  assert(cache_file != nullptr);
+
+  mesh_cache_header hdr;
+  //
+  //  Clear padding too, identical imports produce identical files.
+  memset(static_cast<void*>(&hdr), 0, sizeof(hdr));
+
+  hdr.magic            = MESH_CACHE_MAGIC;
+  hdr.version          = MESH_CACHE_VERSION;
+  hdr.key              = key;
+  hdr.vertex_format    = static_cast<uint32_t>(data.vertex_fmt);
+  hdr.index_format     = static_cast<uint32_t>(data.index_fmt);
+  hdr.strips           = data.strips;
+  hdr.vertex_count     = data.vertex_count;
+  hdr.vertex_size      = data.vertex_size;
+  hdr.index_count      = data.index_count;
+  hdr.list_index_count = data.list_index_count;
+  hdr.submesh_count    = static_cast<uint32_t>(data.submeshes.size());
+  hdr.submesh_size     = sizeof(geometry_submesh);
+  hdr.bounding_box     = data.bounding_box;
+  hdr.bounding_sphere  = data.bounding_sphere;
+  hdr.quantization     = data.quantization;
+
+  const uint64_t vertex_bytes =
+      uint64_t{data.vertex_count} * uint64_t{data.vertex_size};
+  const uint64_t index_bytes =
+      uint64_t{data.index_count} * index_size(data.index_fmt);
+  const uint64_t submesh_bytes =
+      uint64_t{hdr.submesh_count} * sizeof(geometry_submesh);
+
+  hdr.vertex_offset  = align_stream(sizeof(hdr));
+  hdr.index_offset   = align_stream(hdr.vertex_offset + vertex_bytes);
+  hdr.submesh_offset = align_stream(hdr.index_offset + index_bytes);
+  hdr.file_size      = hdr.submesh_offset + submesh_bytes;
+
+  static const uint8_t padding[MESH_CACHE_STREAM_ALIGNMENT] = {};
+  const auto pad = [](const uint64_t offset, const uint64_t stream_end) {
+    assert(offset >= stream_end && offset - stream_end < sizeof(padding));
+    return file_write_chunk{padding, static_cast<size_t>(offset - stream_end)};
+  };
+
+  const file_write_chunk chunks[] = {
+      {&hdr, sizeof(hdr)},
+      pad(hdr.vertex_offset, sizeof(hdr)),
+      {data.vertices, static_cast<size_t>(vertex_bytes)},
+      pad(hdr.index_offset, hdr.vertex_offset + vertex_bytes),
+      {data.indices, static_cast<size_t>(index_bytes)},
+      pad(hdr.submesh_offset, hdr.index_offset + index_bytes),
+      {data.submeshes.data(), static_cast<size_t>(submesh_bytes)}};
+
+  if (!atomic_write_file(cache_file, chunks, XR_COUNTOF__(chunks))) {
+    XR_LOG_ERR("Failed to write mesh cache file {}", cache_file);
+    return false;
+  }
+
+  return true;
+}
+
+bool xray::rendering::mesh_cache_file::open(const char*           cache_file,
+                                            const mesh_cache_key& key) {
+  assert(cache_file != nullptr);
+
+  _mapping.reset();
+  _data = mesh_cache_data{};
+
+  //
+  //  A missing file is the normal cache miss, check first instead of
+  //  relying on the exception.
+  struct stat file_info;
+  if (stat(cache_file, &file_info) != 0 ||
+      static_cast<size_t>(file_info.st_size) < sizeof(mesh_cache_header))
+    return false;
+
+  try {
+    _mapping.reset(new platformstl::memory_mapped_file{cache_file});
+  } catch (const std::exception&) {
+    XR_LOG_ERR("Failed to map mesh cache file {}", cache_file);
+    return false;
+  }
+
+  const auto file_data = static_cast<const uint8_t*>(_mapping->memory());
+  const auto file_size = static_cast<uint64_t>(_mapping->size());
+
+  mesh_cache_header hdr;
+  memcpy(&hdr, file_data, sizeof(hdr));
+
+  const bool valid =
+      hdr.magic == MESH_CACHE_MAGIC && hdr.version == MESH_CACHE_VERSION &&
+      hdr.file_size == file_size &&
+      hdr.submesh_size == sizeof(geometry_submesh) &&
+      hdr.index_format <= static_cast<uint32_t>(index_format::u32) &&
+      hdr.vertex_offset >= sizeof(hdr) &&
+      hdr.vertex_offset + uint64_t{hdr.vertex_count} * hdr.vertex_size <=
+          hdr.index_offset &&
+      hdr.index_offset +
+              uint64_t{hdr.index_count} *
+                  index_size(static_cast<index_format>(hdr.index_format)) <=
+          hdr.submesh_offset &&
+      hdr.submesh_offset + uint64_t{hdr.submesh_count} * hdr.submesh_size <=
+          file_size;
+
+  if (!valid) {
+    XR_LOG_ERR("Damaged or outdated mesh cache file {}", cache_file);
+    _mapping.reset();
+    return false;
+  }
+
+  if (!keys_equal(hdr.key, key)) {
+    _mapping.reset();
+    return false;
+  }
+
+  _data.vertex_fmt       = static_cast<vertex_format>(hdr.vertex_format);
+  _data.index_fmt        = static_cast<index_format>(hdr.index_format);
+  _data.strips           = hdr.strips != 0;
+  _data.vertices         = file_data + hdr.vertex_offset;
+  _data.vertex_count     = hdr.vertex_count;
+  _data.vertex_size      = hdr.vertex_size;
+  _data.indices          = file_data + hdr.index_offset;
+  _data.index_count      = hdr.index_count;
+  _data.list_index_count = hdr.list_index_count;
+  _data.submeshes        = gsl::span<const geometry_submesh>{
+      reinterpret_cast<const geometry_submesh*>(file_data +
+                                                hdr.submesh_offset),
+      static_cast<ptrdiff_t>(hdr.submesh_count)};
+  _data.bounding_box     = hdr.bounding_box;
+  _data.bounding_sphere  = hdr.bounding_sphere;
+  _data.quantization     = hdr.quantization;
+
+  return true;
+}
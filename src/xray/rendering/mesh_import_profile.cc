@@ -0,0 +1,225 @@
+#include "xray/rendering/mesh_import_profile.hpp"
+#include "xray/base/app_config.hpp"
+#include "xray/base/array_dimension.hpp"
+#include "xray/base/basic_timer.hpp"
+#include "xray/base/logger.hpp"
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::rendering;
+
+static constexpr const char* const PROFILE_NAMES[] = {"fast", "balanced",
+                                                      "full"};
+
+static constexpr uint32_t FAST_PROFILE_STEPS =
+    aiProcess_Triangulate |             // triangulate polygons
+    aiProcess_SortByPType |             // one primitive type per mesh
+    aiProcess_JoinIdenticalVertices |   // indexed meshes
+    aiProcess_GenSmoothNormals |        // generate missing normals
+    aiProcess_CalcTangentSpace;         // and tangents
+
+static constexpr uint32_t BALANCED_PROFILE_STEPS =
+    FAST_PROFILE_STEPS |                 //
+    aiProcess_RemoveRedundantMaterials | // remove redundant materials
+    aiProcess_FindDegenerates |          // remove degenerated polygons
+    aiProcess_FindInvalidData |          // fix zeroed normals/uvs
+    aiProcess_GenUVCoords |              // convert spherical/box/etc mappings
+    aiProcess_TransformUVCoords |        // preprocess UV transformations
+    aiProcess_OptimizeMeshes |           // join small meshes
+    aiProcess_ImproveCacheLocality;      // reorder for the vertex cache
+
+static constexpr uint32_t FULL_PROFILE_STEPS =
+    BALANCED_PROFILE_STEPS |          //
+    aiProcess_ValidateDataStructure | // full validation of the imported data
+    aiProcess_FindInstances |         // remove duplicate meshes
+    aiProcess_LimitBoneWeights |      // at most 4 bone weights per vertex
+    aiProcess_SplitByBoneCount |      // split meshes with too many bones
+    aiProcess_SplitLargeMeshes;       // split meshes above the size limits
+
+struct post_process_step {
+  uint32_t    flag;
+  const char* name;
+
+  ///< aiProcess_SplitLargeMeshes is two steps in Assimp, a split by
+  ///< triangle count and a split by vertex count. Each of the two entries
+  ///< names the limit of the other one, disabled while it runs.
+  const char* disabled_limit{nullptr};
+};
+
+///
+/// Value of the SplitLargeMeshes limits that disables the split.
+static constexpr int32_t SLM_NO_LIMIT = -1;
+
+///
+/// Steps in the order Assimp itself runs them when they are all passed to
+/// the import function. Like Assimp, meshes are split by triangle count
+/// early and by vertex count only after JoinIdenticalVertices, so that the
+/// vertex counts are those of the indexed meshes.
+static constexpr post_process_step POST_PROCESS_STEPS[] = {
+    {aiProcess_ValidateDataStructure, "ValidateDataStructure"},
+    {aiProcess_MakeLeftHanded, "MakeLeftHanded"},
+    {aiProcess_FlipUVs, "FlipUVs"},
+    {aiProcess_FlipWindingOrder, "FlipWindingOrder"},
+    {aiProcess_RemoveRedundantMaterials, "RemoveRedundantMaterials"},
+    {aiProcess_FindInstances, "FindInstances"},
+    {aiProcess_OptimizeGraph, "OptimizeGraph"},
+    {aiProcess_OptimizeMeshes, "OptimizeMeshes"},
+    {aiProcess_FindDegenerates, "FindDegenerates"},
+    {aiProcess_GenUVCoords, "GenUVCoords"},
+    {aiProcess_TransformUVCoords, "TransformUVCoords"},
+    {aiProcess_PreTransformVertices, "PreTransformVertices"},
+    {aiProcess_Triangulate, "Triangulate"},
+    {aiProcess_SortByPType, "SortByPType"},
+    {aiProcess_FindInvalidData, "FindInvalidData"},
+    {aiProcess_FixInfacingNormals, "FixInfacingNormals"},
+    {aiProcess_SplitByBoneCount, "SplitByBoneCount"},
+    {aiProcess_SplitLargeMeshes, "SplitLargeMeshes_Triangle",
+     AI_CONFIG_PP_SLM_VERTEX_LIMIT},
+    {aiProcess_GenNormals, "GenNormals"},
+    {aiProcess_GenSmoothNormals, "GenSmoothNormals"},
+    {aiProcess_CalcTangentSpace, "CalcTangentSpace"},
+    {aiProcess_JoinIdenticalVertices, "JoinIdenticalVertices"},
+    {aiProcess_SplitLargeMeshes, "SplitLargeMeshes_Vertex",
+     AI_CONFIG_PP_SLM_TRIANGLE_LIMIT},
+    {aiProcess_Debone, "Debone"},
+    {aiProcess_LimitBoneWeights, "LimitBoneWeights"},
+    {aiProcess_ImproveCacheLocality, "ImproveCacheLocality"}};
+
+bool xray::rendering::parse_mesh_import_profile(
+    const char* name, mesh_import_profile* profile) noexcept {
+  assert(name != nullptr);
+  assert(profile != nullptr);
+
+  for (size_t i = 0; i < XR_COUNTOF__(PROFILE_NAMES); ++i) {
+    if (strcmp(name, PROFILE_NAMES[i]) == 0) {
+      *profile = static_cast<mesh_import_profile>(i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+const char* xray::rendering::mesh_import_profile_name(
+    const mesh_import_profile profile) noexcept {
+  assert(static_cast<size_t>(profile) < XR_COUNTOF__(PROFILE_NAMES));
+  return PROFILE_NAMES[static_cast<size_t>(profile)];
+}
+
+mesh_import_profile xray::rendering::default_mesh_import_profile() noexcept {
+  const auto cfg = app_config::instance();
+  if (!cfg || !*cfg->mesh_import_profile())
+    return mesh_import_profile::full;
+
+  mesh_import_profile profile{mesh_import_profile::full};
+  if (!parse_mesh_import_profile(cfg->mesh_import_profile(), &profile)) {
+    XR_LOG_ERR("Unknown mesh import profile {}, using full",
+               cfg->mesh_import_profile());
+  }
+
+  return profile;
+}
+
+uint32_t xray::rendering::mesh_import_profile_steps(
+    const mesh_import_profile profile) noexcept {
+  switch (profile) {
+  case mesh_import_profile::fast:
+    return FAST_PROFILE_STEPS;
+    break;
+
+  case mesh_import_profile::balanced:
+    return BALANCED_PROFILE_STEPS;
+    break;
+
+  default:
+    break;
+  }
+
+  return FULL_PROFILE_STEPS;
+}
+
+const aiScene* xray::rendering::import_scene_timed(
+    const void* model_data, const size_t data_size,
+    const uint32_t post_process_steps, const mesh_import_property* import_props,
+    const size_t props_count, const char* asset_name) {
+  assert(asset_name != nullptr);
+  assert(import_props != nullptr || props_count == 0);
+
+  //
+  //  The scene keeps a pointer to the importer that read it, aiReleaseImport()
+  //  deletes the importer and the scene with it. The C interface can not
+  //  change properties after reading, which the two SplitLargeMeshes passes
+  //  need.
+  auto importer = new Assimp::Importer{};
+
+  int32_t triangle_limit{AI_SLM_DEFAULT_MAX_TRIANGLES};
+  int32_t vertex_limit{AI_SLM_DEFAULT_MAX_VERTICES};
+
+  for (size_t i = 0; i < props_count; ++i) {
+    const auto& prop = import_props[i];
+    importer->SetPropertyInteger(prop.name, prop.value);
+
+    if (strcmp(prop.name, AI_CONFIG_PP_SLM_TRIANGLE_LIMIT) == 0)
+      triangle_limit = prop.value;
+    else if (strcmp(prop.name, AI_CONFIG_PP_SLM_VERTEX_LIMIT) == 0)
+      vertex_limit = prop.value;
+  }
+
+  timer_highp step_timer;
+  double      total_ms{};
+
+  step_timer.start();
+  auto scene = importer->ReadFileFromMemory(model_data, data_size, 0);
+  step_timer.end();
+
+  if (!scene) {
+    XR_LOG_ERR("Assimp import error ({}) : {}", asset_name,
+               importer->GetErrorString());
+    delete importer;
+    return nullptr;
+  }
+
+  total_ms += step_timer.elapsed_millis();
+  XR_LOG_INFO("Import {} : read {:.3f} ms", asset_name,
+              step_timer.elapsed_millis());
+
+  //
+  //  Applied one by one, in Assimp's own order, to time each of them. A
+  //  failed step releases the scene.
+  for (const auto& step : POST_PROCESS_STEPS) {
+    if (!(post_process_steps & step.flag))
+      continue;
+
+    if (step.disabled_limit) {
+      importer->SetPropertyInteger(AI_CONFIG_PP_SLM_TRIANGLE_LIMIT,
+                                   triangle_limit);
+      importer->SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT,
+                                   vertex_limit);
+      importer->SetPropertyInteger(step.disabled_limit, SLM_NO_LIMIT);
+    }
+
+    step_timer.start();
+    scene = importer->ApplyPostProcessing(step.flag);
+    step_timer.end();
+
+    if (!scene) {
+      XR_LOG_ERR("Import {} : post-processing step {} failed : {}",
+                 asset_name, step.name, importer->GetErrorString());
+      delete importer;
+      return nullptr;
+    }
+
+    total_ms += step_timer.elapsed_millis();
+    XR_LOG_INFO("Import {} : {} {:.3f} ms", asset_name, step.name,
+                step_timer.elapsed_millis());
+  }
+
+  XR_LOG_INFO("Import {} : Assimp total {:.3f} ms", asset_name, total_ms);
+  return scene;
+}
@@ -7,10 +7,12 @@
 #include "xray/math/scalar2.hpp"
 #include "xray/rendering/opengl/gl_handles.hpp"
 #include "xray/rendering/opengl/scoped_resource_mapping.hpp"
+#include "xray/rendering/opengl/uniform_ring_buffer.hpp"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <gsl.h>
+#include <limits>
 #include <numeric>
 #include <span.h>
 #include <stlsoft/memory/auto_buffer.hpp>
@@ -350,8 +352,9 @@ static uint32_t get_resource_size(const uint32_t res_type) noexcept {
   return 0;
 }
 
-GLuint xray::rendering::make_gpu_program(const GLuint* shaders_to_attach,
-                                         const size_t  shaders_count) noexcept {
+GLuint xray::rendering::make_gpu_program(
+    const GLuint* shaders_to_attach, const size_t shaders_count,
+    const bool retrievable_binary /* = false */) noexcept {
   scoped_program_handle tmp_handle{gl::CreateProgram()};
   if (!tmp_handle)
     return 0;
@@ -370,6 +373,11 @@ GLuint xray::rendering::make_gpu_program(const GLuint* shaders_to_attach,
     gl::AttachShader(raw_handle(tmp_handle), shaders_to_attach[idx]);
   }
 
+  if (retrievable_binary) {
+    gl::ProgramParameteri(raw_handle(tmp_handle),
+                          gl::PROGRAM_BINARY_RETRIEVABLE_HINT, gl::TRUE_);
+  }
+
   gl::LinkProgram(raw_handle(tmp_handle));
 
   //
@@ -410,6 +418,19 @@ xray::rendering::gpu_program::gpu_program(const GLuint* shaders_to_attach,
   valid_ = reflect();
 }
 
+xray::rendering::gpu_program::gpu_program(
+    const GLuint linked_program, const void* reflection_data,
+    const size_t reflection_bytes) noexcept
+    : prog_handle_{linked_program} {
+  if (!prog_handle_)
+    return;
+
+  if (reflection_data && load_reflection(reflection_data, reflection_bytes))
+    return;
+
+  valid_ = reflect();
+}
+
 bool xray::rendering::gpu_program::reflect() {
   assert(prog_handle_ && "Oops");
   assert(uniform_blocks_.empty());
@@ -422,37 +443,223 @@ bool xray::rendering::gpu_program::reflect() {
   if (!collect_uniforms())
     return false;
 
+  if (!share_uniform_blocks())
+    return false;
+
   if (!collect_subroutines_and_uniforms())
     return false;
 
+  hash_uniform_names();
+  return true;
+}
+
+static xray::rendering::uniform_upload_stats s_upload_stats{};
+
+xray::rendering::uniform_upload_stats
+xray::rendering::gpu_program::upload_stats() noexcept {
+  return s_upload_stats;
+}
+
+void xray::rendering::gpu_program::reset_upload_stats() noexcept {
+  s_upload_stats = uniform_upload_stats{};
+}
+
+struct xray::rendering::gpu_program::shared_block_registry_t {
+  ///< Binding point of each block name declared as shared.
+  std::unordered_map<std::string, uint32_t> declared;
+
+  ///< Shared blocks, owned by the programs that use them, so that buffers
+  ///< are released with the last program.
+  std::vector<std::weak_ptr<shared_uniform_block_t>> blocks;
+};
+
+xray::rendering::gpu_program::shared_block_registry_t&
+xray::rendering::gpu_program::shared_block_registry() {
+  static shared_block_registry_t registry{};
+  return registry;
+}
+
+void xray::rendering::gpu_program::share_uniform_block(
+    const char* block_name, const uint32_t bindpoint) {
+  assert(block_name != nullptr);
+  shared_block_registry().declared[block_name] = bindpoint;
+}
+
+void xray::rendering::gpu_program::dirty_ranges_t::add(
+    uint32_t first, uint32_t last) noexcept {
+  assert(first < last);
+
+  //
+  //  Absorb every range that overlaps or is close to [first, last). Merging
+  //  can bring the new range close to others, so repeat until nothing
+  //  changes.
+  for (bool merged = true; merged;) {
+    merged = false;
+
+    for (uint32_t i = 0; i < count; ++i) {
+      const auto& r = ranges[i];
+      if (first > r.last + merge_gap || r.first > last + merge_gap)
+        continue;
+
+      first     = std::min(first, r.first);
+      last      = std::max(last, r.last);
+      ranges[i] = ranges[--count];
+      merged    = true;
+      break;
+    }
+  }
+
+  if (count < max_ranges) {
+    ranges[count++] = {first, last};
+    return;
+  }
+
+  //
+  //  No free slot, grow the range that is closest to the new one.
+  uint32_t closest{0};
+  uint32_t min_gap{std::numeric_limits<uint32_t>::max()};
+
+  for (uint32_t i = 0; i < count; ++i) {
+    const auto gap = ranges[i].first > last ? ranges[i].first - last
+                                            : first - ranges[i].last;
+    if (gap < min_gap) {
+      min_gap = gap;
+      closest = i;
+    }
+  }
+
+  const auto r = ranges[closest];
+  ranges[closest] = ranges[--count];
+  add(std::min(first, r.first), std::max(last, r.last));
+}
+
+void xray::rendering::gpu_program::write_block_data(
+    uniform_block_t* block, const uint32_t offset, const void* data,
+    const size_t byte_count) noexcept {
+  assert((offset + byte_count) <= block->size);
+
+  const auto shared = block->shared.get();
+  auto       dst    = shared ? base::raw_ptr(shared->store)
+                             : base::raw_ptr(ublocks_datastore_) +
+                                   block->store_offset;
+  auto       dirty  = shared ? &shared->dirty : &block->dirty;
+  const auto src    = static_cast<const uint8_t*>(data);
+
+  //
+  //  Only the bytes that actually change need to reach the GPU. Setting the
+  //  same value every frame (projection matrices, light parameters) then
+  //  costs a compare and no upload.
+  size_t first = 0;
+  while (first < byte_count && dst[offset + first] == src[first])
+    ++first;
+
+  if (first == byte_count)
+    return;
+
+  size_t last = byte_count;
+  while (dst[offset + last - 1] == src[last - 1])
+    --last;
+
+  memcpy(dst + offset + first, src + first, last - first);
+  block->ring_stale = true;
+  dirty->add(static_cast<uint32_t>(offset + first),
+             static_cast<uint32_t>(offset + last));
+}
+
+bool xray::rendering::gpu_program::upload_dirty_ranges(
+    const GLuint buffer, const uint8_t* src, const uint32_t size,
+    dirty_ranges_t* dirty) noexcept {
+  for (uint32_t i = 0; i < dirty->count; ++i) {
+    const auto rng       = dirty->ranges[i];
+    const auto whole_blk = rng.first == 0 && rng.last == size;
+    const auto access    = static_cast<uint32_t>(
+        gl::MAP_WRITE_BIT | (whole_blk ? gl::MAP_INVALIDATE_BUFFER_BIT
+                                       : gl::MAP_INVALIDATE_RANGE_BIT));
+
+    scoped_resource_mapping ubuff_mapping{buffer, access, rng.last - rng.first,
+                                          rng.first};
+
+    if (!ubuff_mapping)
+      return false;
+
+    memcpy(ubuff_mapping.memory(), src + rng.first, rng.last - rng.first);
+
+    s_upload_stats.bytes_uploaded += rng.last - rng.first;
+    ++s_upload_stats.ranges_uploaded;
+  }
+
+  s_upload_stats.dirty_block_bytes += size;
+  dirty->clear();
   return true;
 }
 
-void xray::rendering::gpu_program::bind_to_pipeline() {
+void xray::rendering::gpu_program::bind_to_pipeline(
+    uniform_ring_buffer* ring) {
   assert(valid());
+  assert(!ring || ring->valid());
 
   using namespace std;
   using namespace xray::base;
 
-  //
-  // writa data for blocks marked as dirty
-  for_each(begin(uniform_blocks_), end(uniform_blocks_), [this](auto& u_blk) {
-    if (u_blk.dirty) {
-
-      auto src_ptr = raw_ptr(ublocks_datastore_) + u_blk.store_offset;
+  for_each(begin(uniform_blocks_), end(uniform_blocks_), [this,
+                                                          ring](auto& u_blk) {
+    //
+    // shared blocks have their own buffer, uploaded by whichever program
+    // binds them first after a change
+    if (u_blk.shared) {
+      auto shared = u_blk.shared.get();
+
+      if (!shared->dirty.empty() &&
+          !upload_dirty_ranges(raw_handle(shared->gl_buff),
+                               raw_ptr(shared->store), shared->size,
+                               &shared->dirty))
+        return;
+
+      gl::BindBufferBase(gl::UNIFORM_BUFFER, shared->bindpoint,
+                         raw_handle(shared->gl_buff));
+      return;
+    }
 
-      {
-        scoped_resource_mapping ubuff_mapping{raw_handle(u_blk.gl_buff),
-                                              gl::MAP_WRITE_BIT, u_blk.size};
+    auto src_ptr = raw_ptr(ublocks_datastore_) + u_blk.store_offset;
 
-        if (!ubuff_mapping)
-          return;
+    //
+    // copy the block into the ring, unless this frame already has an up to
+    // date copy of it
+    if (ring) {
+      auto has_copy = !u_blk.ring_stale && u_blk.ring == ring &&
+                      u_blk.ring_frame == ring->frame_id();
+
+      if (!has_copy) {
+        const auto ring_mem = ring->allocate(u_blk.size);
+        if (ring_mem) {
+          memcpy(ring_mem.memory, src_ptr, u_blk.size);
+
+          u_blk.ring        = ring;
+          u_blk.ring_frame  = ring->frame_id();
+          u_blk.ring_offset = ring_mem.offset;
+          u_blk.ring_stale  = false;
+          has_copy          = true;
+
+          s_upload_stats.bytes_uploaded += u_blk.size;
+          s_upload_stats.dirty_block_bytes += u_blk.size;
+          ++s_upload_stats.ranges_uploaded;
+        }
+      }
 
-        memcpy(ubuff_mapping.memory(), src_ptr, u_blk.size);
+      if (has_copy) {
+        gl::BindBufferRange(gl::UNIFORM_BUFFER, u_blk.bindpoint,
+                            ring->handle(), u_blk.ring_offset, u_blk.size);
+        return;
       }
-      u_blk.dirty = false;
     }
 
+    //
+    // write the modified ranges of the block to its own buffer
+    if (!u_blk.dirty.empty() &&
+        !upload_dirty_ranges(raw_handle(u_blk.gl_buff), src_ptr, u_blk.size,
+                             &u_blk.dirty))
+      return;
+
     gl::BindBuffer(gl::UNIFORM_BUFFER, raw_handle(u_blk.gl_buff));
     gl::BindBufferBase(gl::UNIFORM_BUFFER, u_blk.bindpoint,
                        raw_handle(u_blk.gl_buff));
@@ -584,34 +791,65 @@ bool xray::rendering::gpu_program::collect_uniform_blocks() {
                        static_cast<uint32_t>(u_props.ub_bindpoint)});
   }
 
+  return create_uniform_block_storage(std::move(ublocks));
+}
+
+bool xray::rendering::gpu_program::create_uniform_block_storage(
+    std::vector<uniform_block_t> ublocks) {
+  using namespace xray::base;
+  using namespace std;
+
   //
   // compute number of required bytes for blocks and allocate storage.
+  // Blocks declared as shared get no storage and no buffer of their own,
+  // share_uniform_blocks() attaches them to the shared ones.
   {
+    const auto& shared_decls = shared_block_registry().declared;
+    const auto  is_shared    = [&shared_decls](const auto& blk) {
+      return shared_decls.find(blk.name) != shared_decls.end();
+    };
+
     uint32_t ublock_store_bytes_req{};
     for (auto itr_c = begin(ublocks), itr_end = end(ublocks); itr_c != itr_end;
          ++itr_c) {
+      if (is_shared(*itr_c))
+        continue;
+
       itr_c->store_offset = ublock_store_bytes_req;
       ublock_store_bytes_req += itr_c->size;
     }
 
-    unique_pointer<uint8_t[]> store{new uint8_t[ublock_store_bytes_req]};
+    //
+    // zero filled, so that write_block_data() has defined contents to compare
+    // against; every block is marked dirty so that the first bind uploads it
+    // entirely.
+    unique_pointer<uint8_t[]> store{new uint8_t[ublock_store_bytes_req]()};
+    for_each(begin(ublocks), end(ublocks),
+             [](auto& blk) { blk.dirty.add(0, blk.size); });
 
     //
     // create uniform buffers for active blocks
     constexpr auto kBufferCreateFlags = gl::MAP_WRITE_BIT
         /*| gl::MAP_READ_BIT */;
-    for_each(begin(ublocks), end(ublocks), [kBufferCreateFlags](auto& blk) {
-      gl::CreateBuffers(1, raw_handle_ptr(blk.gl_buff));
-      gl::NamedBufferStorage(raw_handle(blk.gl_buff), blk.size, nullptr,
-                             kBufferCreateFlags);
-      //      blk.gl_buff =
-      // make_buffer(gl::UNIFORM_BUFFER, kBufferCreateFlags, blk.size);
-    });
+    for_each(begin(ublocks), end(ublocks),
+             [kBufferCreateFlags, &is_shared](auto& blk) {
+               if (is_shared(blk))
+                 return;
+
+               gl::CreateBuffers(1, raw_handle_ptr(blk.gl_buff));
+               gl::NamedBufferStorage(raw_handle(blk.gl_buff), blk.size,
+                                      nullptr, kBufferCreateFlags);
+               //      blk.gl_buff =
+               // make_buffer(gl::UNIFORM_BUFFER, kBufferCreateFlags,
+               // blk.size);
+             });
 
     //
     // abort if creation of any buffer failed.
-    const auto any_fails = any_of(begin(ublocks), end(ublocks),
-                                  [](const auto& blk) { return !blk.gl_buff; });
+    const auto any_fails =
+        any_of(begin(ublocks), end(ublocks), [&is_shared](const auto& blk) {
+          return !blk.gl_buff && !is_shared(blk);
+        });
 
     if (any_fails) {
       OUTPUT_DBG_MSG("Failed to create buffers for uniform blocks");
@@ -908,32 +1146,496 @@ bool xray::rendering::gpu_program::collect_subroutines_and_uniforms() {
   return true;
 }
 
-void xray::rendering::gpu_program::set_uniform_block(const char*  block_name,
-                                                     const void*  block_data,
-                                                     const size_t byte_count) {
+void xray::rendering::gpu_program::hash_uniform_names() {
+  using namespace std;
+
+  const auto hash_names = [](const auto& items, vector<name_hash_t>* hashes,
+                             const char* kind) {
+    hashes->clear();
+    for (uint32_t idx = 0; idx < static_cast<uint32_t>(items.size()); ++idx)
+      hashes->push_back({FNV::fnv1a(items[idx].name), idx});
+
+    sort(begin(*hashes), end(*hashes),
+         [](const name_hash_t& lhs, const name_hash_t& rhs) {
+           return lhs.hash < rhs.hash;
+         });
+
+    //
+    //  Lookups by hash would return either one, names that collide can only
+    //  be used with the string functions.
+    for (size_t idx = 1; idx < hashes->size(); ++idx) {
+      if ((*hashes)[idx - 1].hash == (*hashes)[idx].hash) {
+        XR_LOG_ERR("{} {} and {} have the same name hash", kind,
+                   items[(*hashes)[idx - 1].index].name,
+                   items[(*hashes)[idx].index].name);
+      }
+    }
+  };
+
+  hash_names(uniform_blocks_, &uniform_block_hashes_, "Uniform blocks");
+  hash_names(uniforms_, &uniform_hashes_, "Uniforms");
+}
+
+uint32_t xray::rendering::gpu_program::uniform_block_layout_hash(
+    const uint32_t blk_idx) const noexcept {
+  auto hash = FNV::fnv1a(uniform_blocks_[blk_idx].size);
+
+  //
+  //  uniforms_ is sorted by name, members are visited in the same order in
+  //  every program.
+  for (const auto& u : uniforms_) {
+    if (u.parent_block_idx != static_cast<int32_t>(blk_idx))
+      continue;
+
+    hash = FNV::fnv1a(u.name, hash);
+    hash = FNV::fnv1a(u.block_store_offset, hash);
+    hash = FNV::fnv1a(u.type, hash);
+    hash = FNV::fnv1a(u.array_dim, hash);
+    hash = FNV::fnv1a(u.stride, hash);
+  }
+
+  return hash;
+}
+
+bool xray::rendering::gpu_program::share_uniform_blocks() {
+  using namespace std;
+  using namespace xray::base;
+
+  auto& registry = shared_block_registry();
+  if (registry.declared.empty())
+    return true;
+
+  registry.blocks.erase(
+      remove_if(begin(registry.blocks), end(registry.blocks),
+                [](const auto& blk) { return blk.expired(); }),
+      end(registry.blocks));
+
+  for (uint32_t blk_idx = 0;
+       blk_idx < static_cast<uint32_t>(uniform_blocks_.size()); ++blk_idx) {
+    auto&      u_blk = uniform_blocks_[blk_idx];
+    const auto decl  = registry.declared.find(u_blk.name);
+
+    if (decl == end(registry.declared))
+      continue;
+
+    //
+    // The shared buffer would replace the one of any other block of the
+    // program bound at the same point (a block declared in the shader at
+    // that point, or another shared block).
+    const auto conflict = find_if(
+        begin(uniform_blocks_), end(uniform_blocks_),
+        [&u_blk, &registry, bindpoint = decl->second](const auto& blk) {
+          if (&blk == &u_blk)
+            return false;
+
+          const auto blk_decl = registry.declared.find(blk.name);
+          return (blk_decl == end(registry.declared)
+                      ? blk.bindpoint
+                      : blk_decl->second) == bindpoint;
+        });
+
+    if (conflict != end(uniform_blocks_)) {
+      XR_LOG_ERR("Shared uniform block {} : binding point {} is already used "
+                 "by block {}",
+                 u_blk.name, decl->second, conflict->name);
+      return false;
+    }
+
+    const auto layout_hash = uniform_block_layout_hash(blk_idx);
+
+    shared_ptr<shared_uniform_block_t> shared;
+    for (const auto& weak_blk : registry.blocks) {
+      auto blk = weak_blk.lock();
+      if (blk && blk->name == u_blk.name && blk->layout_hash == layout_hash) {
+        shared = std::move(blk);
+        break;
+      }
+    }
+
+    if (!shared) {
+      shared              = make_shared<shared_uniform_block_t>();
+      shared->name        = u_blk.name;
+      shared->layout_hash = layout_hash;
+      shared->size        = u_blk.size;
+      shared->bindpoint   = decl->second;
+      shared->store = unique_pointer<uint8_t[]>{new uint8_t[u_blk.size]()};
+      shared->dirty.add(0, u_blk.size);
+
+      gl::CreateBuffers(1, raw_handle_ptr(shared->gl_buff));
+      if (!shared->gl_buff) {
+        XR_LOG_ERR("Failed to create buffer for shared uniform block {}",
+                   u_blk.name);
+        return false;
+      }
+
+      gl::NamedBufferStorage(raw_handle(shared->gl_buff), u_blk.size, nullptr,
+                             gl::MAP_WRITE_BIT);
+      registry.blocks.push_back(shared);
+
+      XR_LOG_INFO("Shared uniform block {} (layout {:#x}), size {}, binding "
+                  "point {}",
+                  u_blk.name, layout_hash, u_blk.size, decl->second);
+    }
+
+    //
+    // u_blk.bindpoint keeps the binding declared in the shader, it describes
+    // the program and not the registry; bind_to_pipeline() binds shared
+    // blocks at shared->bindpoint.
+    gl::UniformBlockBinding(raw_handle(prog_handle_), u_blk.index,
+                            shared->bindpoint);
+    u_blk.shared = std::move(shared);
+  }
+
+  return true;
+}
+
+//
+//  Reflection data : the uniform blocks, uniforms, subroutine uniforms and
+//  subroutines, each list as a count followed by the items, then the per
+//  stage subroutine data. Numbers are 32 bit values in native byte order,
+//  strings a length followed by the characters. The data is only read back
+//  on the machine that wrote it.
+struct reflection_writer {
+  std::vector<uint8_t>* blob;
+
+  void put(const uint32_t value) {
+    const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+    blob->insert(blob->end(), bytes, bytes + sizeof(value));
+  }
+
+  void put(const std::string& str) {
+    put(static_cast<uint32_t>(str.size()));
+    blob->insert(blob->end(), str.begin(), str.end());
+  }
+};
+
+struct reflection_reader {
+  const uint8_t* pos;
+  const uint8_t* last;
+  bool           ok;
+
+  uint32_t get_u32() {
+    uint32_t value{0};
+    if (static_cast<size_t>(last - pos) < sizeof(value)) {
+      ok = false;
+      return 0;
+    }
+
+    memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+  }
+
+  std::string get_str() {
+    const auto len = get_u32();
+    if (!ok || static_cast<size_t>(last - pos) < len) {
+      ok = false;
+      return {};
+    }
+
+    std::string str{reinterpret_cast<const char*>(pos), len};
+    pos += len;
+    return str;
+  }
+
+  //
+  //  Rejects counts that the remaining bytes cannot hold, so that damaged
+  //  data does not turn into huge allocations.
+  uint32_t get_count(const size_t min_item_bytes) {
+    const auto count = get_u32();
+    if (!ok || count > static_cast<size_t>(last - pos) / min_item_bytes) {
+      ok = false;
+      return 0;
+    }
+
+    return count;
+  }
+};
+
+void xray::rendering::gpu_program::save_reflection(
+    std::vector<uint8_t>* blob) const {
   assert(valid());
-  assert(block_name != nullptr);
-  assert(block_data != nullptr);
+  assert(blob != nullptr);
+
+  reflection_writer wr{blob};
+
+  wr.put(static_cast<uint32_t>(uniform_blocks_.size()));
+  for (const auto& blk : uniform_blocks_) {
+    wr.put(blk.name);
+    wr.put(blk.size);
+    wr.put(blk.index);
+    wr.put(blk.bindpoint);
+  }
+
+  wr.put(static_cast<uint32_t>(uniforms_.size()));
+  for (const auto& u : uniforms_) {
+    wr.put(u.name);
+    wr.put(u.byte_size);
+    wr.put(u.block_store_offset);
+    wr.put(static_cast<uint32_t>(u.parent_block_idx));
+    wr.put(u.type);
+    wr.put(u.array_dim);
+    wr.put(u.location);
+    wr.put(u.stride);
+  }
+
+  wr.put(static_cast<uint32_t>(subroutine_uniforms_.size()));
+  for (const auto& su : subroutine_uniforms_) {
+    wr.put(su.ssu_name);
+    wr.put(su.ssu_stage);
+    wr.put(su.ssu_location);
+    wr.put(su.ssu_assigned_subroutine_idx);
+  }
+
+  wr.put(static_cast<uint32_t>(subroutines_.size()));
+  for (const auto& ss : subroutines_) {
+    wr.put(ss.ss_name);
+    wr.put(ss.ss_stage);
+    wr.put(ss.ss_index);
+  }
+
+  for (const auto& stage : stage_subroutine_ufs_) {
+    wr.put(stage.datastore_offset);
+    wr.put(stage.uniforms_count);
+    wr.put(stage.max_active_locations);
+  }
+}
+
+bool xray::rendering::gpu_program::load_reflection(const void*  data,
+                                                   const size_t bytes) {
+  assert(prog_handle_);
+  assert(uniform_blocks_.empty());
+  assert(uniforms_.empty());
+  assert(data != nullptr);
 
   using namespace std;
   using namespace xray::base;
 
-  auto blk_iter =
-      find_if(begin(uniform_blocks_), end(uniform_blocks_),
-              [block_name](auto& blk) { return blk.name == block_name; });
+  const auto        first = static_cast<const uint8_t*>(data);
+  reflection_reader rd{first, first + bytes, true};
+
+  vector<uniform_block_t> ublocks(rd.get_count(4 * sizeof(uint32_t)));
+  for (auto& blk : ublocks) {
+    blk.name      = rd.get_str();
+    blk.size      = rd.get_u32();
+    blk.index     = rd.get_u32();
+    blk.bindpoint = rd.get_u32();
+  }
+
+  vector<uniform_t> uniforms(rd.get_count(8 * sizeof(uint32_t)));
+  for (auto& u : uniforms) {
+    u.name               = rd.get_str();
+    u.byte_size          = rd.get_u32();
+    u.block_store_offset = rd.get_u32();
+    u.parent_block_idx   = static_cast<int32_t>(rd.get_u32());
+    u.type               = rd.get_u32();
+    u.array_dim          = rd.get_u32();
+    u.location           = rd.get_u32();
+    u.stride             = rd.get_u32();
+  }
+
+  vector<shader_subroutine_uniform> sub_uniforms(
+      rd.get_count(4 * sizeof(uint32_t)));
+  for (auto& su : sub_uniforms) {
+    su.ssu_name  = rd.get_str();
+    su.ssu_stage = static_cast<pipeline_stage>(
+        std::min(rd.get_u32(), uint32_t{pipeline_stage::last}));
+    su.ssu_location                = static_cast<uint8_t>(rd.get_u32());
+    su.ssu_assigned_subroutine_idx = static_cast<uint8_t>(rd.get_u32());
+  }
+
+  vector<shader_subroutine> subroutines(rd.get_count(3 * sizeof(uint32_t)));
+  for (auto& ss : subroutines) {
+    ss.ss_name  = rd.get_str();
+    ss.ss_stage = static_cast<pipeline_stage>(
+        std::min(rd.get_u32(), uint32_t{pipeline_stage::last}));
+    ss.ss_index = static_cast<uint8_t>(rd.get_u32());
+  }
+
+  pipeline_stage_subroutine_uniform_data stages[pipeline_stage::last];
+  for (auto& stage : stages) {
+    stage.datastore_offset     = static_cast<uint8_t>(rd.get_u32());
+    stage.uniforms_count       = static_cast<uint8_t>(rd.get_u32());
+    stage.max_active_locations = static_cast<uint8_t>(rd.get_u32());
+  }
+
+  //
+  //  Lookups expect the lists sorted by name, uniforms must fit in their
+  //  blocks and subroutine uniforms within their stage's locations.
+  const auto by_name = [](const auto& lhs, const auto& rhs) {
+    return lhs.name < rhs.name;
+  };
+
+  bool valid = rd.ok && rd.pos == rd.last &&
+               is_sorted(begin(ublocks), end(ublocks), by_name) &&
+               is_sorted(begin(uniforms), end(uniforms), by_name);
+
+  for (const auto& u : uniforms) {
+    if (u.parent_block_idx == -1)
+      continue;
+
+    valid = valid && u.parent_block_idx >= 0 &&
+            static_cast<size_t>(u.parent_block_idx) < ublocks.size() &&
+            u.block_store_offset + u.byte_size <=
+                ublocks[u.parent_block_idx].size;
+  }
+
+  for (const auto& su : sub_uniforms)
+    valid = valid && su.ssu_stage != pipeline_stage::last;
+
+  for (const auto& ss : subroutines)
+    valid = valid && ss.ss_stage != pipeline_stage::last;
+
+  for (const auto& stage : stages) {
+    if (stage.datastore_offset ==
+        pipeline_stage_subroutine_uniform_data::invalid_offset)
+      continue;
+
+    valid = valid && size_t{stage.datastore_offset} + stage.uniforms_count <=
+                         sub_uniforms.size();
+
+    for (uint32_t idx = 0; valid && idx < stage.uniforms_count; ++idx) {
+      valid = sub_uniforms[stage.datastore_offset + idx].ssu_location <
+              stage.max_active_locations;
+    }
+  }
+
+  if (!valid) {
+    XR_LOG_ERR("Malformed program reflection data, reflecting the program");
+    return false;
+  }
+
+  //
+  //  Bindings changed after linking may be stored in the binary, start
+  //  from the ones declared in the shaders.
+  for (const auto& blk : ublocks) {
+    gl::UniformBlockBinding(raw_handle(prog_handle_), blk.index,
+                            blk.bindpoint);
+  }
+
+  uniforms_            = std::move(uniforms);
+  subroutine_uniforms_ = std::move(sub_uniforms);
+  subroutines_         = std::move(subroutines);
+  copy(begin(stages), end(stages), begin(stage_subroutine_ufs_));
+
+  valid_ = create_uniform_block_storage(std::move(ublocks)) &&
+           share_uniform_blocks();
+
+  if (valid_)
+    hash_uniform_names();
+
+  return true;
+}
+
+//
+//  Returns the index stored for the hash, or 0xFFFFFFFF.
+template <typename name_hash_type>
+static uint32_t
+find_name_hash(const std::vector<name_hash_type>& hashes,
+               const xray::rendering::hashed_name name) noexcept {
+  const auto itr =
+      std::lower_bound(std::begin(hashes), std::end(hashes), name.value,
+                       [](const name_hash_type& entry, const uint32_t hash) {
+                         return entry.hash < hash;
+                       });
+
+  return itr != std::end(hashes) && itr->hash == name.value ? itr->index
+                                                            : 0xFFFFFFFFu;
+}
+
+//
+//  Uniforms and blocks are sorted by name, returns the index of the one
+//  named name or 0xFFFFFFFF.
+template <typename named_item_type>
+static uint32_t find_name(const std::vector<named_item_type>& items,
+                          const char*                         name) noexcept {
+  const auto itr = std::lower_bound(
+      std::begin(items), std::end(items), name,
+      [](const named_item_type& item, const char* item_name) {
+        return item.name < item_name;
+      });
+
+  return itr != std::end(items) && itr->name == name
+             ? static_cast<uint32_t>(itr - std::begin(items))
+             : 0xFFFFFFFFu;
+}
+
+xray::rendering::gpu_uniform_handle
+xray::rendering::gpu_program::uniform_handle(const char* uniform_name) const
+    noexcept {
+  assert(uniform_name != nullptr);
+  return gpu_uniform_handle{find_name(uniforms_, uniform_name)};
+}
+
+xray::rendering::gpu_uniform_handle
+xray::rendering::gpu_program::uniform_handle(
+    const hashed_name uniform_name) const noexcept {
+  return gpu_uniform_handle{find_name_hash(uniform_hashes_, uniform_name)};
+}
+
+xray::rendering::gpu_uniform_block_handle
+xray::rendering::gpu_program::uniform_block_handle(
+    const char* block_name) const noexcept {
+  assert(block_name != nullptr);
+  return gpu_uniform_block_handle{find_name(uniform_blocks_, block_name)};
+}
+
+xray::rendering::gpu_uniform_block_handle
+xray::rendering::gpu_program::uniform_block_handle(
+    const hashed_name block_name) const noexcept {
+  return gpu_uniform_block_handle{
+      find_name_hash(uniform_block_hashes_, block_name)};
+}
+
+void xray::rendering::gpu_program::set_uniform_block(const char*  block_name,
+                                                     const void*  block_data,
+                                                     const size_t byte_count) {
+  assert(valid());
+  assert(block_name != nullptr);
 
-  if (blk_iter == end(uniform_blocks_)) {
+  const auto block = uniform_block_handle(block_name);
+  if (!block.valid()) {
     XR_LOG_ERR("{} error, uniform {} does not exist", __PRETTY_FUNCTION__,
                block_name);
     return;
   }
 
-  assert(byte_count <= blk_iter->size);
+  set_uniform_block(block, block_data, byte_count);
+}
+
+void xray::rendering::gpu_program::set_uniform_block(
+    const hashed_name block_name, const void* block_data,
+    const size_t byte_count) {
+  assert(valid());
+
+  const auto block = uniform_block_handle(block_name);
+  if (!block.valid()) {
+    XR_LOG_ERR("{} error, uniform block with name hash {:#x} does not exist",
+               __PRETTY_FUNCTION__, block_name.value);
+    return;
+  }
+
+  set_uniform_block(block, block_data, byte_count);
+}
+
+void xray::rendering::gpu_program::set_uniform_block(
+    const gpu_uniform_block_handle block, const void* block_data,
+    const size_t byte_count) {
+  assert(valid());
+  assert(block_data != nullptr);
+
+  //
+  // Also catches invalid handles (missing names) in release builds.
+  if (block.index >= uniform_blocks_.size()) {
+    XR_LOG_ERR("{} error, invalid uniform block handle {:#x}",
+               __PRETTY_FUNCTION__, block.index);
+    return;
+  }
 
-  memcpy(raw_ptr(ublocks_datastore_) + blk_iter->store_offset, block_data,
-         byte_count);
+  auto& blk = uniform_blocks_[block.index];
+  assert(byte_count <= blk.size);
 
-  blk_iter->dirty = true;
+  write_block_data(&blk, 0, block_data, byte_count);
 }
 
 void xray::rendering::gpu_program::set_subroutine_uniform(
@@ -0,0 +1,279 @@
+#include "xray/rendering/opengl/program_binary_cache.hpp"
+#include "xray/base/app_config.hpp"
+#include "xray/base/array_dimension.hpp"
+#include "xray/base/basic_timer.hpp"
+#include "xray/base/file_io.hpp"
+#include "xray/base/fnv_hash.hpp"
+#include "xray/base/logger.hpp"
+#include "xray/rendering/opengl/shader_base.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace xray::base;
+using namespace xray::rendering;
+
+static constexpr uint32_t PROGRAM_CACHE_MAGIC   = 0x50475258; // "XRGP"
+static constexpr uint32_t PROGRAM_CACHE_VERSION = 2;
+
+//
+//  On disk layout : header, identity (see program_cache_identity()), program
+//  binary, reflection data written by gpu_program::save_reflection().
+struct program_cache_header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t identity_bytes;
+  uint32_t binary_format;
+  uint32_t binary_bytes;
+  uint32_t reflection_bytes;
+};
+
+static const char* driver_string(const GLenum name) {
+  const auto str = gl::GetString(name);
+  return str ? reinterpret_cast<const char*>(str) : "";
+}
+
+//
+//  Everything a cached binary depends on : type, path, size and 64 bit hash
+//  of each stage's source, the defines and the driver. Stored in the cache
+//  file and compared in full on load, the key (a hash of the identity) only
+//  names the file.
+static string program_cache_identity(const shader_source_file* stages,
+                                     const vector<string>&     sources,
+                                     const char*               defines) {
+  string identity;
+
+  for (size_t idx = 0; idx < sources.size(); ++idx) {
+    char stage_info[64];
+    snprintf(stage_info, sizeof(stage_info), "%08x %zu %016llx ",
+             stages[idx].shader_type, sources[idx].size(),
+             static_cast<unsigned long long>(FNV::fnv1a64(sources[idx])));
+
+    identity += stage_info;
+    identity += stages[idx].path;
+    identity += '\n';
+  }
+
+  identity += defines ? defines : "";
+  identity += '\n';
+
+  for (const auto name : {gl::VENDOR, gl::RENDERER, gl::VERSION}) {
+    identity += driver_string(name);
+    identity += '\n';
+  }
+
+  return identity;
+}
+
+static GLuint compile_stage(const uint32_t shader_type, const string& source,
+                            const char* defines) {
+  if (!defines || !*defines) {
+    const char* src = source.c_str();
+    return make_shader(shader_type, &src, 1);
+  }
+
+  //
+  //  #version must come before anything else, the defines go right after
+  //  it.
+  size_t split = 0;
+  if (source.compare(0, 8, "#version") == 0) {
+    split = source.find('\n');
+    split = split == string::npos ? source.size() : split + 1;
+  }
+
+  const string version_line{source, 0, split};
+  const char*  strings[] = {version_line.c_str(), defines, "\n",
+                           source.c_str() + split};
+
+  return make_shader(shader_type, strings, 4);
+}
+
+static GLuint load_cached_program(const char* cache_file, const uint64_t key,
+                                  const string& identity,
+                                  string*       reflection) {
+  string contents;
+  if (!read_file(cache_file, &contents))
+    return 0;
+
+  program_cache_header hdr;
+  if (contents.size() < sizeof(hdr))
+    return 0;
+
+  memcpy(&hdr, contents.data(), sizeof(hdr));
+
+  if (hdr.magic != PROGRAM_CACHE_MAGIC ||
+      hdr.version != PROGRAM_CACHE_VERSION || hdr.key != key ||
+      uint64_t{sizeof(hdr)} + hdr.identity_bytes + hdr.binary_bytes +
+              hdr.reflection_bytes !=
+          contents.size()) {
+    XR_LOG_INFO("Outdated or damaged program cache file {}", cache_file);
+    return 0;
+  }
+
+  //
+  //  A key collision must not hand another program's binary to the driver.
+  if (contents.compare(sizeof(hdr), hdr.identity_bytes, identity) != 0) {
+    XR_LOG_INFO("Program cache file {} belongs to another program",
+                cache_file);
+    return 0;
+  }
+
+  const auto binary_offset = sizeof(hdr) + hdr.identity_bytes;
+
+  scoped_program_handle program{gl::CreateProgram()};
+  if (!program)
+    return 0;
+
+  gl::ProgramBinary(raw_handle(program), hdr.binary_format,
+                    contents.data() + binary_offset,
+                    static_cast<GLsizei>(hdr.binary_bytes));
+
+  //
+  //  Drivers may reject binaries they produced themselves (e.g. after a
+  //  change in the hardware), this is a normal cache miss.
+  GLint link_status{gl::FALSE_};
+  gl::GetProgramiv(raw_handle(program), gl::LINK_STATUS, &link_status);
+
+  if (link_status != gl::TRUE_) {
+    XR_LOG_INFO("Program binary {} rejected by the driver", cache_file);
+    return 0;
+  }
+
+  reflection->assign(contents, binary_offset + hdr.binary_bytes,
+                     hdr.reflection_bytes);
+  return unique_handle_release(program);
+}
+
+static void write_cached_program(const char* cache_file, const uint64_t key,
+                                 const string&      identity,
+                                 const gpu_program& program) {
+  GLint binary_bytes{0};
+  gl::GetProgramiv(program.handle(), gl::PROGRAM_BINARY_LENGTH, &binary_bytes);
+
+  if (binary_bytes <= 0)
+    return;
+
+  //
+  //  Program binary followed by the reflection data.
+  vector<uint8_t> program_data(static_cast<size_t>(binary_bytes));
+
+  GLenum  binary_format{0};
+  GLsizei written{0};
+  gl::GetProgramBinary(program.handle(), binary_bytes, &written,
+                       &binary_format, program_data.data());
+
+  if (written <= 0) {
+    XR_LOG_ERR("Failed to retrieve program binary for {}", cache_file);
+    return;
+  }
+
+  program_data.resize(static_cast<size_t>(written));
+  program.save_reflection(&program_data);
+
+  program_cache_header hdr;
+  hdr.magic            = PROGRAM_CACHE_MAGIC;
+  hdr.version          = PROGRAM_CACHE_VERSION;
+  hdr.key              = key;
+  hdr.identity_bytes   = static_cast<uint32_t>(identity.size());
+  hdr.binary_format    = binary_format;
+  hdr.binary_bytes     = static_cast<uint32_t>(written);
+  hdr.reflection_bytes =
+      static_cast<uint32_t>(program_data.size() - static_cast<size_t>(written));
+
+  const file_write_chunk chunks[] = {
+      {&hdr, sizeof(hdr)},
+      {identity.data(), identity.size()},
+      {program_data.data(), program_data.size()}};
+
+  if (!atomic_write_file(cache_file, chunks, XR_COUNTOF__(chunks)))
+    XR_LOG_ERR("Failed to write program cache file {}", cache_file);
+}
+
+xray::rendering::gpu_program xray::rendering::make_cached_gpu_program(
+    const shader_source_file* stages, const size_t stages_count,
+    const char* defines /* = nullptr */) {
+  assert(stages != nullptr);
+
+  timer_highp build_timer;
+  build_timer.start();
+
+  vector<string> sources(stages_count);
+
+  for (size_t idx = 0; idx < stages_count; ++idx) {
+    if (!read_file(stages[idx].path, &sources[idx])) {
+      XR_LOG_ERR("Failed to read shader file {}", stages[idx].path);
+      return gpu_program{};
+    }
+  }
+
+  //
+  //  Without any binary format the driver can not return binaries that it
+  //  could load back.
+  GLint binary_formats{0};
+  gl::GetIntegerv(gl::NUM_PROGRAM_BINARY_FORMATS, &binary_formats);
+
+  const auto cfg       = app_config::instance();
+  const auto use_cache = cfg != nullptr && binary_formats > 0;
+  const auto identity  = program_cache_identity(stages, sources, defines);
+  const auto key       = FNV::fnv1a64(identity);
+
+  string cache_file;
+  if (use_cache) {
+    char file_name[32];
+    snprintf(file_name, sizeof(file_name), "%016llx.xprog",
+             static_cast<unsigned long long>(key));
+    cache_file = cfg->program_cache_path(file_name);
+
+    string     reflection;
+    const auto cached_program =
+        load_cached_program(cache_file.c_str(), key, identity, &reflection);
+
+    if (cached_program) {
+      gpu_program program{cached_program, reflection.data(),
+                          reflection.size()};
+
+      if (program) {
+        build_timer.end();
+        XR_LOG_INFO("Program {} loaded from cache in {} ms", stages[0].path,
+                    build_timer.elapsed_millis());
+        return program;
+      }
+    }
+  }
+
+  vector<scoped_shader_handle> shaders;
+  vector<GLuint>               shader_ids;
+  shaders.reserve(stages_count);
+
+  for (size_t idx = 0; idx < stages_count; ++idx) {
+    shaders.emplace_back(
+        compile_stage(stages[idx].shader_type, sources[idx], defines));
+
+    if (!shaders.back()) {
+      XR_LOG_ERR("Failed to compile shader {}", stages[idx].path);
+      return gpu_program{};
+    }
+
+    shader_ids.push_back(raw_handle(shaders.back()));
+  }
+
+  gpu_program program{
+      make_gpu_program(shader_ids.data(), shader_ids.size(), use_cache),
+      nullptr, 0};
+
+  if (!program)
+    return program;
+
+  if (use_cache)
+    write_cached_program(cache_file.c_str(), key, identity, program);
+
+  build_timer.end();
+  XR_LOG_INFO("Program {} built from source in {} ms", stages[0].path,
+              build_timer.elapsed_millis());
+
+  return program;
+}
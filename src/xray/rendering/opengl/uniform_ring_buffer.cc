@@ -0,0 +1,122 @@
+#include "xray/rendering/opengl/uniform_ring_buffer.hpp"
+#include "xray/base/logger.hpp"
+#include <cassert>
+
+using namespace xray::base;
+using namespace xray::rendering;
+
+//
+//  One second, in nanoseconds. A fence that takes longer than this is
+//  reported, but waited for nonetheless.
+static constexpr GLuint64 FENCE_WAIT_TIMEOUT_NS = 1000000000;
+
+static uint32_t round_up(const uint32_t value, const uint32_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+xray::rendering::uniform_ring_buffer::uniform_ring_buffer(
+    const uint32_t bytes_per_frame) noexcept {
+  GLint ubo_alignment{0};
+  gl::GetIntegerv(gl::UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubo_alignment);
+
+  alignment_ =
+      ubo_alignment > 0 ? static_cast<uint32_t>(ubo_alignment) : 256;
+  region_bytes_ = round_up(bytes_per_frame, alignment_);
+
+  const auto buffer_bytes = region_bytes_ * frames_in_flight;
+  constexpr auto kBufferFlags =
+      gl::MAP_WRITE_BIT | gl::MAP_PERSISTENT_BIT | gl::MAP_COHERENT_BIT;
+
+  gl::CreateBuffers(1, raw_handle_ptr(buffer_));
+  if (!buffer_) {
+    XR_LOG_ERR("Failed to create uniform ring buffer !");
+    return;
+  }
+
+  gl::NamedBufferStorage(raw_handle(buffer_), buffer_bytes, nullptr,
+                         kBufferFlags);
+
+  mapped_ = static_cast<uint8_t*>(gl::MapNamedBufferRange(
+      raw_handle(buffer_), 0, buffer_bytes, kBufferFlags));
+
+  if (!mapped_) {
+    XR_LOG_ERR("Failed to map uniform ring buffer ({} bytes) !",
+               buffer_bytes);
+  }
+}
+
+xray::rendering::uniform_ring_buffer::~uniform_ring_buffer() noexcept {
+  for (auto& fence : fences_) {
+    if (fence)
+      gl::DeleteSync(fence);
+  }
+
+  if (mapped_)
+    gl::UnmapNamedBuffer(raw_handle(buffer_));
+}
+
+void xray::rendering::uniform_ring_buffer::begin_frame() noexcept {
+  assert(valid());
+
+  ++frame_id_;
+  region_offset_   = 0;
+  overflow_logged_ = false;
+
+  auto& fence = fences_[region_idx_];
+  if (!fence)
+    return;
+
+  //
+  //  Flush on the first wait only, so that the fence is guaranteed to be
+  //  submitted; afterwards keep waiting without flushing again.
+  GLbitfield wait_flags = gl::SYNC_FLUSH_COMMANDS_BIT;
+
+  for (;;) {
+    const auto result =
+        gl::ClientWaitSync(fence, wait_flags, FENCE_WAIT_TIMEOUT_NS);
+
+    if (result == gl::ALREADY_SIGNALED || result == gl::CONDITION_SATISFIED)
+      break;
+
+    if (result == gl::WAIT_FAILED_) {
+      XR_LOG_ERR("Waiting on uniform ring buffer fence failed !");
+      break;
+    }
+
+    XR_LOG_ERR("Uniform ring buffer fence not signaled after 1 second, "
+               "waiting again");
+    wait_flags = 0;
+  }
+
+  gl::DeleteSync(fence);
+  fence = nullptr;
+}
+
+void xray::rendering::uniform_ring_buffer::end_frame() noexcept {
+  assert(valid());
+  assert(fences_[region_idx_] == nullptr);
+
+  fences_[region_idx_] = gl::FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0);
+  region_idx_          = (region_idx_ + 1) % frames_in_flight;
+}
+
+xray::rendering::uniform_ring_allocation
+xray::rendering::uniform_ring_buffer::allocate(const size_t bytes) noexcept {
+  assert(valid());
+
+  const auto offset = round_up(region_offset_, alignment_);
+  if (offset + bytes > region_bytes_) {
+    if (!overflow_logged_) {
+      XR_LOG_ERR("Uniform ring buffer region exhausted ({} bytes per frame)",
+                 region_bytes_);
+      overflow_logged_ = true;
+    }
+
+    return {};
+  }
+
+  region_offset_        = offset + static_cast<uint32_t>(bytes);
+  const auto buf_offset = region_idx_ * region_bytes_ + offset;
+
+  return {mapped_ + buf_offset, buf_offset, static_cast<uint32_t>(bytes)};
+}
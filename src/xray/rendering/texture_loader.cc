@@ -1,5 +1,6 @@
 #include "xray/rendering/texture_loader.hpp"
 #include "xray/base/logger.hpp"
+#include <algorithm>
 #include <cassert>
 #include <platformstl/filesystem/memory_mapped_file.hpp>
 
@@ -10,15 +11,25 @@ xray::rendering::texture_loader::texture_loader(
   try {
     platformstl::memory_mapped_file tex_file{file_path};
 
-    if (load_opts == texture_load_options::flip_y)
-      stbi_set_flip_vertically_on_load(true);
-
     xray::base::unique_pointer_reset(
         _texdata,
         stbi_load_from_memory(static_cast<const stbi_uc*>(tex_file.memory()),
                               static_cast<int32_t>(tex_file.size()), &_x_size,
                               &_y_size, &_levels, 0));
-  } catch (const std::exception& e) {
+  } catch (const std::exception&) {
     XR_LOG_ERR("Failed to load texture {}", file_path);
   }
+
+  //
+  //  Flipped here rather than with stbi_set_flip_vertically_on_load(), which
+  //  is global state and would race between images loaded on different
+  //  threads.
+  if (_texdata && load_opts == texture_load_options::flip_y) {
+    const auto row_bytes = static_cast<size_t>(_x_size * _levels);
+    auto       top       = xray::base::raw_ptr(_texdata);
+    auto       bottom    = top + row_bytes * static_cast<size_t>(_y_size - 1);
+
+    for (; top < bottom; top += row_bytes, bottom -= row_bytes)
+      std::swap_ranges(top, top + row_bytes, bottom);
+  }
 }
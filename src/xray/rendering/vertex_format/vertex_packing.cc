@@ -0,0 +1,233 @@
+#include "xray/rendering/vertex_format/vertex_packing.hpp"
+#include "xray/math/constants.hpp"
+#include "xray/math/scalar3_lanes.hpp"
+#include "xray/math/scalar3_math.hpp"
+#include "xray/math/scalar_lanes.hpp"
+#include "xray/rendering/vertex_format/vertex_pnt_packed.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt.hpp"
+#include "xray/rendering/vertex_format/vertex_pntt_packed.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+using namespace xray::math;
+using namespace xray::rendering;
+
+using float_lanes  = scalar_lanes<float, native_float_lanes>;
+using float3_lanes = scalar3_lanes<float, native_float_lanes>;
+
+static constexpr size_t VERTEX_STRIDE = sizeof(vertex_pntt);
+
+//
+//  Scales and rounds a packet of unit vectors to signed 10 bit integers,
+//  returned as the packed words.
+static void encode_snorm10_lanes(const vertex_pntt* src,
+                                 const float3 vertex_pntt::*member,
+                                 const size_t count, const uint32_t w,
+                                 uint32_t* packed) noexcept {
+  const auto v =
+      float3_lanes::load_partial(&(src->*member), VERTEX_STRIDE, count);
+
+  const float_lanes one{1.0f};
+  const float_lanes minus_one{-1.0f};
+  const float_lanes half{0.5f};
+  const float_lanes minus_half{-0.5f};
+  const float_lanes zero{0.0f};
+
+  const auto encode = [&](const float_lanes& c, float* out) {
+    const auto s = clamp(c, minus_one, one);
+    (s * 511.0f + select(s < zero, minus_half, half)).store(out);
+  };
+
+  alignas(32) float xs[native_float_lanes];
+  alignas(32) float ys[native_float_lanes];
+  alignas(32) float zs[native_float_lanes];
+  encode(v.x, xs);
+  encode(v.y, ys);
+  encode(v.z, zs);
+
+  for (size_t i = 0; i < count; ++i) {
+    const auto bits = [](const float f) {
+      return static_cast<uint32_t>(static_cast<int32_t>(f)) & 0x3FFu;
+    };
+
+    packed[i] =
+        bits(xs[i]) | (bits(ys[i]) << 10) | (bits(zs[i]) << 20) | (w << 30);
+  }
+}
+
+template <typename packed_vertex>
+static void encode_common_lanes(const vertex_pntt*         src,
+                                const size_t               count,
+                                const vertex_quantization& quant,
+                                packed_vertex*             dst) noexcept {
+  //
+  //  Positions : map the bounding box to [0, 65535] and round.
+  const auto p =
+      float3_lanes::load_partial(&src->position, VERTEX_STRIDE, count);
+
+  const float_lanes zero{0.0f};
+  const float_lanes one{1.0f};
+
+  const auto quantize = [&](const float_lanes& c, const float offset,
+                            const float scale, float* out) {
+    const auto t = clamp((c - offset) / scale, zero, one);
+    (t * 65535.0f + 0.5f).store(out);
+  };
+
+  alignas(32) float xs[native_float_lanes];
+  alignas(32) float ys[native_float_lanes];
+  alignas(32) float zs[native_float_lanes];
+  quantize(p.x, quant.offset.x, quant.scale.x, xs);
+  quantize(p.y, quant.offset.y, quant.scale.y, ys);
+  quantize(p.z, quant.offset.z, quant.scale.z, zs);
+
+  uint32_t normals[native_float_lanes];
+  encode_snorm10_lanes(src, &vertex_pntt::normal, count, 0, normals);
+
+  for (size_t i = 0; i < count; ++i) {
+    dst[i].position[0]  = static_cast<uint16_t>(xs[i]);
+    dst[i].position[1]  = static_cast<uint16_t>(ys[i]);
+    dst[i].position[2]  = static_cast<uint16_t>(zs[i]);
+    dst[i].position[3]  = 0;
+    dst[i].normal       = normals[i];
+    dst[i].texcoords[0] = float_to_half(src[i].texcoords.x);
+    dst[i].texcoords[1] = float_to_half(src[i].texcoords.y);
+  }
+}
+
+static void encode_lanes(const vertex_pntt* src, const size_t count,
+                         const vertex_quantization& quant,
+                         vertex_pnt_packed*         dst) noexcept {
+  encode_common_lanes(src, count, quant, dst);
+}
+
+static void encode_lanes(const vertex_pntt* src, const size_t count,
+                         const vertex_quantization& quant,
+                         vertex_pntt_packed*        dst) noexcept {
+  encode_common_lanes(src, count, quant, dst);
+
+  uint32_t tangents[native_float_lanes];
+  encode_snorm10_lanes(src, &vertex_pntt::tangent, count, 1, tangents);
+
+  for (size_t i = 0; i < count; ++i)
+    dst[i].tangent = tangents[i];
+}
+
+template <typename packed_vertex>
+static void pack_vertices_impl(gsl::span<const vertex_pntt> vertices,
+                               const vertex_quantization&   quant,
+                               packed_vertex*               packed) noexcept {
+  assert(packed != nullptr || vertices.empty());
+
+  const auto count = static_cast<size_t>(vertices.size());
+  for (size_t i = 0; i < count; i += native_float_lanes) {
+    encode_lanes(vertices.data() + i, std::min(native_float_lanes, count - i),
+                 quant, packed + i);
+  }
+}
+
+void xray::rendering::pack_vertices(gsl::span<const vertex_pntt> vertices,
+                                    const vertex_quantization&   quant,
+                                    vertex_pnt_packed*           packed) {
+  pack_vertices_impl(vertices, quant, packed);
+}
+
+void xray::rendering::pack_vertices(gsl::span<const vertex_pntt> vertices,
+                                    const vertex_quantization&   quant,
+                                    vertex_pntt_packed*          packed) {
+  pack_vertices_impl(vertices, quant, packed);
+}
+
+//
+//  Angle between two directions, in degrees. Zero length inputs (missing
+//  attributes) compare equal to anything.
+static float angle_degrees(const float3& a, const float3& b) noexcept {
+  const auto len = length(a) * length(b);
+  if (len <= 0.0f)
+    return 0.0f;
+
+  const auto c = std::min(std::max(dot(a, b) / len, -1.0f), 1.0f);
+  return std::acos(c) * one_eighty_over_pi<float>;
+}
+
+struct error_accumulator {
+  float max_val{0.0f};
+  double sum{0.0};
+
+  void add(const float e) noexcept {
+    max_val = std::max(max_val, e);
+    sum += e;
+  }
+
+  float mean(const size_t count) const noexcept {
+    return count ? static_cast<float>(sum / static_cast<double>(count))
+                 : 0.0f;
+  }
+};
+
+template <typename packed_vertex>
+static void measure_common(const vertex_pntt& src, const packed_vertex& pv,
+                           const vertex_quantization& quant,
+                           error_accumulator* pos_err,
+                           error_accumulator* normal_err,
+                           error_accumulator* texcoord_err) noexcept {
+  const float3 pos{
+      quant.offset.x + quant.scale.x * (pv.position[0] / 65535.0f),
+      quant.offset.y + quant.scale.y * (pv.position[1] / 65535.0f),
+      quant.offset.z + quant.scale.z * (pv.position[2] / 65535.0f)};
+
+  pos_err->add(distance(pos, src.position));
+  normal_err->add(angle_degrees(unpack_snorm10(pv.normal), src.normal));
+  texcoord_err->add(
+      std::max(std::abs(half_to_float(pv.texcoords[0]) - src.texcoords.x),
+               std::abs(half_to_float(pv.texcoords[1]) - src.texcoords.y)));
+}
+
+vertex_packing_error
+xray::rendering::measure_packing_error(gsl::span<const vertex_pntt> vertices,
+                                       const vertex_format          fmt,
+                                       const vertex_quantization&   quant) {
+  assert(is_packed_format(fmt));
+
+  const auto        count = static_cast<size_t>(vertices.size());
+  error_accumulator pos_err;
+  error_accumulator normal_err;
+  error_accumulator tangent_err;
+  error_accumulator texcoord_err;
+
+  if (fmt == vertex_format::pnt_packed) {
+    vector<vertex_pnt_packed> packed(count);
+    pack_vertices(vertices, quant, packed.data());
+
+    for (size_t i = 0; i < count; ++i) {
+      measure_common(vertices[static_cast<ptrdiff_t>(i)], packed[i], quant,
+                     &pos_err, &normal_err, &texcoord_err);
+    }
+  } else {
+    vector<vertex_pntt_packed> packed(count);
+    pack_vertices(vertices, quant, packed.data());
+
+    for (size_t i = 0; i < count; ++i) {
+      const auto& src = vertices[static_cast<ptrdiff_t>(i)];
+      measure_common(src, packed[i], quant, &pos_err, &normal_err,
+                     &texcoord_err);
+      tangent_err.add(
+          angle_degrees(unpack_snorm10(packed[i].tangent), src.tangent));
+    }
+  }
+
+  vertex_packing_error result;
+  result.position_max  = pos_err.max_val;
+  result.position_mean = pos_err.mean(count);
+  result.normal_max    = normal_err.max_val;
+  result.normal_mean   = normal_err.mean(count);
+  result.tangent_max   = tangent_err.max_val;
+  result.tangent_mean  = tangent_err.mean(count);
+  result.texcoord_max  = texcoord_err.max_val;
+  result.texcoord_mean = texcoord_err.mean(count);
+
+  return result;
+}
@@ -36,14 +36,22 @@ const xray::math::float4x4& xray::scene::camera::projection() const noexcept {
 
 const xray::math::float4x4& xray::scene::camera::projection_view() const
     noexcept {
+  update();
   return projection_view_;
 }
 
+const xray::math::frustum3f& xray::scene::camera::view_frustum() const
+    noexcept {
+  update();
+  return frustum_;
+}
+
 void xray::scene::camera::update() const noexcept {
   if (updated_)
     return;
 
   projection_view_ = projection_ * view_;
+  frustum_         = math::extract_frustum(projection_view_);
   updated_         = true;
 }
 